@@ -0,0 +1,718 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../common/BatchQuanc8.h"
+#include "../common/GaussKronrod.h"
+#include "../common/Quanc8.h"
+#include "../common/TanhSinh.h"
+#include "../common/VectorMath.h"
+#include "../coursework/NewtonSystem.h"
+#include "../coursework/zeroin.h"
+#include "../first_lab/Langrage.h"
+#include "../first_lab/Spline.h"
+#include "../second_lab/BandSolve.h"
+#include "../second_lab/CholeskySolve.h"
+#include "../second_lab/Decomp.h"
+#include "../second_lab/Jacobian.h"
+#include "../second_lab/Krylov.h"
+#include "../second_lab/Matrix.h"
+#include "../second_lab/Preconditioners.h"
+#include "../second_lab/RefinedSolve.h"
+#include "../second_lab/Solve.h"
+#include "../second_lab/SparseLU.h"
+#include "../second_lab/TridiagonalSolve.h"
+#include "../third_lab/Rkf45.h"
+#include "../third_lab/Rosenbrock23.h"
+
+/*
+ * Benchmarks of the numeric kernels, every case is repeated until --min-time seconds have passed.
+ * The report follows the JSON layout of Google Benchmark, so the same tools can read it.
+ *
+ *   benchmarks [--filter substring] [--max-n n] [--min-time seconds] [--out file.json]
+ */
+
+namespace {
+    struct Options {
+        std::string filter;
+        int max_n = 1024;
+        double min_time = 0.2;
+        std::string out;
+    };
+
+    struct Result {
+        std::string name;
+        long iterations;
+        double real_time;
+        std::vector<std::pair<std::string, double> > counters;
+    };
+
+    volatile double sink = 0.0;
+
+    class Runner {
+    public:
+        explicit Runner(Options options): options_(std::move(options)) {
+        }
+
+        /**
+         * \brief run body until min_time has passed, counters are per iteration and taken from the last one
+         */
+        void run(const std::string &name, const std::function<std::vector<std::pair<std::string, double> >()> &body) {
+            if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos) {
+                return;
+            }
+            using clock = std::chrono::steady_clock;
+            std::vector<std::pair<std::string, double> > counters = body();
+            long iterations = 1;
+            double elapsed = 0.0;
+            for (long batch = 1;; batch *= 2) {
+                const auto start = clock::now();
+                for (long i = 0; i < batch; i++) {
+                    counters = body();
+                }
+                elapsed = std::chrono::duration<double>(clock::now() - start).count();
+                iterations = batch;
+                if (elapsed >= options_.min_time || batch >= (1L << 30)) {
+                    break;
+                }
+            }
+            const double per_iteration = elapsed / static_cast<double>(iterations);
+            for (auto &counter: counters) {
+                /* counters ending in "_per_second" are given per iteration and turned into rates */
+                const std::string suffix = "_per_second";
+                if (counter.first.size() > suffix.size() &&
+                    counter.first.compare(counter.first.size() - suffix.size(), suffix.size(), suffix) == 0) {
+                    counter.second /= per_iteration;
+                }
+            }
+            results_.push_back({name, iterations, per_iteration * 1.0e9, counters});
+            std::cout << name << "\t" << per_iteration * 1.0e9 << " ns";
+            for (const auto &counter: counters) {
+                std::cout << "\t" << counter.first << "=" << counter.second;
+            }
+            std::cout << std::endl;
+        }
+
+        [[nodiscard]] int max_n() const { return options_.max_n; }
+
+        void write() const {
+            if (options_.out.empty()) {
+                return;
+            }
+            std::ofstream file(options_.out);
+            file.precision(10);
+            file << "{\n  \"context\": {\n";
+            file << "    \"executable\": \"benchmarks\",\n";
+            file << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+            file << "    \"min_time\": " << options_.min_time << "\n";
+            file << "  },\n  \"benchmarks\": [\n";
+            for (std::size_t i = 0; i < results_.size(); i++) {
+                const Result &r = results_[i];
+                file << "    {\n";
+                file << "      \"name\": \"" << r.name << "\",\n";
+                file << "      \"run_type\": \"iteration\",\n";
+                file << "      \"iterations\": " << r.iterations << ",\n";
+                file << "      \"real_time\": " << r.real_time << ",\n";
+                file << "      \"time_unit\": \"ns\"";
+                for (const auto &counter: r.counters) {
+                    file << ",\n      \"" << counter.first << "\": " << counter.second;
+                }
+                file << "\n    }" << (i + 1 < results_.size() ? "," : "") << "\n";
+            }
+            file << "  ]\n}\n";
+        }
+
+    private:
+        Options options_;
+        std::vector<Result> results_;
+    };
+
+    dimkashelk::Matrix random_matrix(const int rows, const int cols, const unsigned seed) {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+        dimkashelk::Matrix matrix(rows, cols);
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                matrix(i, j) = distribution(generator);
+            }
+        }
+        return matrix;
+    }
+
+    void decomp_benchmarks(Runner &runner) {
+        for (int n = 8; n <= std::min(runner.max_n(), 8192); n *= 2) {
+            const dimkashelk::Matrix matrix = random_matrix(n, n, n);
+            dimkashelk::Decomp decomp;
+            runner.run("Decomp/" + std::to_string(n), [&]() {
+                decomp(matrix);
+                sink = decomp.get_cond();
+                const double flops = 2.0 / 3.0 * n * static_cast<double>(n) * n;
+                return std::vector<std::pair<std::string, double> >{{"flops_per_second", flops}};
+            });
+        }
+    }
+
+    void solve_benchmarks(Runner &runner) {
+        const int n = std::min(runner.max_n(), 256);
+        const dimkashelk::Matrix matrix = random_matrix(n, n, 1);
+        dimkashelk::Decomp decomp;
+        decomp(matrix);
+        dimkashelk::Solve solve;
+        for (int count = 1; count <= 64; count *= 4) {
+            const dimkashelk::Matrix right = random_matrix(n, count, 2);
+            runner.run("Solve/" + std::to_string(n) + "/rhs:" + std::to_string(count), [&]() {
+                solve(decomp, right);
+                sink = solve.get_result_view()(0, 0);
+                return std::vector<std::pair<std::string, double> >{{"rhs_per_second", static_cast<double>(count)}};
+            });
+        }
+    }
+
+    void refined_solve_benchmarks(Runner &runner) {
+        for (int n = 64; n <= std::min(runner.max_n(), 8192); n *= 2) {
+            /* diagonally dominant, so the float factorization is accepted */
+            dimkashelk::Matrix matrix = random_matrix(n, n, n);
+            for (int i = 0; i < n; i++) {
+                matrix(i, i) += n;
+            }
+            const dimkashelk::Matrix right = random_matrix(n, 1, 3);
+            /* the rows of a Matrix are padded, the column is copied element by element */
+            std::vector<double> rhs(n);
+            for (int i = 0; i < n; i++) {
+                rhs[i] = right(i, 0);
+            }
+            dimkashelk::Decomp decomp;
+            dimkashelk::Solve solve;
+            runner.run("DecompSolve/" + std::to_string(n), [&]() {
+                decomp(matrix);
+                solve(decomp, rhs);
+                sink = solve.get_result_view()(0, 0);
+                return std::vector<std::pair<std::string, double> >{};
+            });
+            dimkashelk::RefinedSolve refined;
+            runner.run("RefinedSolve/" + std::to_string(n), [&]() {
+                refined(matrix, rhs);
+                sink = refined.get_result()[0];
+                return std::vector<std::pair<std::string, double> >{
+                    {"iterations", static_cast<double>(refined.get_iterations())}
+                };
+            });
+        }
+    }
+
+    void band_benchmarks(Runner &runner) {
+        const int last = static_cast<int>(std::min(1000L * runner.max_n(), 1000000L));
+        for (int n = 1000; n <= last; n *= 10) {
+            std::vector<double> lower(n - 1, -1.0), diag(n, 4.0), upper(n - 1, -1.0), rhs(n, 1.0);
+            dimkashelk::TridiagonalSolve tridiagonal;
+            runner.run("TridiagonalSolve/" + std::to_string(n), [&]() {
+                tridiagonal(lower, diag, upper, rhs);
+                sink = tridiagonal.get_result()[0];
+                return std::vector<std::pair<std::string, double> >{{"rows_per_second", static_cast<double>(n)}};
+            });
+            for (int width = 2; width <= 8; width *= 4) {
+                dimkashelk::BandMatrix matrix(n, width, width);
+                for (int i = 0; i < n; i++) {
+                    for (int j = std::max(0, i - width); j <= std::min(n - 1, i + width); j++) {
+                        matrix(i, j) = i == j ? 2.0 * width + 1.0 : -1.0;
+                    }
+                }
+                dimkashelk::BandSolve band;
+                runner.run("BandSolve/" + std::to_string(n) + "/band:" + std::to_string(width), [&]() {
+                    band(matrix, rhs);
+                    sink = band.get_result()[0];
+                    return std::vector<std::pair<std::string, double> >{{"rows_per_second", static_cast<double>(n)}};
+                });
+                dimkashelk::CholeskySolve cholesky;
+                runner.run("CholeskySolve/" + std::to_string(n) + "/band:" + std::to_string(width), [&]() {
+                    cholesky(matrix, rhs);
+                    sink = cholesky.get_result()[0];
+                    return std::vector<std::pair<std::string, double> >{{"rows_per_second", static_cast<double>(n)}};
+                });
+            }
+        }
+    }
+
+    void sparse_benchmarks(Runner &runner) {
+        for (int m = 32; m <= std::min(runner.max_n() / 4, 512); m *= 2) {
+            /* five point convection-diffusion stencil on an m x m grid */
+            const int n = m * m;
+            std::vector<int> rows, columns;
+            std::vector<double> values;
+            for (int i = 0; i < m; i++) {
+                for (int j = 0; j < m; j++) {
+                    const int k = i * m + j;
+                    const int neighbours[4] = {i > 0 ? k - m : -1, i < m - 1 ? k + m : -1, j > 0 ? k - 1 : -1,
+                                               j < m - 1 ? k + 1 : -1};
+                    const double weights[4] = {-1.0, -1.0, -1.2, -0.8};
+                    rows.push_back(k);
+                    columns.push_back(k);
+                    values.push_back(4.01);
+                    for (int e = 0; e < 4; e++) {
+                        if (neighbours[e] < 0) continue;
+                        rows.push_back(k);
+                        columns.push_back(neighbours[e]);
+                        values.push_back(weights[e]);
+                    }
+                }
+            }
+            const dimkashelk::SparseMatrix matrix = dimkashelk::SparseMatrix::from_triplets(n, rows, columns, values);
+            const std::vector<double> rhs(n, 1.0);
+            dimkashelk::SparseLU lu;
+            lu.analyze(matrix);
+            runner.run("SparseLU/factorize/" + std::to_string(n), [&]() {
+                lu.factorize(matrix);
+                sink = lu.get_cond();
+                return std::vector<std::pair<std::string, double> >{
+                    {"factor_nonzeros", static_cast<double>(lu.get_factor_nonzeros())}
+                };
+            });
+            runner.run("SparseLU/refactorize/" + std::to_string(n), [&]() {
+                lu.refactorize(matrix);
+                sink = lu.get_cond();
+                return std::vector<std::pair<std::string, double> >{};
+            });
+            runner.run("SparseLU/solve/" + std::to_string(n), [&]() {
+                lu(rhs);
+                sink = lu.get_result()[0];
+                return std::vector<std::pair<std::string, double> >{};
+            });
+            const dimkashelk::LinearOperator a = dimkashelk::make_operator(matrix);
+            const dimkashelk::Ilu0Preconditioner ilu(matrix);
+            const std::pair<std::string, dimkashelk::KrylovSolve::Method> methods[] = {
+                {"GMRES", dimkashelk::KrylovSolve::Method::GMRES},
+                {"BiCGStab", dimkashelk::KrylovSolve::Method::BICGSTAB}
+            };
+            for (const auto &method: methods) {
+                for (const bool preconditioned: {false, true}) {
+                    dimkashelk::KrylovSolve krylov(method.second, 1.0e-8, 10 * n);
+                    const dimkashelk::Preconditioner m = preconditioned ? dimkashelk::Preconditioner(ilu)
+                                                                        : dimkashelk::Preconditioner();
+                    runner.run("Krylov/" + method.first + (preconditioned ? "+ILU0/" : "/") + std::to_string(n), [&]() {
+                        krylov(a, rhs, m);
+                        sink = krylov.get_result()[0];
+                        return std::vector<std::pair<std::string, double> >{
+                            {"iterations", static_cast<double>(krylov.get_iterations())},
+                            {"matvecs", static_cast<double>(krylov.get_matvecs())}
+                        };
+                    });
+                }
+            }
+        }
+    }
+
+    void interpolation_benchmarks(Runner &runner) {
+        const int knots = 1001;
+        std::vector<std::pair<double, double> > uniform;
+        std::vector<std::pair<double, double> > varying;
+        double x = 0.0;
+        for (int i = 0; i < knots; i++) {
+            uniform.emplace_back(0.001 * i, 1.0 / (1.0 + 0.001 * i));
+            varying.emplace_back(x, 1.0 / (1.0 + x));
+            x += 0.001 * (1.0 + 0.5 * std::sin(i));
+        }
+        const int queries = 100000;
+        std::vector<double> grid(queries);
+        std::vector<double> out(queries);
+        for (const auto &[name, points]: {std::make_pair("uniform", &uniform), std::make_pair("varying", &varying)}) {
+            const dimkashelk::Spline spline(*points);
+            const double length = points->back().first;
+            for (int i = 0; i < queries; i++) {
+                grid[i] = length * i / queries;
+            }
+            runner.run(std::string("Spline/") + name + "/single", [&]() {
+                double sum = 0.0;
+                for (const double q: grid) {
+                    sum += spline(q);
+                }
+                sink = sum;
+                return std::vector<std::pair<std::string, double> >{{"lookups_per_second", queries}};
+            });
+            runner.run(std::string("Spline/") + name + "/batch", [&]() {
+                spline.evaluate(grid.data(), grid.size(), out.data());
+                sink = out[0];
+                return std::vector<std::pair<std::string, double> >{{"lookups_per_second", queries}};
+            });
+        }
+        for (const int nodes: {11, 50, 200}) {
+            std::vector<std::pair<double, double> > points;
+            for (int i = 0; i < nodes; i++) {
+                const double t = std::cos(M_PI * (i + 0.5) / nodes);
+                points.emplace_back(t, 1.0 / (1.0 + 25.0 * t * t));
+            }
+            const dimkashelk::Langrage langrage(points);
+            std::vector<double> q(1000);
+            std::vector<double> r(q.size());
+            for (std::size_t i = 0; i < q.size(); i++) {
+                q[i] = -1.0 + 2.0 * i / q.size();
+            }
+            runner.run("Langrage/" + std::to_string(nodes) + "/batch", [&]() {
+                langrage.evaluate(q.data(), q.size(), r.data());
+                sink = r[0];
+                return std::vector<std::pair<std::string, double> >{
+                    {"lookups_per_second", static_cast<double>(q.size())}
+                };
+            });
+        }
+    }
+
+    void quanc8_benchmarks(Runner &runner) {
+        const std::vector<std::pair<std::string, std::function<double(double)> > > integrands = {
+            {"smooth", [](const double x) { return std::exp(-x * x); }},
+            {"oscillatory", [](const double x) { return std::sin(50.0 * x); }},
+            {"peak", [](const double x) { return 1.0 / (1.0e-4 + (x - 0.5) * (x - 0.5)); }},
+            {"singular", [](const double x) { return x > 0.0 ? 1.0 / std::sqrt(x) : 0.0; }},
+            {"log", [](const double x) { return std::log(x); }},
+            /* integrand of the coursework close to the root, nearly singular at 1 */
+            {"coursework", [](const double y) { return 1.0 / std::sqrt(2.0 * (2.0 / 3.0 + 1.0e-6 + y * y * y / 3.0 - y)); }}
+        };
+        for (const auto &[name, fun]: integrands) {
+            runner.run("Quanc8/" + name, [&]() {
+                const dimkashelk::Quanc8 quanc8(fun, 0.0, 1.0, 1.0e-10, 1.0e-10);
+                sink = quanc8.getResult();
+                return std::vector<std::pair<std::string, double> >{
+                    {"no_fun", quanc8.getNoFun()}, {"flag", quanc8.getFlag()}
+                };
+            });
+            runner.run("GaussKronrod/" + name, [&]() {
+                const dimkashelk::GaussKronrod kronrod(fun, 0.0, 1.0, 1.0e-10, 1.0e-10);
+                sink = kronrod.getResult();
+                return std::vector<std::pair<std::string, double> >{
+                    {"no_fun", kronrod.getNoFun()}, {"flag", kronrod.getFlag()}
+                };
+            });
+            runner.run("TanhSinh/" + name, [&]() {
+                const dimkashelk::TanhSinh tanh_sinh(fun, 0.0, 1.0, 1.0e-10, 1.0e-10);
+                sink = tanh_sinh.getResult();
+                return std::vector<std::pair<std::string, double> >{
+                    {"no_fun", tanh_sinh.getNoFun()}, {"flag", tanh_sinh.getFlag()}
+                };
+            });
+        }
+        const double infinity = std::numeric_limits<double>::infinity();
+        runner.run("GaussKronrod/semi_infinite", [&]() {
+            const dimkashelk::GaussKronrod kronrod([](const double x) { return 1.0 / (1.0 + x * x); }, 1.0, infinity,
+                                                   1.0e-10, 1.0e-10);
+            sink = kronrod.getResult();
+            return std::vector<std::pair<std::string, double> >{
+                {"no_fun", kronrod.getNoFun()}, {"flag", kronrod.getFlag()}
+            };
+        });
+        runner.run("TanhSinh/semi_infinite", [&]() {
+            const dimkashelk::TanhSinh tanh_sinh([](const double x) { return 1.0 / (1.0 + x * x); }, 1.0, infinity,
+                                                 1.0e-10, 1.0e-10);
+            sink = tanh_sinh.getResult();
+            return std::vector<std::pair<std::string, double> >{
+                {"no_fun", tanh_sinh.getNoFun()}, {"flag", tanh_sinh.getFlag()}
+            };
+        });
+    }
+
+    void vector_math_benchmarks(Runner &runner) {
+        using Batch = void (*)(const double[], std::size_t, double[]);
+        const int count = 4096;
+        std::mt19937_64 generator(7);
+        std::uniform_real_distribution<double> distribution(-10.0, 10.0);
+        std::vector<double> x(count);
+        std::vector<double> positive(count);
+        std::vector<double> y(count);
+        for (int i = 0; i < count; i++) {
+            x[i] = distribution(generator);
+            positive[i] = std::exp(distribution(generator));
+        }
+        const std::vector<std::tuple<std::string, double (*)(double), Batch, const std::vector<double> *> > functions = {
+            {"exp", [](const double v) { return std::exp(v); }, dimkashelk::vector_exp, &x},
+            {"log", [](const double v) { return std::log(v); }, dimkashelk::vector_log, &positive},
+            {"sin", [](const double v) { return std::sin(v); }, dimkashelk::vector_sin, &x},
+            {"cos", [](const double v) { return std::cos(v); }, dimkashelk::vector_cos, &x},
+            {"tan", [](const double v) { return std::tan(v); }, dimkashelk::vector_tan, &x},
+            {"rsqrt", [](const double v) { return 1.0 / std::sqrt(v); }, dimkashelk::vector_rsqrt, &positive}
+        };
+        for (const auto &[name, scalar, batch, arguments]: functions) {
+            runner.run("VectorMath/" + name + "/scalar", [&]() {
+                for (int i = 0; i < count; i++) {
+                    y[i] = scalar((*arguments)[i]);
+                }
+                sink = y[0];
+                return std::vector<std::pair<std::string, double> >{{"values_per_second", count}};
+            });
+            runner.run("VectorMath/" + name + "/vector", [&]() {
+                batch(arguments->data(), count, y.data());
+                sink = y[0];
+                return std::vector<std::pair<std::string, double> >{{"values_per_second", count}};
+            });
+        }
+        runner.run("VectorMath/pow/scalar", [&]() {
+            for (int i = 0; i < count; i++) {
+                y[i] = std::pow(positive[i], 1.5);
+            }
+            sink = y[0];
+            return std::vector<std::pair<std::string, double> >{{"values_per_second", count}};
+        });
+        runner.run("VectorMath/pow/vector", [&]() {
+            dimkashelk::vector_pow(positive.data(), 1.5, count, y.data());
+            sink = y[0];
+            return std::vector<std::pair<std::string, double> >{{"values_per_second", count}};
+        });
+
+        /* the batch integrand of Quanc8 gets 8 or 9 abscissae per call */
+        runner.run("BatchQuanc8/oscillatory/scalar", [&]() {
+            const dimkashelk::BatchQuanc8 quanc8([](const double t[], double f[], const int n) {
+                for (int i = 0; i < n; i++) {
+                    f[i] = std::sin(50.0 * t[i]);
+                }
+            }, 0.0, 1.0, 1.0e-10, 1.0e-10);
+            sink = quanc8.getResult();
+            return std::vector<std::pair<std::string, double> >{{"no_fun", quanc8.getNoFun()}};
+        });
+        runner.run("BatchQuanc8/oscillatory/vector", [&]() {
+            const dimkashelk::BatchQuanc8 quanc8([](const double t[], double f[], const int n) {
+                for (int i = 0; i < n; i++) {
+                    f[i] = 50.0 * t[i];
+                }
+                dimkashelk::vector_sin(f, n, f);
+            }, 0.0, 1.0, 1.0e-10, 1.0e-10);
+            sink = quanc8.getResult();
+            return std::vector<std::pair<std::string, double> >{{"no_fun", quanc8.getNoFun()}};
+        });
+    }
+
+    int lab_equations(int, const double t, double y[], double yp[]) {
+        yp[0] = -71.0 * y[0] - 70.0 * y[1] + std::exp(1.0 - t * t);
+        yp[1] = y[0] + std::sin(1.0 - t);
+        return 0;
+    }
+
+    int oscillator(int, double, double y[], double yp[]) {
+        yp[0] = y[1];
+        yp[1] = -y[0];
+        return 0;
+    }
+
+    void rkf45_benchmarks(Runner &runner) {
+        const std::vector<std::pair<std::string, dimkashelk::Rkf45::Function> > problems = {
+            {"third_lab", lab_equations}, {"oscillator", oscillator}
+        };
+        for (const auto &[name, fun]: problems) {
+            dimkashelk::Rkf45 rkf(2);
+            runner.run("Rkf45/" + name, [&]() {
+                double y[2] = {0.0, 1.0};
+                double t = 0.0;
+                rkf.start(1.0e-8, 1.0e-8, 1000000);
+                rkf(fun, y, t, 4.0);
+                sink = y[0];
+                /* every step costs six evaluations */
+                const double steps = rkf.getNfe() / 6.0;
+                return std::vector<std::pair<std::string, double> >{
+                    {"nfe", rkf.getNfe()}, {"steps_per_second", steps}
+                };
+            });
+        }
+    }
+
+    /* Brusselator on m points of [0, 1], u and v interleaved, the Jacobian is banded with 5 diagonals */
+    struct Brusselator {
+        template<class T>
+        int operator()(const int n, T, T y[], T yp[]) const {
+            const int m = n / 2;
+            const double alpha = 0.02 * (m + 1) * (m + 1);
+            for (int i = 0; i < m; i++) {
+                const T u = y[2 * i];
+                const T v = y[2 * i + 1];
+                const T ul = i > 0 ? y[2 * i - 2] : T(1.0);
+                const T ur = i < m - 1 ? y[2 * i + 2] : T(1.0);
+                const T vl = i > 0 ? y[2 * i - 1] : T(3.0);
+                const T vr = i < m - 1 ? y[2 * i + 3] : T(3.0);
+                yp[2 * i] = 1.0 + u * u * v - 4.0 * u + alpha * (ul - 2.0 * u + ur);
+                yp[2 * i + 1] = 3.0 * u - u * u * v + alpha * (vl - 2.0 * v + vr);
+            }
+            return 0;
+        }
+    };
+
+    int brusselator(const int n, const double t, double y[], double yp[]) {
+        return Brusselator{}(n, t, y, yp);
+    }
+
+    void jacobian_benchmarks(Runner &runner) {
+        for (const int n: {100, 1000}) {
+            if (n > runner.max_n()) continue;
+            std::vector<double> y(n);
+            std::vector<double> yp(n);
+            std::vector<double> dfdt(n);
+            for (int i = 0; i < n / 2; i++) {
+                y[2 * i] = 1.0 + std::sin(2.0 * M_PI * (i + 1) / (n / 2 + 1));
+                y[2 * i + 1] = 3.0;
+            }
+            brusselator(n, 0.0, y.data(), yp.data());
+            std::vector<int> rows;
+            std::vector<int> columns;
+            for (int i = 0; i < n; i++) {
+                for (int j = std::max(0, i - 2); j <= std::min(n - 1, i + 2); j++) {
+                    rows.push_back(i);
+                    columns.push_back(j);
+                }
+            }
+            const dimkashelk::SparseMatrix pattern = dimkashelk::SparseMatrix::from_triplets(
+                n, rows, columns, std::vector<double>(rows.size(), 1.0));
+            const dimkashelk::JacobianColoring coloring(pattern);
+            dimkashelk::Matrix jacobian(n, n);
+            dimkashelk::ColoredJacobian<decltype(&brusselator)> dense_differences(brusselator, n);
+            dimkashelk::ColoredJacobian<decltype(&brusselator)> colored_differences(brusselator, coloring);
+            dimkashelk::AutoJacobian<Brusselator> dense_dual(Brusselator{}, n);
+            dimkashelk::AutoJacobian<Brusselator> colored_dual(Brusselator{}, coloring);
+            const std::string size = "/" + std::to_string(n);
+            runner.run("Jacobian/differences" + size, [&]() {
+                const int calls = dense_differences(0.0, y.data(), yp.data(), jacobian, dfdt.data());
+                sink = jacobian(0, 0);
+                return std::vector<std::pair<std::string, double> >{{"calls", calls}};
+            });
+            runner.run("Jacobian/colored_differences" + size, [&]() {
+                const int calls = colored_differences(0.0, y.data(), yp.data(), jacobian, dfdt.data());
+                sink = jacobian(0, 0);
+                return std::vector<std::pair<std::string, double> >{{"calls", calls}, {"colors", coloring.get_colors()}};
+            });
+            runner.run("Jacobian/dual" + size, [&]() {
+                const int calls = dense_dual(0.0, y.data(), yp.data(), jacobian, dfdt.data());
+                sink = jacobian(0, 0);
+                return std::vector<std::pair<std::string, double> >{{"calls", calls}};
+            });
+            runner.run("Jacobian/colored_dual" + size, [&]() {
+                const int calls = colored_dual(0.0, y.data(), yp.data(), jacobian, dfdt.data());
+                sink = jacobian(0, 0);
+                return std::vector<std::pair<std::string, double> >{{"calls", calls}};
+            });
+            /* the steps of Rosenbrock23 factorize dense matrices, beyond 100 they dominate */
+            if (n > 100) continue;
+            dimkashelk::Rosenbrock23 solver(n);
+            for (const bool dual: {false, true}) {
+                runner.run(std::string("Rosenbrock23/brusselator/") + (dual ? "colored_dual" : "differences") + size,
+                           [&]() {
+                               solver.start(1.0e-6, 1.0e-6);
+                               if (dual) {
+                                   solver.set_jacobian(std::ref(colored_dual));
+                               } else {
+                                   solver.set_jacobian(nullptr);
+                               }
+                               std::vector<double> z = y;
+                               double t = 0.0;
+                               solver(brusselator, z.data(), t, 1.0);
+                               sink = z[0];
+                               return std::vector<std::pair<std::string, double> >{
+                                   {"nfe", solver.getNfe()}, {"jacobians", solver.getJacobians()}
+                               };
+                           });
+            }
+        }
+    }
+
+    /* u'' = sin(v) + u / 2, v'' = 1 - u v / 2 with u(0) = v(0) = 0, u(2) = 1, v(2) = -0.5 */
+    int coupled_shooting(int, double, double y[], double yp[]) {
+        yp[0] = y[1];
+        yp[1] = std::sin(y[2]) + 0.5 * y[0];
+        yp[2] = y[3];
+        yp[3] = 1.0 - 0.5 * y[0] * y[2];
+        return 0;
+    }
+
+    void zeroin_benchmarks(Runner &runner) {
+        runner.run("zeroin/cubic", [&]() {
+            int flag = 0;
+            int evaluations = 0;
+            sink = zeroin(0.0, 3.0, [&](const double x) {
+                evaluations++;
+                return x * x * x - 2.0 * x - 5.0;
+            }, 1.0e-12, &flag);
+            return std::vector<std::pair<std::string, double> >{{"no_fun", evaluations}};
+        });
+
+        /* shooting for u'(0) and v'(0) of a coupled boundary value problem, nested zeroin against Newton */
+        dimkashelk::Rkf45 rkf(4);
+        int shots = 0;
+        auto shoot = [&](const double p, const double q, double residual[]) {
+            double y[4] = {0.0, p, 0.0, q};
+            double t = 0.0;
+            rkf.start(1.0e-10, 1.0e-10, 1000000);
+            rkf(coupled_shooting, y, t, 2.0);
+            residual[0] = y[0] - 1.0;
+            residual[1] = y[2] + 0.5;
+            shots++;
+        };
+        runner.run("zeroin/nested_shooting", [&]() {
+            shots = 0;
+            int flag = 0;
+            double residual[2];
+            auto inner = [&](const double p) {
+                return zeroin(-10.0, 10.0, [&](const double q) {
+                    shoot(p, q, residual);
+                    return residual[1];
+                }, 1.0e-10, &flag);
+            };
+            sink = zeroin(-10.0, 10.0, [&](const double p) {
+                shoot(p, inner(p), residual);
+                return residual[0];
+            }, 1.0e-10, &flag);
+            return std::vector<std::pair<std::string, double> >{{"shots", shots}};
+        });
+        auto system = [&](int, const double x[], double residual[]) { shoot(x[0], x[1], residual); };
+        dimkashelk::NewtonSystem<decltype(system)> newton(system, 2, 1.0e-9, 1.0e-12);
+        runner.run("NewtonSystem/shooting", [&]() {
+            shots = 0;
+            double x[2] = {0.0, 0.0};
+            newton(x);
+            sink = x[0];
+            return std::vector<std::pair<std::string, double> >{
+                {"shots", shots}, {"iterations", newton.getIterations()}, {"jacobians", newton.getJacobians()}
+            };
+        });
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Check arguments\n";
+            return 1;
+        }
+        if (arg == "--filter") {
+            options.filter = argv[++i];
+        } else if (arg == "--max-n") {
+            options.max_n = std::atoi(argv[++i]);
+        } else if (arg == "--min-time") {
+            options.min_time = std::atof(argv[++i]);
+        } else if (arg == "--out") {
+            options.out = argv[++i];
+        } else {
+            std::cerr << "Check arguments\n";
+            return 1;
+        }
+    }
+    Runner runner(options);
+    decomp_benchmarks(runner);
+    solve_benchmarks(runner);
+    refined_solve_benchmarks(runner);
+    band_benchmarks(runner);
+    sparse_benchmarks(runner);
+    interpolation_benchmarks(runner);
+    quanc8_benchmarks(runner);
+    vector_math_benchmarks(runner);
+    rkf45_benchmarks(runner);
+    jacobian_benchmarks(runner);
+    zeroin_benchmarks(runner);
+    runner.write();
+    return 0;
+}
@@ -0,0 +1,235 @@
+#ifndef BATCH_QUANC8_H
+#define BATCH_QUANC8_H
+#include <cmath>
+#include <memory>
+#include <utility>
+
+#include "Statistics.h"
+
+namespace dimkashelk {
+    namespace details {
+        /**
+         * \brief adaptive Newton-Cotes 8-panel integration of Quanc8,
+         * the integrand gets all new abscissae of a step in one call
+         * \param fun batch integrand, fun(const double x[], double f[], int count) sets f[i] = f(x[i]),
+         * count is 9 for the first call and 8 afterwards
+         * \param a lower bound of integration
+         * \param b upper bound of integration
+         * \param abs_err absolute error
+         * \param rel_err intermediate error
+         * \param result approximation of the integral
+         * \param error estimate of the absolute error
+         * \param no_fun number of integrand evaluations
+         * \param flag 0 for a reliable result, see Quanc8
+         */
+        template<class Integrand>
+        void quanc8(Integrand &&fun, const double a, const double b, const double abs_err, const double rel_err,
+                    double *result, double *error, int *no_fun, double *flag) {
+            double QRIGHT[32], F[17], X[17], FSAVE[9][31], XSAVE[9][31];
+            double XNEW[9], FNEW[9];
+            NUMERICS_TIMER(INTEGRATE);
+            int LEVMIN, LEVMAX, LEVOUT, NOMAX, NOFIN, LEV, NIM, J, I;
+            double W0, W1, W2, W3, W4, COR11, AREA, X0, F0, STONE, STEP;
+            double QLEFT, QNOW, QDIFF, QPREV, TOLERR, ESTERR;
+
+            LEVMIN = 1;
+            LEVMAX = 30;
+            LEVOUT = 6;
+            NOMAX = 5000;
+            NOFIN = NOMAX - (8 * (LEVMAX - LEVOUT + static_cast<int>(std::pow(2, LEVOUT + 1))));
+
+            W0 = 3956.0 / 14175.0;
+            W1 = 23552.0 / 14175.0;
+            W2 = -3712.0 / 14175.0;
+            W3 = 41984.0 / 14175.0;
+            W4 = -18160.0 / 14175.0;
+
+            *flag = 0.0;
+            *result = 0.0;
+            COR11 = 0.0;
+            *error = 0.0;
+            AREA = 0.0;
+            *no_fun = 0;
+            if (a == b) { return; }
+            LEV = 0;
+            NIM = 1;
+            X0 = a;
+            X[16] = b;
+            QPREV = 0.0;
+            STONE = (b - a) / 16.0;
+            X[8] = (X0 + X[16]) / 2.0;
+            X[4] = (X0 + X[8]) / 2.0;
+            X[12] = (X[8] + X[16]) / 2.0;
+            X[2] = (X0 + X[4]) / 2.0;
+            X[6] = (X[4] + X[8]) / 2.0;
+            X[10] = (X[8] + X[12]) / 2.0;
+            X[14] = (X[12] + X[16]) / 2.0;
+            XNEW[0] = X0;
+            for (J = 2; J <= 16; J = J + 2) {
+                XNEW[J / 2] = X[J];
+            }
+            fun(static_cast<const double *>(XNEW), static_cast<double *>(FNEW), 9);
+            F0 = FNEW[0];
+            for (J = 2; J <= 16; J = J + 2) {
+                F[J] = FNEW[J / 2];
+            }
+            *no_fun = 9;
+            NUMERICS_COUNT(INTEGRAND_CALLS, 9);
+
+        trenta:
+            X[1] = (X0 + X[2]) / 2.0;
+            for (J = 3; J <= 15; J = J + 2) {
+                X[J] = (X[J - 1] + X[J + 1]) / 2.0;
+            }
+            for (J = 1; J <= 15; J = J + 2) {
+                XNEW[J / 2] = X[J];
+            }
+            fun(static_cast<const double *>(XNEW), static_cast<double *>(FNEW), 8);
+            for (J = 1; J <= 15; J = J + 2) {
+                F[J] = FNEW[J / 2];
+            }
+            *no_fun = *no_fun + 8;
+            NUMERICS_COUNT(INTEGRAND_CALLS, 8);
+            STEP = (X[16] - X0) / 16.0;
+            QLEFT = (W0 * (F0 + F[8]) + W1 * (F[1] + F[7]) + W2 * (F[2] + F[6]) + W3 * (F[3] + F[5])
+                     + W4 * F[4]) * STEP;
+            QRIGHT[LEV + 1] = (W0 * (F[8] + F[16]) + W1 * (F[9] + F[15]) + W2 * (F[10] + F[14])
+                               + W3 * (F[11] + F[13]) + W4 * F[12]) * STEP;
+            QNOW = QLEFT + QRIGHT[LEV + 1];
+            QDIFF = QNOW - QPREV;
+            AREA = AREA + QDIFF;
+
+            ESTERR = std::fabs(QDIFF) / 1023.0;
+            if (abs_err > (rel_err * std::fabs(AREA)) * (STEP / STONE))
+                TOLERR = abs_err;
+            else
+                TOLERR = (rel_err * std::fabs(AREA)) * (STEP / STONE);
+            if (LEV < LEVMIN)
+                goto cinquanta;
+            if (LEV >= LEVMAX)
+                goto sessantadue;
+            if (*no_fun > NOFIN)
+                goto sessanta;
+            if (ESTERR <= TOLERR)
+                goto settanta;
+
+        cinquanta:
+            NIM = 2 * NIM;
+            LEV = LEV + 1;
+
+            for (I = 1; I <= 8; I++) {
+                FSAVE[I][LEV] = F[I + 8];
+                XSAVE[I][LEV] = X[I + 8];
+            }
+
+            QPREV = QLEFT;
+            for (I = 1; I <= 8; I++) {
+                J = -I;
+                F[2 * J + 18] = F[J + 9];
+                X[2 * J + 18] = X[J + 9];
+            }
+            goto trenta;
+
+        sessanta:
+            NOFIN = 2 * NOFIN;
+            LEVMAX = LEVOUT;
+            *flag = *flag + ((b - X0) / (b - a));
+            goto settanta;
+
+        sessantadue:
+            *flag = *flag + 1.0;
+
+        settanta:
+            NUMERICS_HISTOGRAM(REFINEMENT_DEPTH, LEV);
+            *result = *result + QNOW;
+            *error = *error + ESTERR;
+            COR11 = COR11 + QDIFF / 1023.0;
+
+            while (NIM % 2 != 0) {
+                NIM = NIM / 2;
+                LEV = LEV - 1;
+            }
+            NIM = NIM + 1;
+            if (LEV <= 0)
+                goto ottanta;
+
+            QPREV = QRIGHT[LEV];
+            X0 = X[16];
+            F0 = F[16];
+            for (I = 1; I <= 8; I++) {
+                F[2 * I] = FSAVE[I][LEV];
+                X[2 * I] = XSAVE[I][LEV];
+            }
+            goto trenta;
+
+        ottanta:
+            *result = *result + COR11;
+            if (*error == 0.0)
+                return;
+            while (std::fabs(*result) + (*error) == std::fabs(*result))
+                *error = 2.0 * (*error);
+        }
+    }
+
+    /**
+     * \brief batch form of a scalar integrand, f(x) is inlined instead of called through std::function
+     */
+    template<class F>
+    class PointwiseIntegrand {
+    public:
+        explicit PointwiseIntegrand(F fun): fun_(std::move(fun)) {
+        }
+
+        void operator()(const double x[], double f[], const int count) const {
+            for (int i = 0; i < count; i++) {
+                f[i] = fun_(x[i]);
+            }
+        }
+
+    private:
+        F fun_;
+    };
+
+    template<class F>
+    PointwiseIntegrand<F> make_pointwise(F fun) {
+        return PointwiseIntegrand<F>(std::move(fun));
+    }
+
+    /**
+     * \brief Quanc8 with a batch integrand of any callable type,
+     * fun(const double x[], double f[], int count) evaluates all new abscissae of a step,
+     * so the integrand can be vectorized over them. Results are the same as of Quanc8.
+     */
+    template<class F>
+    class BatchQuanc8 {
+    public:
+        /**
+         * \brief
+         * \param fun batch integrand, see details::quanc8
+         * \param a lower bound of integration
+         * \param b upper bound of integration
+         * \param abs_err absolute error
+         * \param rel_err intermediate error
+         */
+        BatchQuanc8(const F &fun, const double a, const double b, const double abs_err, const double rel_err):
+            result_(0.0),
+            error_(0.0),
+            no_fun_(0),
+            flag_(0.0) {
+            details::quanc8(fun, a, b, abs_err, rel_err, std::addressof(result_), std::addressof(error_),
+                            std::addressof(no_fun_), std::addressof(flag_));
+        }
+
+        [[nodiscard]] double getResult() const { return result_; }
+        [[nodiscard]] double getError() const { return error_; }
+        [[nodiscard]] int getNoFun() const { return no_fun_; }
+        [[nodiscard]] double getFlag() const { return flag_; }
+
+    private:
+        double result_;
+        double error_;
+        int no_fun_;
+        double flag_;
+    };
+}
+#endif
@@ -0,0 +1,314 @@
+#ifndef DUAL_H
+#define DUAL_H
+#include <cmath>
+
+namespace dimkashelk {
+    /* number of directional derivatives carried by a Dual, one per SIMD lane */
+    constexpr int DUAL_LANES = 8;
+
+    /**
+     * \brief number of forward mode automatic differentiation, value + sum derivative[k] e_k with e_k e_l = 0.
+     * Every operation applies the chain rule to all N directions in one loop over the lanes, so a function
+     * templated on its number type gives N columns of its Jacobian in one call. Comparisons look at the value
+     * only. Functions are found by argument dependent lookup, code written for both double and Dual calls
+     * them unqualified after using std::exp and the like.
+     */
+    template<int N = DUAL_LANES>
+    struct Dual {
+        double value;
+        double derivative[N];
+
+        Dual(): value(0.0), derivative() {
+        }
+
+        /* a constant, all derivatives are 0 */
+        Dual(const double x): value(x), derivative() {
+        }
+
+        /**
+         * \brief independent variable with the value x in the direction of lane k
+         */
+        static Dual variable(const double x, const int k) {
+            Dual result(x);
+            result.derivative[k] = 1.0;
+            return result;
+        }
+
+        Dual &operator+=(const Dual &other) {
+            value += other.value;
+            for (int k = 0; k < N; ++k) derivative[k] += other.derivative[k];
+            return *this;
+        }
+
+        Dual &operator-=(const Dual &other) {
+            value -= other.value;
+            for (int k = 0; k < N; ++k) derivative[k] -= other.derivative[k];
+            return *this;
+        }
+
+        Dual &operator*=(const Dual &other) {
+            for (int k = 0; k < N; ++k) derivative[k] = derivative[k] * other.value + value * other.derivative[k];
+            value *= other.value;
+            return *this;
+        }
+
+        Dual &operator/=(const Dual &other) {
+            const double inverse = 1.0 / other.value;
+            value *= inverse;
+            for (int k = 0; k < N; ++k) derivative[k] = (derivative[k] - value * other.derivative[k]) * inverse;
+            return *this;
+        }
+
+        Dual &operator+=(const double x) {
+            value += x;
+            return *this;
+        }
+
+        Dual &operator-=(const double x) {
+            value -= x;
+            return *this;
+        }
+
+        Dual &operator*=(const double x) {
+            value *= x;
+            for (int k = 0; k < N; ++k) derivative[k] *= x;
+            return *this;
+        }
+
+        Dual &operator/=(const double x) {
+            return *this *= 1.0 / x;
+        }
+    };
+
+    namespace details {
+        /* f(x) with f(x.value) = fx and f'(x.value) = dfx */
+        template<int N>
+        Dual<N> chain(const Dual<N> &x, const double fx, const double dfx) {
+            Dual<N> result(fx);
+            for (int k = 0; k < N; ++k) result.derivative[k] = dfx * x.derivative[k];
+            return result;
+        }
+    }
+
+    template<int N>
+    Dual<N> operator+(const Dual<N> &x) {
+        return x;
+    }
+
+    template<int N>
+    Dual<N> operator-(const Dual<N> &x) {
+        return details::chain(x, -x.value, -1.0);
+    }
+
+    template<int N>
+    Dual<N> operator+(Dual<N> x, const Dual<N> &y) { return x += y; }
+
+    template<int N>
+    Dual<N> operator+(Dual<N> x, const double y) { return x += y; }
+
+    template<int N>
+    Dual<N> operator+(const double x, Dual<N> y) { return y += x; }
+
+    template<int N>
+    Dual<N> operator-(Dual<N> x, const Dual<N> &y) { return x -= y; }
+
+    template<int N>
+    Dual<N> operator-(Dual<N> x, const double y) { return x -= y; }
+
+    template<int N>
+    Dual<N> operator-(const double x, const Dual<N> &y) { return details::chain(y, x - y.value, -1.0); }
+
+    template<int N>
+    Dual<N> operator*(Dual<N> x, const Dual<N> &y) { return x *= y; }
+
+    template<int N>
+    Dual<N> operator*(Dual<N> x, const double y) { return x *= y; }
+
+    template<int N>
+    Dual<N> operator*(const double x, Dual<N> y) { return y *= x; }
+
+    template<int N>
+    Dual<N> operator/(Dual<N> x, const Dual<N> &y) { return x /= y; }
+
+    template<int N>
+    Dual<N> operator/(Dual<N> x, const double y) { return x /= y; }
+
+    template<int N>
+    Dual<N> operator/(const double x, const Dual<N> &y) {
+        const double inverse = 1.0 / y.value;
+        return details::chain(y, x * inverse, -x * inverse * inverse);
+    }
+
+    template<int N>
+    bool operator<(const Dual<N> &x, const Dual<N> &y) { return x.value < y.value; }
+
+    template<int N>
+    bool operator<(const Dual<N> &x, const double y) { return x.value < y; }
+
+    template<int N>
+    bool operator<(const double x, const Dual<N> &y) { return x < y.value; }
+
+    template<int N>
+    bool operator>(const Dual<N> &x, const Dual<N> &y) { return x.value > y.value; }
+
+    template<int N>
+    bool operator>(const Dual<N> &x, const double y) { return x.value > y; }
+
+    template<int N>
+    bool operator>(const double x, const Dual<N> &y) { return x > y.value; }
+
+    template<int N>
+    bool operator<=(const Dual<N> &x, const Dual<N> &y) { return x.value <= y.value; }
+
+    template<int N>
+    bool operator<=(const Dual<N> &x, const double y) { return x.value <= y; }
+
+    template<int N>
+    bool operator<=(const double x, const Dual<N> &y) { return x <= y.value; }
+
+    template<int N>
+    bool operator>=(const Dual<N> &x, const Dual<N> &y) { return x.value >= y.value; }
+
+    template<int N>
+    bool operator>=(const Dual<N> &x, const double y) { return x.value >= y; }
+
+    template<int N>
+    bool operator>=(const double x, const Dual<N> &y) { return x >= y.value; }
+
+    template<int N>
+    bool operator==(const Dual<N> &x, const Dual<N> &y) { return x.value == y.value; }
+
+    template<int N>
+    bool operator==(const Dual<N> &x, const double y) { return x.value == y; }
+
+    template<int N>
+    bool operator==(const double x, const Dual<N> &y) { return x == y.value; }
+
+    template<int N>
+    bool operator!=(const Dual<N> &x, const Dual<N> &y) { return x.value != y.value; }
+
+    template<int N>
+    bool operator!=(const Dual<N> &x, const double y) { return x.value != y; }
+
+    template<int N>
+    bool operator!=(const double x, const Dual<N> &y) { return x != y.value; }
+
+    template<int N>
+    Dual<N> exp(const Dual<N> &x) {
+        const double e = std::exp(x.value);
+        return details::chain(x, e, e);
+    }
+
+    template<int N>
+    Dual<N> log(const Dual<N> &x) {
+        return details::chain(x, std::log(x.value), 1.0 / x.value);
+    }
+
+    template<int N>
+    Dual<N> sqrt(const Dual<N> &x) {
+        const double s = std::sqrt(x.value);
+        return details::chain(x, s, 0.5 / s);
+    }
+
+    template<int N>
+    Dual<N> cbrt(const Dual<N> &x) {
+        const double c = std::cbrt(x.value);
+        return details::chain(x, c, 1.0 / (3.0 * c * c));
+    }
+
+    template<int N>
+    Dual<N> sin(const Dual<N> &x) {
+        return details::chain(x, std::sin(x.value), std::cos(x.value));
+    }
+
+    template<int N>
+    Dual<N> cos(const Dual<N> &x) {
+        return details::chain(x, std::cos(x.value), -std::sin(x.value));
+    }
+
+    template<int N>
+    Dual<N> tan(const Dual<N> &x) {
+        const double t = std::tan(x.value);
+        return details::chain(x, t, 1.0 + t * t);
+    }
+
+    template<int N>
+    Dual<N> asin(const Dual<N> &x) {
+        return details::chain(x, std::asin(x.value), 1.0 / std::sqrt(1.0 - x.value * x.value));
+    }
+
+    template<int N>
+    Dual<N> acos(const Dual<N> &x) {
+        return details::chain(x, std::acos(x.value), -1.0 / std::sqrt(1.0 - x.value * x.value));
+    }
+
+    template<int N>
+    Dual<N> atan(const Dual<N> &x) {
+        return details::chain(x, std::atan(x.value), 1.0 / (1.0 + x.value * x.value));
+    }
+
+    template<int N>
+    Dual<N> atan2(const Dual<N> &y, const Dual<N> &x) {
+        /* d atan2(y, x) = (x dy - y dx) / (x^2 + y^2) */
+        const double inverse = 1.0 / (x.value * x.value + y.value * y.value);
+        Dual<N> result(std::atan2(y.value, x.value));
+        for (int k = 0; k < N; ++k) {
+            result.derivative[k] = (x.value * y.derivative[k] - y.value * x.derivative[k]) * inverse;
+        }
+        return result;
+    }
+
+    template<int N>
+    Dual<N> sinh(const Dual<N> &x) {
+        return details::chain(x, std::sinh(x.value), std::cosh(x.value));
+    }
+
+    template<int N>
+    Dual<N> cosh(const Dual<N> &x) {
+        return details::chain(x, std::cosh(x.value), std::sinh(x.value));
+    }
+
+    template<int N>
+    Dual<N> tanh(const Dual<N> &x) {
+        const double t = std::tanh(x.value);
+        return details::chain(x, t, 1.0 - t * t);
+    }
+
+    template<int N>
+    Dual<N> fabs(const Dual<N> &x) {
+        return x.value < 0.0 ? -x : x;
+    }
+
+    template<int N>
+    Dual<N> abs(const Dual<N> &x) {
+        return fabs(x);
+    }
+
+    template<int N>
+    Dual<N> pow(const Dual<N> &x, const double p) {
+        /* x^p p / x is not defined at x = 0, x^(p - 1) is */
+        const double d = p == 0.0 ? 0.0 : p * std::pow(x.value, p - 1.0);
+        return details::chain(x, std::pow(x.value, p), d);
+    }
+
+    template<int N>
+    Dual<N> pow(const double x, const Dual<N> &p) {
+        const double v = std::pow(x, p.value);
+        return details::chain(p, v, x == 0.0 ? 0.0 : v * std::log(x));
+    }
+
+    template<int N>
+    Dual<N> pow(const Dual<N> &x, const Dual<N> &p) {
+        /* d x^p = p x^(p - 1) dx + x^p log(x) dp, the log term is left out for a constant p, and for
+           x <= 0 where only an integral p gives a value and x^p is taken as constant in p */
+        const double v = std::pow(x.value, p.value);
+        const double dx = p.value == 0.0 ? 0.0 : p.value * std::pow(x.value, p.value - 1.0);
+        bool constant = true;
+        for (int k = 0; k < N; ++k) constant = constant && p.derivative[k] == 0.0;
+        const double dp = constant || x.value <= 0.0 ? 0.0 : v * std::log(x.value);
+        Dual<N> result(v);
+        for (int k = 0; k < N; ++k) result.derivative[k] = dx * x.derivative[k] + dp * p.derivative[k];
+        return result;
+    }
+}
+#endif
@@ -0,0 +1,89 @@
+#include "EvaluationCache.h"
+
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+
+dimkashelk::EvaluationCache::EvaluationCache(const std::size_t capacity): capacity_(capacity),
+                                                                           hits_(0),
+                                                                           misses_(0) {
+    index_.reserve(capacity);
+}
+
+bool dimkashelk::EvaluationCache::find(const std::size_t id, const double x, double &value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = index_.find(Key{id, x});
+    if (it == index_.end()) {
+        misses_++;
+        return false;
+    }
+    hits_++;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    value = it->second->second;
+    return true;
+}
+
+void dimkashelk::EvaluationCache::insert(const std::size_t id, const double x, const double value) {
+    if (capacity_ == 0 || std::isnan(x)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Key key{id, x};
+    const auto it = index_.find(key);
+    if (it != index_.end()) {
+        it->second->second = value;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+    if (entries_.size() == capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+    entries_.emplace_front(key, value);
+    index_.emplace(key, entries_.begin());
+}
+
+void dimkashelk::EvaluationCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    hits_ = 0;
+    misses_ = 0;
+}
+
+std::size_t dimkashelk::EvaluationCache::get_capacity() const {
+    return capacity_;
+}
+
+std::size_t dimkashelk::EvaluationCache::get_size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+unsigned long dimkashelk::EvaluationCache::get_hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+unsigned long dimkashelk::EvaluationCache::get_misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+double dimkashelk::EvaluationCache::get_hit_rate() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const unsigned long total = hits_ + misses_;
+    return (total == 0) ? 0.0 : static_cast<double>(hits_) / static_cast<double>(total);
+}
+
+std::size_t dimkashelk::EvaluationCache::KeyHash::operator()(const Key &key) const {
+    /* -0.0 and 0.0 are the same key */
+    const double x = (key.x == 0.0) ? 0.0 : key.x;
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &x, sizeof(bits));
+    std::uint64_t h = bits ^ (static_cast<std::uint64_t>(key.id) * 0x9E3779B97F4A7C15ULL);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return static_cast<std::size_t>(h);
+}
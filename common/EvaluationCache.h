@@ -0,0 +1,129 @@
+#ifndef EVALUATION_CACHE_H
+#define EVALUATION_CACHE_H
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace dimkashelk {
+    /**
+     * \brief bounded memo of function values keyed by (id, x), the least recently used entry is dropped first.
+     *
+     * The id tells apart the functions sharing one cache, e.g. integrands of different parameters.
+     * All calls are thread-safe, the function itself is evaluated outside of the lock.
+     */
+    class EvaluationCache {
+    public:
+        /**
+         * \param capacity maximum number of stored values, 0 disables the cache
+         */
+        explicit EvaluationCache(std::size_t capacity);
+
+        EvaluationCache(const EvaluationCache &) = delete;
+
+        EvaluationCache &operator=(const EvaluationCache &) = delete;
+
+        /**
+         * \brief look up f_id(x), marks the entry as recently used
+         * \return true and the value if it is stored
+         */
+        bool find(std::size_t id, double x, double &value);
+
+        void insert(std::size_t id, double x, double value);
+
+        /**
+         * \brief f(x) from the cache, or evaluated and stored
+         * \param hit set to whether the value came from the cache, may be nullptr
+         */
+        template<class F>
+        double evaluate(const std::size_t id, const double x, F &&f, bool *hit = nullptr) {
+            double value = 0.0;
+            const bool found = find(id, x, value);
+            if (hit != nullptr) {
+                *hit = found;
+            }
+            if (!found) {
+                value = f(x);
+                insert(id, x, value);
+            }
+            return value;
+        }
+
+        void clear();
+
+        [[nodiscard]] std::size_t get_capacity() const;
+        [[nodiscard]] std::size_t get_size() const;
+        [[nodiscard]] unsigned long get_hits() const;
+        [[nodiscard]] unsigned long get_misses() const;
+        /**
+         * \brief hits / (hits + misses), 0 before the first look up
+         */
+        [[nodiscard]] double get_hit_rate() const;
+
+    private:
+        struct Key {
+            std::size_t id;
+            double x;
+
+            bool operator==(const Key &other) const {
+                return id == other.id && x == other.x;
+            }
+        };
+
+        struct KeyHash {
+            std::size_t operator()(const Key &key) const;
+        };
+
+        using Entry = std::pair<Key, double>;
+
+        std::size_t capacity_;
+        std::list<Entry> entries_;
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+        unsigned long hits_;
+        unsigned long misses_;
+        mutable std::mutex mutex_;
+    };
+
+    /**
+     * \brief f(x) through an EvaluationCache, usable wherever a scalar function is, e.g. Quanc8 or zeroin(),
+     * counts its own hits and calls of f
+     */
+    template<class F>
+    class CachedFunction {
+    public:
+        CachedFunction(EvaluationCache &cache, const std::size_t id, F fun): cache_(&cache),
+                                                                             id_(id),
+                                                                             fun_(std::move(fun)),
+                                                                             hits_(0),
+                                                                             calls_(0) {
+        }
+
+        double operator()(const double x) {
+            bool hit = false;
+            const double value = cache_->evaluate(id_, x, fun_, &hit);
+            if (hit) {
+                hits_++;
+            } else {
+                calls_++;
+            }
+            return value;
+        }
+
+        [[nodiscard]] int get_hits() const { return hits_; }
+        [[nodiscard]] int get_calls() const { return calls_; }
+
+    private:
+        EvaluationCache *cache_;
+        std::size_t id_;
+        F fun_;
+        int hits_;
+        int calls_;
+    };
+
+    template<class F>
+    CachedFunction<F> make_cached(EvaluationCache &cache, const std::size_t id, F fun) {
+        return CachedFunction<F>(cache, id, std::move(fun));
+    }
+}
+#endif
@@ -0,0 +1,187 @@
+#include "GaussKronrod.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "Statistics.h"
+
+namespace {
+    /* abscissae of the 15-point Kronrod rule on [-1, 1], xgk[1], xgk[3], xgk[5], xgk[7] are the Gauss nodes */
+    constexpr double XGK[8] = {
+        0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+        0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+        0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+        0.207784955007898467600689403773245, 0.000000000000000000000000000000000
+    };
+    constexpr double WGK[8] = {
+        0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+        0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+        0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+        0.204432940075298892414161999234649, 0.209482141084727828012999174891714
+    };
+    constexpr double WG[4] = {
+        0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+        0.381830050505118944950369775488975, 0.417959183673469387755102040816327
+    };
+
+    struct Region {
+        double a;
+        double b;
+        double result;
+        double error;
+    };
+
+    bool smaller_error(const Region &left, const Region &right) {
+        return left.error < right.error;
+    }
+
+    /* G7K15 on [a, b] with the error estimate of QUADPACK qk15 */
+    template<class F>
+    Region kronrod15(const F &fun, const double a, const double b) {
+        const double EPSILON = std::numeric_limits<double>::epsilon();
+        const double UNDERFLOW = std::numeric_limits<double>::min();
+        const double center = 0.5 * (a + b);
+        const double half = 0.5 * (b - a);
+        const double fc = fun(center);
+        double gauss = fc * WG[3];
+        double kronrod = fc * WGK[7];
+        double abs_kronrod = std::fabs(kronrod);
+        double f1[7], f2[7];
+        for (int j = 0; j < 7; j++) {
+            const double dx = half * XGK[j];
+            f1[j] = fun(center - dx);
+            f2[j] = fun(center + dx);
+            const double sum = f1[j] + f2[j];
+            kronrod += WGK[j] * sum;
+            abs_kronrod += WGK[j] * (std::fabs(f1[j]) + std::fabs(f2[j]));
+            if (j % 2 == 1) gauss += WG[j / 2] * sum;
+        }
+        const double mean = 0.5 * kronrod;
+        double asc = WGK[7] * std::fabs(fc - mean);
+        for (int j = 0; j < 7; j++) asc += WGK[j] * (std::fabs(f1[j] - mean) + std::fabs(f2[j] - mean));
+
+        Region region{a, b, kronrod * half, std::fabs((kronrod - gauss) * half)};
+        asc *= std::fabs(half);
+        abs_kronrod *= std::fabs(half);
+        if (asc != 0.0 && region.error != 0.0) {
+            region.error = asc * std::min(1.0, std::pow(200.0 * region.error / asc, 1.5));
+        }
+        if (abs_kronrod > UNDERFLOW / (50.0 * EPSILON)) {
+            region.error = std::max(50.0 * EPSILON * abs_kronrod, region.error);
+        }
+        return region;
+    }
+}
+
+dimkashelk::GaussKronrod::GaussKronrod(const std::function<double(double)> &fun, double a, double b,
+                                       const double abs_err, const double rel_err, const int max_fun):
+    result_(0.0),
+    error_(0.0),
+    no_fun_(0),
+    flag_(0.0),
+    regions_(0) {
+    NUMERICS_TIMER(INTEGRATE);
+    if (std::isnan(a) || std::isnan(b) || abs_err < 0.0 || rel_err < 0.0 || max_fun < 15) {
+        throw std::logic_error("Check parameters of integration");
+    }
+    if (a == b) {
+        return;
+    }
+    double sign = 1.0;
+    if (a > b) {
+        std::swap(a, b);
+        sign = -1.0;
+    }
+
+    /* the integrand on the finite interval of integration */
+    const bool lower_infinite = std::isinf(a);
+    const bool upper_infinite = std::isinf(b);
+    auto integrand = [&](const double t) {
+        no_fun_++;
+        NUMERICS_COUNT(INTEGRAND_CALLS, 1);
+        if (lower_infinite && upper_infinite) {
+            const double d = 1.0 - t * t;
+            return fun(t / d) * (1.0 + t * t) / (d * d);
+        }
+        if (upper_infinite) {
+            const double d = 1.0 - t;
+            return fun(a + t / d) / (d * d);
+        }
+        if (lower_infinite) {
+            const double d = 1.0 - t;
+            return fun(b - t / d) / (d * d);
+        }
+        return fun(t);
+    };
+    const double left = lower_infinite && upper_infinite ? -1.0 : (lower_infinite || upper_infinite ? 0.0 : a);
+    const double right = lower_infinite || upper_infinite ? 1.0 : b;
+
+    std::vector<Region> heap;
+    heap.push_back(kronrod15(integrand, left, right));
+    double result = heap[0].result;
+    double error = heap[0].error;
+    while (!(error <= std::max(abs_err, rel_err * std::fabs(result)))) {
+        if (no_fun_ + 30 > max_fun || !std::isfinite(error)) {
+            break;
+        }
+        std::pop_heap(heap.begin(), heap.end(), smaller_error);
+        const Region worst = heap.back();
+        heap.pop_back();
+        const double middle = 0.5 * (worst.a + worst.b);
+        if (!(worst.a < middle && middle < worst.b) ||
+            std::fabs(worst.b - worst.a) <= 100.0 * std::numeric_limits<double>::epsilon() * std::fabs(middle)) {
+            /* too small to be bisected, keep it and stop */
+            heap.push_back(worst);
+            std::push_heap(heap.begin(), heap.end(), smaller_error);
+            break;
+        }
+        const Region first = kronrod15(integrand, worst.a, middle);
+        const Region second = kronrod15(integrand, middle, worst.b);
+        heap.push_back(first);
+        std::push_heap(heap.begin(), heap.end(), smaller_error);
+        heap.push_back(second);
+        std::push_heap(heap.begin(), heap.end(), smaller_error);
+        result += first.result + second.result - worst.result;
+        error += first.error + second.error - worst.error;
+    }
+
+    /* the running sums lose accuracy by cancellation, add the regions again */
+    result = 0.0;
+    error = 0.0;
+    for (const Region &region: heap) {
+        result += region.result;
+        error += region.error;
+    }
+    const double tolerance = std::max(abs_err, rel_err * std::fabs(result));
+    if (!std::isfinite(result) || !std::isfinite(error)) {
+        flag_ = 1.0;
+    } else if (error > tolerance) {
+        flag_ = tolerance > 0.0 ? std::max(1.0, error / tolerance) : 1.0;
+    }
+    result_ = sign * result;
+    error_ = error;
+    regions_ = static_cast<int>(heap.size());
+}
+
+double dimkashelk::GaussKronrod::getResult() const {
+    return result_;
+}
+
+double dimkashelk::GaussKronrod::getError() const {
+    return error_;
+}
+
+int dimkashelk::GaussKronrod::getNoFun() const {
+    return no_fun_;
+}
+
+double dimkashelk::GaussKronrod::getFlag() const {
+    return flag_;
+}
+
+int dimkashelk::GaussKronrod::getRegions() const {
+    return regions_;
+}
@@ -0,0 +1,48 @@
+#ifndef GAUSS_KRONROD_H
+#define GAUSS_KRONROD_H
+#include <functional>
+
+namespace dimkashelk {
+    /**
+     * \brief globally adaptive Gauss-Kronrod integration, the 15-point Kronrod rule with its embedded 7-point
+     * Gauss rule on every region, the region of largest error is bisected next (a heap of regions).
+     *
+     * Infinite bounds are mapped onto a finite interval, x = a + t / (1 - t) for [a, inf),
+     * x = t / (1 - t^2) for (-inf, inf). The integrand is not evaluated at the ends of a region,
+     * so integrable endpoint singularities are allowed. Same interface as Quanc8.
+     */
+    class GaussKronrod {
+    public:
+        /**
+         * \brief
+         * \param fun user functions with one double argument
+         * \param a lower bound of integration, may be -infinity
+         * \param b upper bound of integration, may be +infinity
+         * \param abs_err absolute error
+         * \param rel_err relative error
+         * \param max_fun limit on the number of evaluations of fun
+         */
+        GaussKronrod(const std::function<double (double)> &fun, double a, double b, double abs_err, double rel_err,
+                     int max_fun = 5000);
+        [[nodiscard]] double getResult() const;
+        [[nodiscard]] double getError() const;
+        [[nodiscard]] int getNoFun() const;
+        /**
+         * \brief 0 for a reliable result, otherwise getError() divided by the requested error,
+         * reached when max_fun was used up or the regions became too small to be bisected
+         */
+        [[nodiscard]] double getFlag() const;
+        /**
+         * \brief number of regions of the final partition
+         */
+        [[nodiscard]] int getRegions() const;
+
+    private:
+        double result_;
+        double error_;
+        int no_fun_;
+        double flag_;
+        int regions_;
+    };
+}
+#endif
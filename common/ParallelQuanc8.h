@@ -0,0 +1,108 @@
+#ifndef PARALLEL_QUANC8_H
+#define PARALLEL_QUANC8_H
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "BatchQuanc8.h"
+#include "ThreadPool.h"
+
+namespace dimkashelk {
+    /**
+     * \brief Quanc8 over subintervals integrated concurrently on a thread pool.
+     *
+     * [a, b] is split into equal chunks, each of them gets the share of abs_err proportional to its length.
+     * Chunks for which Quanc8 returns a nonzero flag are halved and integrated again, up to max_depth times,
+     * so hard parts of the range are refined by all threads while easy chunks finish early.
+     * The error estimates of the chunks are summed, so getError() bounds the whole integral as in Quanc8.
+     * For a given number of chunks the result does not depend on the number of threads.
+     */
+    template<class F>
+    class ParallelQuanc8 {
+    public:
+        /**
+         * \brief
+         * \param pool threads for the chunks, the integrand is called from all of them concurrently
+         * \param fun batch integrand, see details::quanc8, use make_pointwise() for a scalar one
+         * \param a lower bound of integration
+         * \param b upper bound of integration
+         * \param abs_err absolute error
+         * \param rel_err intermediate error
+         * \param chunks number of starting subintervals, 0 means 4 per thread
+         * \param max_depth maximum number of halvings of a starting subinterval
+         */
+        ParallelQuanc8(ThreadPool &pool, const F &fun, const double a, const double b, const double abs_err,
+                       const double rel_err, int chunks = 0, const int max_depth = 8): result_(0.0),
+            error_(0.0),
+            no_fun_(0),
+            flag_(0.0),
+            intervals_(0) {
+            if (a == b) {
+                return;
+            }
+            if (chunks <= 0) {
+                chunks = 4 * static_cast<int>(pool.get_threads());
+            }
+            const double length = std::fabs(b - a);
+            std::vector<Part> parts(chunks);
+            for (int i = 0; i < chunks; i++) {
+                parts[i].a = a + (b - a) * i / chunks;
+                parts[i].b = (i + 1 == chunks) ? b : a + (b - a) * (i + 1) / chunks;
+                parts[i].depth = 0;
+            }
+            std::vector<Part> next;
+            while (!parts.empty()) {
+                pool.run(static_cast<int>(parts.size()), [&](const int i) {
+                    Part &part = parts[i];
+                    details::quanc8(fun, part.a, part.b, abs_err * std::fabs(part.b - part.a) / length, rel_err,
+                                    std::addressof(part.result), std::addressof(part.error),
+                                    std::addressof(part.no_fun), std::addressof(part.flag));
+                });
+                next.clear();
+                for (const Part &part: parts) {
+                    no_fun_ += part.no_fun;
+                    if (part.flag != 0.0 && part.depth < max_depth) {
+                        const double middle = (part.a + part.b) / 2.0;
+                        next.push_back({part.a, middle, part.depth + 1, 0.0, 0.0, 0.0, 0});
+                        next.push_back({middle, part.b, part.depth + 1, 0.0, 0.0, 0.0, 0});
+                        continue;
+                    }
+                    /* the fraction of a chunk left unintegrated is scaled to the whole range */
+                    const double whole = std::floor(part.flag);
+                    result_ += part.result;
+                    error_ += part.error;
+                    flag_ += whole + (part.flag - whole) * std::fabs(part.b - part.a) / length;
+                    intervals_++;
+                }
+                parts.swap(next);
+            }
+        }
+
+        [[nodiscard]] double getResult() const { return result_; }
+        [[nodiscard]] double getError() const { return error_; }
+        [[nodiscard]] int getNoFun() const { return no_fun_; }
+        [[nodiscard]] double getFlag() const { return flag_; }
+        /**
+         * \brief number of subintervals the result is summed over
+         */
+        [[nodiscard]] int getIntervals() const { return intervals_; }
+
+    private:
+        struct Part {
+            double a;
+            double b;
+            int depth;
+            double result;
+            double error;
+            double flag;
+            int no_fun;
+        };
+
+        double result_;
+        double error_;
+        int no_fun_;
+        double flag_;
+        int intervals_;
+    };
+}
+#endif
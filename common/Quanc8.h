@@ -1,8 +1,11 @@
 #ifndef QUANC8_H
 #define QUANC8_H
+#include <cstddef>
 #include <functional>
 
 namespace dimkashelk {
+    class EvaluationCache;
+
     class Quanc8 {
     public:
         /**
@@ -14,10 +17,21 @@ namespace dimkashelk {
          * \param rel_err intermediate error
          */
         Quanc8(const std::function<double (double)> &fun, double a, double b, double abs_err, double rel_err);
+        /**
+         * \brief Quanc8 with the values of fun taken from a cache shared with other integrations
+         * \param cache values of fun stored under id
+         * \param id identifier of fun in the cache
+         */
+        Quanc8(const std::function<double (double)> &fun, double a, double b, double abs_err, double rel_err,
+               EvaluationCache &cache, std::size_t id);
         double getResult() const;
         double getError() const;
         int getNoFun() const;
         double getFlag() const;
+        /**
+         * \brief how many of getNoFun() values came from the cache
+         */
+        int getCacheHits() const;
     private:
         std::function<double (double)> fun_;
         const double a_;
@@ -28,6 +42,7 @@ namespace dimkashelk {
         double error_;
         int no_fun_;
         double flag_;
+        int cache_hits_;
     };
 }
 #endif
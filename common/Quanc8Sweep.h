@@ -0,0 +1,308 @@
+#ifndef QUANC8_SWEEP_H
+#define QUANC8_SWEEP_H
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace dimkashelk {
+    /* number of parameters integrated together on shared nodes */
+    constexpr int SWEEP_LANES = 8;
+
+    namespace details {
+        /**
+         * \brief Quanc8 for SWEEP_LANES members of a family f(x, p) integrated on shared nodes.
+         * A panel is accepted only if it is accurate enough for every lane, so a lane is refined at least
+         * as much as by its own Quanc8 until a hard lane exhausts the evaluations and the maximum level drops
+         * for all of them. The flag of a lane counts only the panels that failed its own error test.
+         * \param fun family integrand, fun(const double x[], int count, const double p[], double f[])
+         * sets f[i * SWEEP_LANES + l] = f(x[i], p[l]) for i < count, l < SWEEP_LANES
+         * \param p parameters of the lanes
+         * \param a lower bound of integration
+         * \param b upper bound of integration
+         * \param abs_err absolute error
+         * \param rel_err intermediate error
+         * \param result approximations of the integrals
+         * \param error estimates of the absolute errors
+         * \param no_fun number of evaluations of every lane
+         * \param flag reliability indicators as in Quanc8
+         */
+        template<class Family>
+        void quanc8_lanes(Family &&fun, const double p[], const double a, const double b, const double abs_err,
+                          const double rel_err, double result[], double error[], int *no_fun, double flag[]) {
+            constexpr int L = SWEEP_LANES;
+            double QRIGHT[32][L], F[17][L], X[17], FSAVE[9][31][L], XSAVE[9][31];
+            double XNEW[9], FNEW[9 * L];
+            double COR11[L], AREA[L], F0[L], QLEFT[L], QNOW[L], QDIFF[L], QPREV[L], ESTERR[L];
+            int LEVMIN, LEVMAX, LEVOUT, NOMAX, NOFIN, LEV, NIM, J, I, K;
+            double W0, W1, W2, W3, W4, X0, STONE, STEP, TOLERR;
+            bool DONE, CONVERGED[L];
+
+            LEVMIN = 1;
+            LEVMAX = 30;
+            LEVOUT = 6;
+            NOMAX = 5000;
+            NOFIN = NOMAX - (8 * (LEVMAX - LEVOUT + static_cast<int>(std::pow(2, LEVOUT + 1))));
+
+            W0 = 3956.0 / 14175.0;
+            W1 = 23552.0 / 14175.0;
+            W2 = -3712.0 / 14175.0;
+            W3 = 41984.0 / 14175.0;
+            W4 = -18160.0 / 14175.0;
+
+            for (K = 0; K < L; K++) {
+                flag[K] = 0.0;
+                result[K] = 0.0;
+                COR11[K] = 0.0;
+                error[K] = 0.0;
+                AREA[K] = 0.0;
+                QPREV[K] = 0.0;
+            }
+            *no_fun = 0;
+            if (a == b) { return; }
+            LEV = 0;
+            NIM = 1;
+            X0 = a;
+            X[16] = b;
+            STONE = (b - a) / 16.0;
+            X[8] = (X0 + X[16]) / 2.0;
+            X[4] = (X0 + X[8]) / 2.0;
+            X[12] = (X[8] + X[16]) / 2.0;
+            X[2] = (X0 + X[4]) / 2.0;
+            X[6] = (X[4] + X[8]) / 2.0;
+            X[10] = (X[8] + X[12]) / 2.0;
+            X[14] = (X[12] + X[16]) / 2.0;
+            XNEW[0] = X0;
+            for (J = 2; J <= 16; J = J + 2) {
+                XNEW[J / 2] = X[J];
+            }
+            fun(static_cast<const double *>(XNEW), 9, p, static_cast<double *>(FNEW));
+            for (K = 0; K < L; K++) {
+                F0[K] = FNEW[K];
+            }
+            for (J = 2; J <= 16; J = J + 2) {
+                for (K = 0; K < L; K++) {
+                    F[J][K] = FNEW[(J / 2) * L + K];
+                }
+            }
+            *no_fun = 9;
+
+        trenta:
+            X[1] = (X0 + X[2]) / 2.0;
+            for (J = 3; J <= 15; J = J + 2) {
+                X[J] = (X[J - 1] + X[J + 1]) / 2.0;
+            }
+            for (J = 1; J <= 15; J = J + 2) {
+                XNEW[J / 2] = X[J];
+            }
+            fun(static_cast<const double *>(XNEW), 8, p, static_cast<double *>(FNEW));
+            for (J = 1; J <= 15; J = J + 2) {
+                for (K = 0; K < L; K++) {
+                    F[J][K] = FNEW[(J / 2) * L + K];
+                }
+            }
+            *no_fun = *no_fun + 8;
+            STEP = (X[16] - X0) / 16.0;
+            DONE = true;
+            for (K = 0; K < L; K++) {
+                QLEFT[K] = (W0 * (F0[K] + F[8][K]) + W1 * (F[1][K] + F[7][K]) + W2 * (F[2][K] + F[6][K])
+                            + W3 * (F[3][K] + F[5][K]) + W4 * F[4][K]) * STEP;
+                QRIGHT[LEV + 1][K] = (W0 * (F[8][K] + F[16][K]) + W1 * (F[9][K] + F[15][K])
+                                      + W2 * (F[10][K] + F[14][K]) + W3 * (F[11][K] + F[13][K])
+                                      + W4 * F[12][K]) * STEP;
+                QNOW[K] = QLEFT[K] + QRIGHT[LEV + 1][K];
+                QDIFF[K] = QNOW[K] - QPREV[K];
+                AREA[K] = AREA[K] + QDIFF[K];
+
+                ESTERR[K] = std::fabs(QDIFF[K]) / 1023.0;
+                if (abs_err > (rel_err * std::fabs(AREA[K])) * (STEP / STONE))
+                    TOLERR = abs_err;
+                else
+                    TOLERR = (rel_err * std::fabs(AREA[K])) * (STEP / STONE);
+                CONVERGED[K] = ESTERR[K] <= TOLERR;
+                DONE = DONE && CONVERGED[K];
+            }
+            if (LEV < LEVMIN)
+                goto cinquanta;
+            if (LEV >= LEVMAX)
+                goto sessantadue;
+            if (*no_fun > NOFIN)
+                goto sessanta;
+            if (DONE)
+                goto settanta;
+
+        cinquanta:
+            NIM = 2 * NIM;
+            LEV = LEV + 1;
+
+            for (I = 1; I <= 8; I++) {
+                for (K = 0; K < L; K++) {
+                    FSAVE[I][LEV][K] = F[I + 8][K];
+                }
+                XSAVE[I][LEV] = X[I + 8];
+            }
+
+            for (K = 0; K < L; K++) {
+                QPREV[K] = QLEFT[K];
+            }
+            for (I = 1; I <= 8; I++) {
+                J = -I;
+                for (K = 0; K < L; K++) {
+                    F[2 * J + 18][K] = F[J + 9][K];
+                }
+                X[2 * J + 18] = X[J + 9];
+            }
+            goto trenta;
+
+        sessanta:
+            NOFIN = 2 * NOFIN;
+            LEVMAX = LEVOUT;
+            for (K = 0; K < L; K++) {
+                if (!CONVERGED[K]) flag[K] = flag[K] + ((b - X0) / (b - a));
+            }
+            goto settanta;
+
+        sessantadue:
+            for (K = 0; K < L; K++) {
+                if (!CONVERGED[K]) flag[K] = flag[K] + 1.0;
+            }
+
+        settanta:
+            for (K = 0; K < L; K++) {
+                result[K] = result[K] + QNOW[K];
+                error[K] = error[K] + ESTERR[K];
+                COR11[K] = COR11[K] + QDIFF[K] / 1023.0;
+            }
+
+            while (NIM % 2 != 0) {
+                NIM = NIM / 2;
+                LEV = LEV - 1;
+            }
+            NIM = NIM + 1;
+            if (LEV <= 0)
+                goto ottanta;
+
+            X0 = X[16];
+            for (K = 0; K < L; K++) {
+                QPREV[K] = QRIGHT[LEV][K];
+                F0[K] = F[16][K];
+            }
+            for (I = 1; I <= 8; I++) {
+                for (K = 0; K < L; K++) {
+                    F[2 * I][K] = FSAVE[I][LEV][K];
+                }
+                X[2 * I] = XSAVE[I][LEV];
+            }
+            goto trenta;
+
+        ottanta:
+            for (K = 0; K < L; K++) {
+                result[K] = result[K] + COR11[K];
+                if (error[K] == 0.0)
+                    continue;
+                while (std::fabs(result[K]) + (error[K]) == std::fabs(result[K]))
+                    error[K] = 2.0 * (error[K]);
+            }
+        }
+    }
+
+    /**
+     * \brief family form of a scalar integrand f(x, p)
+     */
+    template<class F>
+    class PointwiseFamily {
+    public:
+        explicit PointwiseFamily(F fun): fun_(std::move(fun)) {
+        }
+
+        void operator()(const double x[], const int count, const double p[], double f[]) const {
+            for (int i = 0; i < count; i++) {
+                for (int l = 0; l < SWEEP_LANES; l++) {
+                    f[i * SWEEP_LANES + l] = fun_(x[i], p[l]);
+                }
+            }
+        }
+
+    private:
+        F fun_;
+    };
+
+    template<class F>
+    PointwiseFamily<F> make_pointwise_family(F fun) {
+        return PointwiseFamily<F>(std::move(fun));
+    }
+
+    /**
+     * \brief integrals of f(x, p) over [a, b] for many parameters p.
+     *
+     * Groups of SWEEP_LANES parameters share the nodes of one adaptive Quanc8 run,
+     * the integrand evaluates a node for all of them at once (see details::quanc8_lanes),
+     * the groups run in parallel on the pool.
+     */
+    template<class F>
+    class Quanc8Sweep {
+    public:
+        /**
+         * \brief
+         * \param pool threads for the groups of parameters, nullptr for serial execution
+         * \param fun family integrand, see details::quanc8_lanes, use make_pointwise_family() for a scalar one
+         * \param params parameters p
+         * \param a lower bound of integration
+         * \param b upper bound of integration
+         * \param abs_err absolute error
+         * \param rel_err intermediate error
+         */
+        Quanc8Sweep(ThreadPool *pool, const F &fun, const std::vector<double> &params, const double a,
+                    const double b, const double abs_err, const double rel_err): result_(params.size()),
+            error_(params.size()),
+            no_fun_(params.size()),
+            flag_(params.size()) {
+            if (params.empty()) {
+                throw std::logic_error("Check parameters");
+            }
+            constexpr int L = SWEEP_LANES;
+            const int count = static_cast<int>(params.size());
+            const int groups = (count + L - 1) / L;
+            auto task = [&](const int group) {
+                double p[L], result[L], error[L], flag[L];
+                int no_fun = 0;
+                /* a short last group repeats its last parameter */
+                for (int l = 0; l < L; l++) {
+                    p[l] = params[std::min(group * L + l, count - 1)];
+                }
+                details::quanc8_lanes(fun, static_cast<const double *>(p), a, b, abs_err, rel_err,
+                                      static_cast<double *>(result), static_cast<double *>(error),
+                                      std::addressof(no_fun), static_cast<double *>(flag));
+                for (int l = 0; l < L && group * L + l < count; l++) {
+                    result_[group * L + l] = result[l];
+                    error_[group * L + l] = error[l];
+                    no_fun_[group * L + l] = no_fun;
+                    flag_[group * L + l] = flag[l];
+                }
+            };
+            if (pool == nullptr) {
+                for (int group = 0; group < groups; group++) {
+                    task(group);
+                }
+            } else {
+                pool->run(groups, task);
+            }
+        }
+
+        [[nodiscard]] const std::vector<double> &getResult() const { return result_; }
+        [[nodiscard]] const std::vector<double> &getError() const { return error_; }
+        [[nodiscard]] const std::vector<int> &getNoFun() const { return no_fun_; }
+        [[nodiscard]] const std::vector<double> &getFlag() const { return flag_; }
+
+    private:
+        std::vector<double> result_;
+        std::vector<double> error_;
+        std::vector<int> no_fun_;
+        std::vector<double> flag_;
+    };
+}
+#endif
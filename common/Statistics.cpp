@@ -0,0 +1,218 @@
+#include "Statistics.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    using dimkashelk::statistics::Snapshot;
+    using dimkashelk::statistics::TraceEvent;
+    using dimkashelk::statistics::details::Recorder;
+
+    /* recorders of the running threads and what finished threads left behind */
+    struct Registry {
+        std::mutex mutex;
+        std::vector<Recorder *> recorders;
+        Snapshot retired;
+        std::vector<TraceEvent> retired_trace;
+        unsigned next_thread = 0;
+    };
+
+    Registry &registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    /* the values of a recorder as they are now */
+    Snapshot read(const Recorder &recorder) {
+        Snapshot values;
+        for (int i = 0; i < dimkashelk::statistics::COUNTERS; i++) {
+            values.counters[i] = recorder.counters[i].load(std::memory_order_relaxed);
+        }
+        for (int i = 0; i < dimkashelk::statistics::TIMERS; i++) {
+            values.timer_ns[i] = recorder.timer_ns[i].load(std::memory_order_relaxed);
+            values.timer_calls[i] = recorder.timer_calls[i].load(std::memory_order_relaxed);
+        }
+        for (int h = 0; h < dimkashelk::statistics::HISTOGRAMS; h++) {
+            for (int b = 0; b < dimkashelk::statistics::HISTOGRAM_BUCKETS; b++) {
+                values.histograms[h][b] = recorder.histograms[h][b].load(std::memory_order_relaxed);
+            }
+        }
+        return values;
+    }
+
+    /* adds what the recorder counted since its baseline */
+    void accumulate(Snapshot &snapshot, const Recorder &recorder) {
+        const Snapshot values = read(recorder);
+        const Snapshot &base = recorder.baseline;
+        for (int i = 0; i < dimkashelk::statistics::COUNTERS; i++) {
+            snapshot.counters[i] += values.counters[i] - base.counters[i];
+        }
+        for (int i = 0; i < dimkashelk::statistics::TIMERS; i++) {
+            snapshot.timer_ns[i] += values.timer_ns[i] - base.timer_ns[i];
+            snapshot.timer_calls[i] += values.timer_calls[i] - base.timer_calls[i];
+        }
+        for (int h = 0; h < dimkashelk::statistics::HISTOGRAMS; h++) {
+            for (int b = 0; b < dimkashelk::statistics::HISTOGRAM_BUCKETS; b++) {
+                snapshot.histograms[h][b] += values.histograms[h][b] - base.histograms[h][b];
+            }
+        }
+    }
+
+    /* the values of a new recorder, written by its own thread */
+    void clear(Recorder &recorder) {
+        for (auto &value: recorder.counters) value.store(0, std::memory_order_relaxed);
+        for (auto &value: recorder.timer_ns) value.store(0, std::memory_order_relaxed);
+        for (auto &value: recorder.timer_calls) value.store(0, std::memory_order_relaxed);
+        for (auto &histogram: recorder.histograms) {
+            for (auto &value: histogram) value.store(0, std::memory_order_relaxed);
+        }
+        recorder.baseline = Snapshot();
+    }
+}
+
+std::atomic<bool> dimkashelk::statistics::details::tracing(false);
+
+dimkashelk::statistics::details::Recorder::Recorder() {
+    clear(*this);
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    thread = r.next_thread++;
+    r.recorders.push_back(this);
+}
+
+dimkashelk::statistics::details::Recorder::~Recorder() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    accumulate(r.retired, *this);
+    {
+        std::lock_guard<std::mutex> trace_lock(trace_mutex);
+        r.retired_trace.insert(r.retired_trace.end(), trace.begin(), trace.end());
+    }
+    r.recorders.erase(std::remove(r.recorders.begin(), r.recorders.end(), this), r.recorders.end());
+}
+
+std::uint64_t dimkashelk::statistics::now() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+dimkashelk::statistics::Scope::Scope(const Timer timer): timer_(timer),
+                                                         begin_(now()) {
+}
+
+dimkashelk::statistics::Scope::~Scope() {
+    const std::uint64_t duration = now() - begin_;
+    details::Recorder &recorder = details::recorder();
+    details::bump(recorder.timer_ns[static_cast<int>(timer_)], duration);
+    details::bump(recorder.timer_calls[static_cast<int>(timer_)], 1);
+    if (details::tracing.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(recorder.trace_mutex);
+        recorder.trace.push_back({timer_, recorder.thread, begin_, duration});
+    }
+}
+
+dimkashelk::statistics::Snapshot dimkashelk::statistics::snapshot() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    Snapshot result = r.retired;
+    for (const Recorder *recorder: r.recorders) {
+        accumulate(result, *recorder);
+    }
+    return result;
+}
+
+void dimkashelk::statistics::reset() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.retired = Snapshot();
+    r.retired_trace.clear();
+    /* the counters belong to their threads, the new baseline is what they show now */
+    for (Recorder *recorder: r.recorders) {
+        recorder->baseline = read(*recorder);
+        std::lock_guard<std::mutex> trace_lock(recorder->trace_mutex);
+        recorder->trace.clear();
+    }
+}
+
+void dimkashelk::statistics::set_tracing(const bool enabled) {
+    details::tracing.store(enabled, std::memory_order_relaxed);
+}
+
+const char *dimkashelk::statistics::name(const Counter counter) {
+    static const char *names[COUNTERS] = {
+        "integrand_calls", "rhs_calls", "jacobians", "accepted_steps", "rejected_steps", "factorizations",
+        "pivot_swaps", "solves", "matvecs", "root_calls", "bytes_allocated"
+    };
+    return names[static_cast<int>(counter)];
+}
+
+const char *dimkashelk::statistics::name(const Timer timer) {
+    static const char *names[TIMERS] = {"factor", "solve", "integrate", "ode"};
+    return names[static_cast<int>(timer)];
+}
+
+const char *dimkashelk::statistics::name(const Histogram histogram) {
+    static const char *names[HISTOGRAMS] = {"refinement_depth"};
+    return names[static_cast<int>(histogram)];
+}
+
+void dimkashelk::statistics::write_json(std::ostream &out) {
+    const Snapshot s = snapshot();
+    out << "{\n  \"counters\": {";
+    for (int i = 0; i < COUNTERS; i++) {
+        out << (i ? ", " : "") << "\"" << name(static_cast<Counter>(i)) << "\": " << s.counters[i];
+    }
+    out << "},\n  \"timers\": {";
+    for (int i = 0; i < TIMERS; i++) {
+        out << (i ? ", " : "") << "\"" << name(static_cast<Timer>(i)) << "\": {\"calls\": " << s.timer_calls[i]
+            << ", \"ns\": " << s.timer_ns[i] << "}";
+    }
+    out << "},\n  \"histograms\": {";
+    for (int h = 0; h < HISTOGRAMS; h++) {
+        out << (h ? ", " : "") << "\"" << name(static_cast<Histogram>(h)) << "\": [";
+        for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+            out << (b ? ", " : "") << s.histograms[h][b];
+        }
+        out << "]";
+    }
+    out << "}\n}\n";
+}
+
+void dimkashelk::statistics::write_chrome_trace(std::ostream &out) {
+    std::vector<TraceEvent> events;
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        events = r.retired_trace;
+        for (Recorder *recorder: r.recorders) {
+            std::lock_guard<std::mutex> trace_lock(recorder->trace_mutex);
+            events.insert(events.end(), recorder->trace.begin(), recorder->trace.end());
+        }
+    }
+    std::uint64_t origin = events.empty() ? now() : events.front().begin_ns;
+    for (const TraceEvent &event: events) {
+        origin = std::min(origin, event.begin_ns);
+    }
+    const Snapshot s = snapshot();
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    bool first = true;
+    const auto old_precision = out.precision(15);
+    for (const TraceEvent &event: events) {
+        out << (first ? "" : ",\n") << "{\"name\": \"" << name(event.timer) << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+            << event.thread << ", \"ts\": " << static_cast<double>(event.begin_ns - origin) / 1000.0
+            << ", \"dur\": " << static_cast<double>(event.duration_ns) / 1000.0 << "}";
+        first = false;
+    }
+    /* totals of the counters as one counter event at the end of the trace */
+    std::uint64_t end = origin;
+    for (const TraceEvent &event: events) {
+        end = std::max(end, event.begin_ns + event.duration_ns);
+    }
+    out << (first ? "" : ",\n") << "{\"name\": \"counters\", \"ph\": \"C\", \"pid\": 1, \"tid\": 0, \"ts\": "
+        << static_cast<double>(end - origin) / 1000.0 << ", \"args\": {";
+    for (int i = 0; i < COUNTERS; i++) {
+        out << (i ? ", " : "") << "\"" << name(static_cast<Counter>(i)) << "\": " << s.counters[i];
+    }
+    out << "}}\n]}\n";
+    out.precision(old_precision);
+}
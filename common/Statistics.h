@@ -0,0 +1,177 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+/*
+ * Counters and timers of the solvers. The NUMERICS_* macros record into a thread-local recorder and expand
+ * to nothing unless NUMERICS_STATISTICS is defined, the ENABLE_STATISTICS option of CMake defines it.
+ * snapshot() adds up the recorders of all threads, including threads that have finished.
+ */
+
+namespace dimkashelk {
+    namespace statistics {
+        enum class Counter {
+            INTEGRAND_CALLS,
+            RHS_CALLS,
+            JACOBIANS,
+            ACCEPTED_STEPS,
+            REJECTED_STEPS,
+            FACTORIZATIONS,
+            PIVOT_SWAPS,
+            SOLVES,
+            /* products with the operator of an iterative solver */
+            MATVECS,
+            ROOT_CALLS,
+            BYTES_ALLOCATED,
+            COUNT
+        };
+
+        enum class Timer {
+            FACTOR,
+            SOLVE,
+            INTEGRATE,
+            ODE,
+            COUNT
+        };
+
+        enum class Histogram {
+            /* level of the accepted Quanc8 panels */
+            REFINEMENT_DEPTH,
+            COUNT
+        };
+
+        constexpr int COUNTERS = static_cast<int>(Counter::COUNT);
+        constexpr int TIMERS = static_cast<int>(Timer::COUNT);
+        constexpr int HISTOGRAMS = static_cast<int>(Histogram::COUNT);
+        constexpr int HISTOGRAM_BUCKETS = 32;
+
+        struct Snapshot {
+            std::array<std::uint64_t, COUNTERS> counters{};
+            std::array<std::uint64_t, TIMERS> timer_ns{};
+            std::array<std::uint64_t, TIMERS> timer_calls{};
+            std::array<std::array<std::uint64_t, HISTOGRAM_BUCKETS>, HISTOGRAMS> histograms{};
+        };
+
+        struct TraceEvent {
+            Timer timer;
+            unsigned thread;
+            std::uint64_t begin_ns;
+            std::uint64_t duration_ns;
+        };
+
+        namespace details {
+            /**
+             * \brief statistics of one thread, only the owning thread writes, so relaxed loads and stores suffice.
+             * reset() does not zero the values of other threads, it keeps their values at the reset as baseline
+             * and snapshots count from there.
+             */
+            struct Recorder {
+                std::array<std::atomic<std::uint64_t>, COUNTERS> counters;
+                std::array<std::atomic<std::uint64_t>, TIMERS> timer_ns;
+                std::array<std::atomic<std::uint64_t>, TIMERS> timer_calls;
+                std::array<std::array<std::atomic<std::uint64_t>, HISTOGRAM_BUCKETS>, HISTOGRAMS> histograms;
+                /* values at the last reset(), only touched under the mutex of the registry */
+                Snapshot baseline;
+                std::mutex trace_mutex;
+                std::vector<TraceEvent> trace;
+                unsigned thread;
+
+                Recorder();
+
+                Recorder(const Recorder &) = delete;
+
+                Recorder &operator=(const Recorder &) = delete;
+
+                ~Recorder();
+            };
+
+            inline Recorder &recorder() {
+                thread_local Recorder instance;
+                return instance;
+            }
+
+            inline void bump(std::atomic<std::uint64_t> &value, const std::uint64_t delta) {
+                value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+            }
+
+            extern std::atomic<bool> tracing;
+        }
+
+        inline void add(const Counter counter, const std::uint64_t value) {
+            details::bump(details::recorder().counters[static_cast<int>(counter)], value);
+        }
+
+        inline void record(const Histogram histogram, int bucket) {
+            bucket = bucket < 0 ? 0 : (bucket >= HISTOGRAM_BUCKETS ? HISTOGRAM_BUCKETS - 1 : bucket);
+            details::bump(details::recorder().histograms[static_cast<int>(histogram)][bucket], 1);
+        }
+
+        /**
+         * \brief nanoseconds of a steady clock
+         */
+        std::uint64_t now();
+
+        /**
+         * \brief time of a scope, also a trace event while tracing is on
+         */
+        class Scope {
+        public:
+            explicit Scope(Timer timer);
+
+            Scope(const Scope &) = delete;
+
+            Scope &operator=(const Scope &) = delete;
+
+            ~Scope();
+
+        private:
+            Timer timer_;
+            std::uint64_t begin_;
+        };
+
+        Snapshot snapshot();
+
+        /**
+         * \brief zero the statistics of all threads and drop the trace
+         */
+        void reset();
+
+        /**
+         * \brief collect trace events of the timers, off by default
+         */
+        void set_tracing(bool enabled);
+
+        const char *name(Counter counter);
+        const char *name(Timer timer);
+        const char *name(Histogram histogram);
+
+        /**
+         * \brief counters, timers and histograms as one JSON object
+         */
+        void write_json(std::ostream &out);
+
+        /**
+         * \brief trace events and final counters in the Chrome trace event format, for chrome://tracing or Perfetto
+         */
+        void write_chrome_trace(std::ostream &out);
+    }
+}
+
+#ifdef NUMERICS_STATISTICS
+#define NUMERICS_COUNT(counter, value) \
+    ::dimkashelk::statistics::add(::dimkashelk::statistics::Counter::counter, static_cast<std::uint64_t>(value))
+#define NUMERICS_HISTOGRAM(histogram, bucket) \
+    ::dimkashelk::statistics::record(::dimkashelk::statistics::Histogram::histogram, static_cast<int>(bucket))
+#define NUMERICS_TIMER(timer) \
+    const ::dimkashelk::statistics::Scope numerics_scope_##timer(::dimkashelk::statistics::Timer::timer)
+#else
+#define NUMERICS_COUNT(counter, value) ((void) 0)
+#define NUMERICS_HISTOGRAM(histogram, bucket) ((void) 0)
+#define NUMERICS_TIMER(timer) ((void) 0)
+#endif
+#endif
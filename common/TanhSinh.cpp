@@ -0,0 +1,185 @@
+#include "TanhSinh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "Statistics.h"
+
+namespace {
+    constexpr double HALF_PI = 1.57079632679489661923;
+    /* past this t the abscissae of the finite map reach the ends and the other maps overflow */
+    constexpr double T_MAX = 6.5;
+    constexpr int MAX_LEVEL = 12;
+
+    enum class Map {
+        FINITE,
+        UPPER_INFINITE,
+        LOWER_INFINITE,
+        INFINITE
+    };
+
+    struct Node {
+        double x;
+        double w;
+        bool valid;
+    };
+
+    Node node(const Map map, const double a, const double b, const double t) {
+        const double s = HALF_PI * std::sinh(t);
+        const double ds = HALF_PI * std::cosh(t);
+        Node result{0.0, 0.0, false};
+        switch (map) {
+            case Map::FINITE: {
+                /* d = 1 - |tanh s| without cancellation, sech^2 s = 4 e / (1 + e)^2 */
+                const double half = 0.5 * (b - a);
+                const double e = std::exp(-2.0 * std::fabs(s));
+                const double d = 2.0 * e / (1.0 + e);
+                result.x = t < 0.0 ? a + half * d : b - half * d;
+                result.w = half * ds * 4.0 * e / ((1.0 + e) * (1.0 + e));
+                result.valid = result.x > a && result.x < b && result.w > 0.0;
+                break;
+            }
+            case Map::UPPER_INFINITE:
+            case Map::LOWER_INFINITE: {
+                const double e = std::exp(s);
+                result.x = map == Map::UPPER_INFINITE ? a + e : b - e;
+                result.w = ds * e;
+                result.valid = std::isfinite(result.x) && std::isfinite(result.w) && result.w > 0.0 &&
+                               (map == Map::UPPER_INFINITE ? result.x > a : result.x < b);
+                break;
+            }
+            case Map::INFINITE:
+                result.x = std::sinh(s);
+                result.w = ds * std::cosh(s);
+                result.valid = std::isfinite(result.x) && std::isfinite(result.w);
+                break;
+        }
+        return result;
+    }
+}
+
+dimkashelk::TanhSinh::TanhSinh(const std::function<double(double)> &fun, double a, double b, const double abs_err,
+                               const double rel_err, const int max_fun): result_(0.0),
+                                                                          error_(0.0),
+                                                                          no_fun_(0),
+                                                                          flag_(0.0),
+                                                                          levels_(0) {
+    NUMERICS_TIMER(INTEGRATE);
+    if (std::isnan(a) || std::isnan(b) || abs_err < 0.0 || rel_err < 0.0 || max_fun < 1) {
+        throw std::logic_error("Check parameters of integration");
+    }
+    if (a == b) {
+        return;
+    }
+    double sign = 1.0;
+    if (a > b) {
+        std::swap(a, b);
+        sign = -1.0;
+    }
+    Map map = Map::FINITE;
+    if (std::isinf(a) && std::isinf(b)) {
+        map = Map::INFINITE;
+    } else if (std::isinf(b)) {
+        map = Map::UPPER_INFINITE;
+    } else if (std::isinf(a)) {
+        map = Map::LOWER_INFINITE;
+    }
+    const double EPSILON = std::numeric_limits<double>::epsilon();
+    auto term = [&](const double t, bool &valid) {
+        const Node n = node(map, a, b, t);
+        valid = n.valid;
+        if (!n.valid) {
+            return 0.0;
+        }
+        no_fun_++;
+        NUMERICS_COUNT(INTEGRAND_CALLS, 1);
+        return n.w * fun(n.x);
+    };
+
+    /* level 0, step 1: walk out in both directions until the terms are negligible,
+       this fixes the range of t used by the finer levels */
+    bool valid = true;
+    double sum = term(0.0, valid);
+    double range[2] = {0.0, 0.0};
+    for (int side = 0; side < 2; side++) {
+        const double direction = side == 0 ? -1.0 : 1.0;
+        for (double t = 1.0; t <= T_MAX; t += 1.0) {
+            const double value = term(direction * t, valid);
+            if (!valid) {
+                break;
+            }
+            sum += value;
+            range[side] = t;
+            if (std::fabs(value) <= EPSILON * std::fabs(sum)) {
+                break;
+            }
+        }
+    }
+    /* the finer levels may reach up to one coarse step further */
+    for (double &r: range) {
+        r = std::min(r + 1.0, T_MAX);
+    }
+
+    double h = 1.0;
+    double previous = h * sum;
+    double result = previous;
+    double error = std::numeric_limits<double>::infinity();
+    double difference = 0.0;
+    for (int level = 1; level <= MAX_LEVEL; level++) {
+        h *= 0.5;
+        if (level > 1 && no_fun_ + (range[0] + range[1]) / (2.0 * h) > max_fun) {
+            break;
+        }
+        for (int side = 0; side < 2; side++) {
+            const double direction = side == 0 ? -1.0 : 1.0;
+            for (double t = h; t <= range[side]; t += 2.0 * h) {
+                const double value = term(direction * t, valid);
+                if (valid) {
+                    sum += value;
+                }
+            }
+        }
+        result = h * sum;
+        /* the number of correct digits doubles per level once the rule converges,
+           then the error of result is about the square of the last difference relative to the one before */
+        const double next = std::fabs(result - previous);
+        error = level > 1 && next < 0.1 * difference ? next * next / difference : next;
+        error = std::max(error, 10.0 * EPSILON * std::fabs(result));
+        difference = next;
+        previous = result;
+        levels_ = level;
+        if (error <= std::max(abs_err, rel_err * std::fabs(result))) {
+            break;
+        }
+    }
+    const double tolerance = std::max(abs_err, rel_err * std::fabs(result));
+    if (!std::isfinite(result)) {
+        flag_ = 1.0;
+    } else if (error > tolerance) {
+        flag_ = tolerance > 0.0 ? std::max(1.0, error / tolerance) : 1.0;
+    }
+    result_ = sign * result;
+    error_ = error;
+}
+
+double dimkashelk::TanhSinh::getResult() const {
+    return result_;
+}
+
+double dimkashelk::TanhSinh::getError() const {
+    return error_;
+}
+
+int dimkashelk::TanhSinh::getNoFun() const {
+    return no_fun_;
+}
+
+double dimkashelk::TanhSinh::getFlag() const {
+    return flag_;
+}
+
+int dimkashelk::TanhSinh::getLevels() const {
+    return levels_;
+}
@@ -0,0 +1,52 @@
+#ifndef TANH_SINH_H
+#define TANH_SINH_H
+#include <functional>
+
+namespace dimkashelk {
+    /**
+     * \brief double exponential integration: the trapezoidal rule after a change of variables whose
+     * derivative decays double exponentially, the step is halved until two levels agree.
+     *
+     * [a, b] uses x = tanh(pi / 2 sinh t), the abscissae crowd to the ends, so endpoint singularities,
+     * also non-integrable looking ones like log or inverse square roots, converge as fast as smooth
+     * integrands. [a, inf) and (-inf, b] use x = a + exp(pi / 2 sinh t), (-inf, inf) x = sinh(pi / 2 sinh t).
+     * Points closer to an end than rounding allows are dropped. Interior singularities must be split off
+     * by the caller. Same interface as Quanc8.
+     */
+    class TanhSinh {
+    public:
+        /**
+         * \brief
+         * \param fun user functions with one double argument
+         * \param a lower bound of integration, may be -infinity
+         * \param b upper bound of integration, may be +infinity
+         * \param abs_err absolute error
+         * \param rel_err relative error
+         * \param max_fun limit on the number of evaluations of fun
+         */
+        TanhSinh(const std::function<double (double)> &fun, double a, double b, double abs_err, double rel_err,
+                 int max_fun = 5000);
+        [[nodiscard]] double getResult() const;
+        /**
+         * \brief estimate from the differences of the last levels
+         */
+        [[nodiscard]] double getError() const;
+        [[nodiscard]] int getNoFun() const;
+        /**
+         * \brief 0 for a reliable result, otherwise getError() divided by the requested error
+         */
+        [[nodiscard]] double getFlag() const;
+        /**
+         * \brief number of halvings of the step, the step is 2^-levels
+         */
+        [[nodiscard]] int getLevels() const;
+
+    private:
+        double result_;
+        double error_;
+        int no_fun_;
+        double flag_;
+        int levels_;
+    };
+}
+#endif
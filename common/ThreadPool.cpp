@@ -0,0 +1,116 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+dimkashelk::ThreadPool::ThreadPool(unsigned threads): task_(nullptr),
+    count_(0),
+    next_(0),
+    active_(0),
+    generation_(0),
+    stop_(false),
+    error_(nullptr)
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(threads - 1);
+    try {
+        for (unsigned i = 1; i < threads; i++) {
+            workers_.emplace_back(&ThreadPool::work, this);
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto &worker: workers_) {
+            worker.join();
+        }
+        throw;
+    }
+}
+
+void dimkashelk::ThreadPool::run(const int count, const std::function<void(int)> &task) {
+    if (count <= 0) {
+        return;
+    }
+    if (workers_.empty() || count == 1) {
+        for (int i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = std::addressof(task);
+        count_ = count;
+        next_ = 0;
+        active_ = static_cast<unsigned>(workers_.size());
+        error_ = nullptr;
+        generation_++;
+    }
+    start_.notify_all();
+    execute();
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return active_ == 0; });
+        task_ = nullptr;
+        error = error_;
+        error_ = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+unsigned dimkashelk::ThreadPool::get_threads() const {
+    return static_cast<unsigned>(workers_.size()) + 1;
+}
+
+dimkashelk::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_.notify_all();
+    for (auto &worker: workers_) {
+        worker.join();
+    }
+}
+
+void dimkashelk::ThreadPool::work() {
+    unsigned long seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_.wait(lock, [this, seen] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+        }
+        execute();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            active_--;
+            if (active_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+}
+
+void dimkashelk::ThreadPool::execute() {
+    for (int i = next_.fetch_add(1); i < count_; i = next_.fetch_add(1)) {
+        try {
+            (*task_)(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dimkashelk {
+    class ThreadPool {
+    public:
+        /**
+         * \brief
+         * \param threads number of threads including the calling one, 0 means all hardware threads
+         */
+        explicit ThreadPool(unsigned threads);
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /**
+         * \brief run task(0) ... task(count - 1) and wait for all of them,
+         * free threads take the next index, so uneven tasks are balanced.
+         * Must not be called from inside a task.
+         * \param count number of tasks
+         * \param task user function with index of the task
+         */
+        void run(int count, const std::function<void(int)> &task);
+
+        [[nodiscard]] unsigned get_threads() const;
+
+        ~ThreadPool();
+
+    private:
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable start_;
+        std::condition_variable done_;
+        const std::function<void(int)> *task_;
+        int count_;
+        std::atomic<int> next_;
+        unsigned active_;
+        unsigned long generation_;
+        bool stop_;
+        std::exception_ptr error_;
+
+        void work();
+        void execute();
+    };
+}
+#endif
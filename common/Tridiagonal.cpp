@@ -0,0 +1,102 @@
+#include "Tridiagonal.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace {
+    void thomas(const int n, const double lower[], double diag[], const double upper[], double rhs[]) {
+        for (int i = 1; i < n; i++) {
+            const double current = lower[i - 1] / diag[i - 1];
+            diag[i] = diag[i] - current * upper[i - 1];
+            rhs[i] = rhs[i] - current * rhs[i - 1];
+        }
+        rhs[n - 1] = rhs[n - 1] / diag[n - 1];
+        for (int i = n - 2; i >= 0; i--) {
+            rhs[i] = (rhs[i] - upper[i] * rhs[i + 1]) / diag[i];
+        }
+    }
+
+    /**
+     * \brief rows [s, e) of one block, solution y in rhs and spikes v, w for the separators s - 1 and e
+     */
+    void eliminate_block(const int s, const int e, const bool left, const bool right, const double lower[],
+                         double diag[], const double upper[], double rhs[], double v[], double w[]) {
+        v[s] = left ? -lower[s - 1] : 0.0;
+        w[s] = 0.0;
+        for (int i = s + 1; i < e; i++) {
+            const double current = lower[i - 1] / diag[i - 1];
+            diag[i] = diag[i] - current * upper[i - 1];
+            rhs[i] = rhs[i] - current * rhs[i - 1];
+            v[i] = -current * v[i - 1];
+            w[i] = 0.0;
+        }
+        if (right) {
+            w[e - 1] = -upper[e - 1];
+        }
+        rhs[e - 1] = rhs[e - 1] / diag[e - 1];
+        v[e - 1] = v[e - 1] / diag[e - 1];
+        w[e - 1] = w[e - 1] / diag[e - 1];
+        for (int i = e - 2; i >= s; i--) {
+            rhs[i] = (rhs[i] - upper[i] * rhs[i + 1]) / diag[i];
+            v[i] = (v[i] - upper[i] * v[i + 1]) / diag[i];
+            w[i] = (w[i] - upper[i] * w[i + 1]) / diag[i];
+        }
+    }
+}
+
+void dimkashelk::details::tridiagonal(const int n, const double lower[], double diag[], const double upper[],
+                                      double rhs[], ThreadPool *pool) {
+    if (n < 1) {
+        return;
+    }
+    int blocks = 1;
+    if (pool != nullptr) {
+        blocks = std::min(static_cast<int>(pool->get_threads()), n / TRIDIAGONAL_BLOCK);
+    }
+    if (blocks < 2) {
+        thomas(n, lower, diag, upper, rhs);
+        return;
+    }
+
+    /* block k holds rows [start[k], start[k + 1] - 1), the row start[k + 1] - 1 is the separator k */
+    std::vector<int> start(blocks + 1);
+    for (int k = 0; k <= blocks; k++) {
+        start[k] = static_cast<int>(static_cast<long long>(n + 1) * k / blocks);
+    }
+    std::vector<double> v(n);
+    std::vector<double> w(n);
+    pool->run(blocks, [&](const int k) {
+        eliminate_block(start[k], start[k + 1] - 1, k > 0, k + 1 < blocks, lower, diag, upper, rhs, v.data(),
+                        w.data());
+    });
+
+    /* separator j couples the last row of block j and the first row of block j + 1 */
+    const int separators = blocks - 1;
+    std::vector<double> sub(separators);
+    std::vector<double> main(separators);
+    std::vector<double> super(separators);
+    std::vector<double> z(separators);
+    for (int j = 0; j < separators; j++) {
+        const int r = start[j + 1] - 1;
+        const int last = r - 1;
+        const int first = r + 1;
+        sub[j] = lower[r - 1] * v[last];
+        main[j] = diag[r] + lower[r - 1] * w[last] + upper[r] * v[first];
+        super[j] = upper[r] * w[first];
+        z[j] = rhs[r] - lower[r - 1] * rhs[last] - upper[r] * rhs[first];
+    }
+    thomas(separators, sub.data() + 1, main.data(), super.data(), z.data());
+    for (int j = 0; j < separators; j++) {
+        rhs[start[j + 1] - 1] = z[j];
+    }
+
+    pool->run(blocks, [&](const int k) {
+        const double left = (k > 0) ? z[k - 1] : 0.0;
+        const double right = (k + 1 < blocks) ? z[k] : 0.0;
+        for (int i = start[k]; i < start[k + 1] - 1; i++) {
+            rhs[i] += v[i] * left + w[i] * right;
+        }
+    });
+}
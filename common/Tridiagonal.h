@@ -0,0 +1,34 @@
+#ifndef TRIDIAGONAL_H
+#define TRIDIAGONAL_H
+
+namespace dimkashelk {
+    class ThreadPool;
+
+    namespace details {
+        /**
+         * \brief smallest number of rows per block of the partitioned solve
+         */
+        constexpr int TRIDIAGONAL_BLOCK = 4096;
+
+        /**
+         * \brief solve a tridiagonal system by elimination without pivoting,
+         * row i reads lower[i - 1] x[i - 1] + diag[i] x[i] + upper[i] x[i + 1] = rhs[i].
+         *
+         * Without a pool, or for fewer than two blocks of TRIDIAGONAL_BLOCK rows, this is the serial Thomas sweep.
+         * Otherwise the rows are split into one block per thread, joined by single separator rows. Every block is
+         * eliminated concurrently with two extra right hand sides giving its dependence on the neighbouring
+         * separators, the small system of the separators is solved serially and the blocks are then
+         * completed concurrently. The matrix must be safe for elimination without pivoting,
+         * e.g. diagonally dominant.
+         * \param n order of the system
+         * \param lower subdiagonal, A(i + 1, i), of size n - 1
+         * \param diag diagonal, overwritten
+         * \param upper superdiagonal, A(i, i + 1), of size n - 1
+         * \param rhs right hand side, overwritten by the solution
+         * \param pool threads for the blocks, nullptr for the serial sweep
+         */
+        void tridiagonal(int n, const double lower[], double diag[], const double upper[], double rhs[],
+                         ThreadPool *pool = nullptr);
+    }
+}
+#endif
@@ -0,0 +1,423 @@
+#ifndef VECTOR_MATH_H
+#define VECTOR_MATH_H
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace dimkashelk {
+    namespace details {
+        /* 1.5 * 2^52, adding it rounds a double of magnitude below 2^51 to an integer
+           and leaves the integer in the low bits of the sum */
+        constexpr double ROUNDING_SHIFT = 6755399441055744.0;
+        constexpr double LOG2E = 1.44269504088896338700;
+        /* ln 2 and pi / 2 split so that their leading parts times small integers are exact */
+        constexpr double LN2_HI = 6.93147180369123816490e-01;
+        constexpr double LN2_LO = 1.90821492927058770002e-10;
+        constexpr double PIO2_1 = 1.57079632673412561417e+00;
+        constexpr double PIO2_2 = 6.07710050630396597660e-11;
+        constexpr double PIO2_3 = 2.02226624879595063154e-21;
+        constexpr double TWO_OVER_PI = 6.36619772367581382433e-01;
+        /* beyond this the reduction by three parts of pi / 2 loses accuracy, std::sin is used instead */
+        constexpr double TRIG_LIMIT = 1.0e5;
+        /* exp(x) is 0 below and infinity above, the kernel forms both without a select */
+        constexpr double EXP_LOWER = -746.0;
+        constexpr double EXP_UPPER = 710.0;
+        /* elements per block of the array functions, their scratch stays on the stack */
+        constexpr std::size_t VECTOR_BLOCK = 64;
+
+        inline std::uint64_t to_bits(const double x) {
+            std::uint64_t bits;
+            std::memcpy(&bits, &x, sizeof(bits));
+            return bits;
+        }
+
+        inline double from_bits(const std::uint64_t bits) {
+            double x;
+            std::memcpy(&x, &bits, sizeof(x));
+            return x;
+        }
+
+        /* a loop that only stores the clamp is vectorized, in a longer loop the compiler
+           specializes the code after the selects for the bounds and keeps the branches */
+        inline double clamp(const double x, const double lower, const double upper) {
+            const double y = x < lower ? lower : x;
+            return y > upper ? upper : y;
+        }
+
+        /* 2^n for an integral n in [-1022, 1023], from the integer in the low bits of n + ROUNDING_SHIFT */
+        inline double power_of_two(const double n) {
+            return from_bits((to_bits(n + ROUNDING_SHIFT) + 1023) << 52);
+        }
+
+        /* a * b = p + e exactly, Dekker's product without fma */
+        inline void two_product(const double a, const double b, double &p, double &e) {
+            constexpr double SPLIT = 134217729.0;
+            p = a * b;
+            const double ca = SPLIT * a;
+            const double ah = ca - (ca - a);
+            const double al = a - ah;
+            const double cb = SPLIT * b;
+            const double bh = cb - (cb - b);
+            const double bl = b - bh;
+            e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+        }
+
+        /*
+         * exp(x + tail) for x in [EXP_LOWER, EXP_UPPER], tail much smaller than ulp(x). The result
+         * overflows to infinity and underflows to subnormals and 0 by itself, a NaN x gives NaN.
+         */
+        inline double exp_kernel(const double x, const double tail) {
+            const double n = (x * LOG2E + ROUNDING_SHIFT) - ROUNDING_SHIFT;
+            /* r = r_hi + r_lo, the leading part is exact */
+            const double r_hi = x - n * LN2_HI;
+            const double r_lo = tail - n * LN2_LO;
+            const double r = r_hi + r_lo;
+            /* exp(r) - 1 - r by the Taylor series to r^13 / 13!, |r| <= ln 2 / 2 */
+            double p = 1.0 / 6227020800.0;
+            p = p * r + 1.0 / 479001600.0;
+            p = p * r + 1.0 / 39916800.0;
+            p = p * r + 1.0 / 3628800.0;
+            p = p * r + 1.0 / 362880.0;
+            p = p * r + 1.0 / 40320.0;
+            p = p * r + 1.0 / 5040.0;
+            p = p * r + 1.0 / 720.0;
+            p = p * r + 1.0 / 120.0;
+            p = p * r + 1.0 / 24.0;
+            p = p * r + 1.0 / 6.0;
+            p = p * r + 0.5;
+            /* 1 + r_hi is summed without error, everything else is added once */
+            const double sum = 1.0 + r_hi;
+            const double error = (1.0 - sum) + r_hi;
+            const double y = sum + (error + (r_lo + r * r * p));
+            /* 2^n in two factors, so results down to the subnormals and up to infinity are formed */
+            const double n1 = (n * 0.5 + ROUNDING_SHIFT) - ROUNDING_SHIFT;
+            return y * power_of_two(n1) * power_of_two(n - n1);
+        }
+
+        /* x = m * 2^e, m in [sqrt(2) / 2, sqrt(2)), found relative to the bits of sqrt(2) / 2,
+           e is read from the shifted exponent field as a double */
+        inline double log_decompose(const double x, double &e) {
+            constexpr std::uint64_t SQRT_HALF = 0x3fe6a09e667f3bcdULL;
+            constexpr std::uint64_t EXPONENT_BIAS = 2048ULL << 52;
+            const std::uint64_t bits = to_bits(x);
+            const std::uint64_t offset = bits - SQRT_HALF;
+            const double biased = from_bits(0x4330000000000000ULL | ((offset + EXPONENT_BIAS) >> 52));
+            e = (biased - 4503599627370496.0) - 2048.0;
+            return from_bits(bits - (offset & 0xfff0000000000000ULL));
+        }
+
+        /* log(x) for a normal positive finite x by the formula and coefficients of fdlibm */
+        inline double log_kernel(const double x) {
+            double e;
+            const double f = log_decompose(x, e) - 1.0;
+            const double hfsq = 0.5 * f * f;
+            const double s = f / (2.0 + f);
+            const double z = s * s;
+            const double w = z * z;
+            const double t1 = w * (3.999999999940941908e-01 + w * (2.222219843214978396e-01 +
+                              w * 1.531383769920937332e-01));
+            const double t2 = z * (6.666666666666735130e-01 + w * (2.857142874366239149e-01 +
+                              w * (1.818357216161805012e-01 + w * 1.479819860511658591e-01)));
+            return e * LN2_HI - ((hfsq - (s * (hfsq + t1 + t2) + e * LN2_LO)) - f);
+        }
+
+        /* a + b = sum + error exactly, Knuth's two-sum */
+        inline void two_sum(const double a, const double b, double &sum, double &error) {
+            sum = a + b;
+            const double bb = sum - a;
+            error = (a - (sum - bb)) + (b - bb);
+        }
+
+        /* a + b = sum + error exactly for |a| >= |b|, Dekker's fast two-sum */
+        inline void fast_two_sum(const double a, const double b, double &sum, double &error) {
+            sum = a + b;
+            error = b - (sum - a);
+        }
+
+        /*
+         * log(x) = hi + lo for a normal positive finite x, the pair is accurate to about 2^-70 absolute,
+         * so the exponent p log(x) of pow keeps that accuracy up to the overflow bound |p log(x)| ~ 745.
+         * Other arguments give garbage and are handled by the caller.
+         */
+        inline void log_pair_kernel(const double x, double &hi, double &lo) {
+            constexpr double TWO_THIRDS_HI = 6.66666666666666629659e-01;
+            constexpr double TWO_THIRDS_LO = 3.70074341541718826265e-17;
+            constexpr double TWO_FIFTHS_HI = 4.00000000000000022204e-01;
+            constexpr double TWO_FIFTHS_LO = -2.22044604925031320411e-17;
+            double e;
+            const double m = log_decompose(x, e);
+            /* log m = log1p(f) = 2 atanh(S), S = f / (2 + f) carried as s + s_lo */
+            const double f = m - 1.0;
+            const double d = 2.0 + f;
+            const double d_lo = (2.0 - d) + f;
+            const double rd = 1.0 / d;
+            const double s = f * rd;
+            double p, pe;
+            two_product(s, d, p, pe);
+            const double s_lo = (((f - p) - pe) - s * d_lo) * rd;
+            /* u = S^2 = z + u_lo */
+            double z, z_lo;
+            two_product(s, s, z, z_lo);
+            const double u_lo = z_lo + 2.0 * s * s_lo;
+            /* 2 atanh(S) - 2 S = S u c(u), c = 2/3 + 2/5 u + u^2 q(u), q to u^10 (S^27) in double,
+               |S| <= 0.172 and the first term left out is below 2^-77 */
+            double q = 2.0 / 27.0;
+            q = q * z + 2.0 / 25.0;
+            q = q * z + 2.0 / 23.0;
+            q = q * z + 2.0 / 21.0;
+            q = q * z + 2.0 / 19.0;
+            q = q * z + 2.0 / 17.0;
+            q = q * z + 2.0 / 15.0;
+            q = q * z + 2.0 / 13.0;
+            q = q * z + 2.0 / 11.0;
+            q = q * z + 2.0 / 9.0;
+            q = q * z + 2.0 / 7.0;
+            /* the two leading terms of c and the products S u c in double-double */
+            double b, b_lo;
+            two_product(TWO_FIFTHS_HI, z, b, b_lo);
+            b_lo += TWO_FIFTHS_LO * z + TWO_FIFTHS_HI * u_lo;
+            double c, c_lo;
+            fast_two_sum(TWO_THIRDS_HI, b, c, c_lo);
+            c_lo += TWO_THIRDS_LO + b_lo + z * z * q;
+            double su, su_lo;
+            two_product(s, z, su, su_lo);
+            su_lo += s * u_lo + s_lo * z;
+            double w, w_lo;
+            two_product(su, c, w, w_lo);
+            w_lo += su * c_lo + su_lo * c;
+            /* e ln2_hi + 2 s + w is summed without error, |e ln2_hi + 2 s| >= |w|, the rest is small */
+            double sum, error, total, total_error;
+            two_sum(e * LN2_HI, 2.0 * s, sum, error);
+            fast_two_sum(sum, w, total, total_error);
+            const double rest = (error + total_error) + (e * LN2_LO + (2.0 * s_lo + w_lo));
+            hi = total + rest;
+            lo = rest - (hi - total);
+        }
+
+        inline bool is_log_regular(const double x) {
+            return x >= std::numeric_limits<double>::min() && x <= std::numeric_limits<double>::max();
+        }
+
+        /* log of an argument the kernel does not take */
+        inline double log_special(const double x) {
+            if (x > 0.0 && x < std::numeric_limits<double>::min()) {
+                return log_kernel(x * 18014398509481984.0) - 54.0 * LN2_HI - 54.0 * LN2_LO;
+            }
+            return std::log(x);
+        }
+
+        /* p log|x| = head + tail, the start of |x|^p = exp(p log|x|) */
+        inline void pow_exponent(const double x, const double p, double &head, double &tail) {
+            double hi, lo, e;
+            log_pair_kernel(std::fabs(x), hi, lo);
+            two_product(p, hi, head, e);
+            tail = e + p * lo;
+        }
+
+        /* arguments pow_exponent() does not take: x <= 0, subnormal or not finite, and a p
+           so large that Dekker's split overflows */
+        inline bool is_pow_regular(const double x, const double p) {
+            return is_log_regular(x) && std::fabs(p) <= 1.0e300;
+        }
+
+        inline std::uint64_t select_bits(const std::uint64_t mask, const std::uint64_t a, const std::uint64_t b) {
+            return (a & mask) | (b & ~mask);
+        }
+
+        /* x = n pi / 2 + r + tail, |r| <= pi / 4, for |x| <= TRIG_LIMIT, as the medium case of fdlibm.
+           n is returned in the low bits of quadrant. */
+        inline double reduce_half_pi(const double x, std::uint64_t &quadrant, double &tail) {
+            const double shifted = x * TWO_OVER_PI + ROUNDING_SHIFT;
+            const double k = shifted - ROUNDING_SHIFT;
+            quadrant = to_bits(shifted);
+            const double t = x - k * PIO2_1;
+            const double w = k * PIO2_2;
+            const double r = t - w;
+            tail = ((t - r) - w) - k * PIO2_3;
+            return r;
+        }
+
+        /* sin and cos of r + tail on [-pi / 4, pi / 4] with the coefficients of fdlibm */
+        inline double sin_kernel(const double r, const double tail) {
+            const double z = r * r;
+            const double v = z * r;
+            const double p = 8.33333333332248946124e-03 + z * (-1.98412698298579493134e-04 +
+                             z * (2.75573137070700676789e-06 + z * (-2.50507602534068634195e-08 +
+                             z * 1.58969099521155010221e-10)));
+            return r - ((z * (0.5 * tail - v * p) - tail) - v * -1.66666666666666324348e-01);
+        }
+
+        inline double cos_kernel(const double r, const double tail) {
+            const double z = r * r;
+            const double p = 4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 +
+                             z * (2.48015872894767294178e-05 + z * (-2.75573143513906633035e-07 +
+                             z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11))));
+            const double hz = 0.5 * z;
+            const double w = 1.0 - hz;
+            return w + (((1.0 - w) - hz) + (z * z * p - r * tail));
+        }
+
+        /*
+         * sin(x) for cos_shift = 0 and cos(x) for cos_shift = 1, |x| <= TRIG_LIMIT. The quadrant
+         * picks the kernel and the sign with bit masks, there are no branches and no selects.
+         */
+        inline double sin_cos_kernel(const double x, const std::uint64_t cos_shift) {
+            std::uint64_t quadrant;
+            double tail;
+            const double r = reduce_half_pi(x, quadrant, tail);
+            quadrant += cos_shift;
+            const std::uint64_t s = to_bits(sin_kernel(r, tail));
+            const std::uint64_t c = to_bits(cos_kernel(r, tail));
+            const std::uint64_t odd = 0 - (quadrant & 1);
+            const std::uint64_t sign = (quadrant & 2) << 62;
+            return from_bits(select_bits(odd, c, s) ^ sign);
+        }
+
+        /* tan(x) = sin / cos for an even and -cos / sin for an odd quadrant */
+        inline double tan_kernel(const double x) {
+            std::uint64_t quadrant;
+            double tail;
+            const double r = reduce_half_pi(x, quadrant, tail);
+            const std::uint64_t s = to_bits(sin_kernel(r, tail));
+            const std::uint64_t c = to_bits(cos_kernel(r, tail));
+            const std::uint64_t odd = 0 - (quadrant & 1);
+            const double numerator = from_bits(select_bits(odd, c, s) ^ (odd & 0x8000000000000000ULL));
+            return numerator / from_bits(select_bits(odd, s, c));
+        }
+    }
+
+    /*
+     * Elementary functions over arrays. They work in blocks of details::VECTOR_BLOCK elements, a stage
+     * of a block is a loop of plain arithmetic, bit operations or min and max, which the compiler
+     * vectorizes like the lane loops of BatchDecomp, arguments the kernels do not take are redone by a
+     * scalar pass at the end of the block. count has the sizes of the batch integrands of BatchQuanc8,
+     * of the ENSEMBLE_LANES blocks of Ensemble45 and of Spline::evaluate, results do not depend on the
+     * position of an element. x and y may be the same array. The bounds are the largest errors found
+     * against long double libm on 2 * 10^6 random arguments per range.
+     */
+
+    /**
+     * \brief y[i] = exp(x[i]), below 0.8 ulp, overflow gives infinity and underflow subnormals and 0
+     */
+    inline void vector_exp(const double x[], const std::size_t count, double y[]) {
+        double t[details::VECTOR_BLOCK];
+        for (std::size_t first = 0; first < count; first += details::VECTOR_BLOCK) {
+            const std::size_t m = std::min(count - first, details::VECTOR_BLOCK);
+            for (std::size_t i = 0; i < m; i++) t[i] = details::clamp(x[first + i], details::EXP_LOWER, details::EXP_UPPER);
+            for (std::size_t i = 0; i < m; i++) y[first + i] = details::exp_kernel(t[i], 0.0);
+        }
+    }
+
+    /**
+     * \brief y[i] = log(x[i]), below 0.9 ulp, special arguments as std::log
+     */
+    inline void vector_log(const double x[], const std::size_t count, double y[]) {
+        double t[details::VECTOR_BLOCK];
+        for (std::size_t first = 0; first < count; first += details::VECTOR_BLOCK) {
+            const std::size_t m = std::min(count - first, details::VECTOR_BLOCK);
+            for (std::size_t i = 0; i < m; i++) t[i] = details::log_kernel(x[first + i]);
+            for (std::size_t i = 0; i < m; i++) {
+                const double v = x[first + i];
+                y[first + i] = details::is_log_regular(v) ? t[i] : details::log_special(v);
+            }
+        }
+    }
+
+    /**
+     * \brief y[i] = x[i]^p[i], below 0.8 ulp for a positive normal x[i] and a normal result, other arguments go to std::pow
+     */
+    inline void vector_pow(const double x[], const double p[], const std::size_t count, double y[]) {
+        double head[details::VECTOR_BLOCK], tail[details::VECTOR_BLOCK];
+        for (std::size_t first = 0; first < count; first += details::VECTOR_BLOCK) {
+            const std::size_t m = std::min(count - first, details::VECTOR_BLOCK);
+            /* p log|x| = head + tail, both are clamped, a clamped head stays out of the range of exp */
+            for (std::size_t i = 0; i < m; i++) details::pow_exponent(x[first + i], p[first + i], head[i], tail[i]);
+            for (std::size_t i = 0; i < m; i++) {
+                head[i] = details::clamp(head[i], details::EXP_LOWER, details::EXP_UPPER);
+                tail[i] = details::clamp(tail[i], -0.1, 0.1);
+            }
+            for (std::size_t i = 0; i < m; i++) head[i] = details::exp_kernel(head[i], tail[i]);
+            for (std::size_t i = 0; i < m; i++) {
+                const double v = x[first + i];
+                const double e = p[first + i];
+                y[first + i] = details::is_pow_regular(v, e) ? head[i] : std::pow(v, e);
+            }
+        }
+    }
+
+    /**
+     * \brief y[i] = x[i]^p, as the overload with an exponent per element
+     */
+    inline void vector_pow(const double x[], const double p, const std::size_t count, double y[]) {
+        double exponent[details::VECTOR_BLOCK];
+        std::fill(exponent, exponent + details::VECTOR_BLOCK, p);
+        for (std::size_t first = 0; first < count; first += details::VECTOR_BLOCK) {
+            vector_pow(x + first, exponent, std::min(count - first, details::VECTOR_BLOCK), y + first);
+        }
+    }
+
+    /**
+     * \brief y[i] = sin(x[i]), below 0.9 ulp for |x| <= details::TRIG_LIMIT, larger |x| go to std::sin
+     */
+    inline void vector_sin(const double x[], const std::size_t count, double y[]) {
+        double t[details::VECTOR_BLOCK];
+        for (std::size_t first = 0; first < count; first += details::VECTOR_BLOCK) {
+            const std::size_t m = std::min(count - first, details::VECTOR_BLOCK);
+            for (std::size_t i = 0; i < m; i++) t[i] = details::sin_cos_kernel(x[first + i], 0);
+            for (std::size_t i = 0; i < m; i++) {
+                const double v = x[first + i];
+                y[first + i] = std::fabs(v) <= details::TRIG_LIMIT ? t[i] : std::sin(v);
+            }
+        }
+    }
+
+    /**
+     * \brief y[i] = cos(x[i]), as vector_sin()
+     */
+    inline void vector_cos(const double x[], const std::size_t count, double y[]) {
+        double t[details::VECTOR_BLOCK];
+        for (std::size_t first = 0; first < count; first += details::VECTOR_BLOCK) {
+            const std::size_t m = std::min(count - first, details::VECTOR_BLOCK);
+            for (std::size_t i = 0; i < m; i++) t[i] = details::sin_cos_kernel(x[first + i], 1);
+            for (std::size_t i = 0; i < m; i++) {
+                const double v = x[first + i];
+                y[first + i] = std::fabs(v) <= details::TRIG_LIMIT ? t[i] : std::cos(v);
+            }
+        }
+    }
+
+    /**
+     * \brief y[i] = tan(x[i]), a quotient of the kernels of sin and cos, below 2.5 ulp
+     * for |x| <= details::TRIG_LIMIT, larger |x| go to std::tan
+     */
+    inline void vector_tan(const double x[], const std::size_t count, double y[]) {
+        double t[details::VECTOR_BLOCK];
+        for (std::size_t first = 0; first < count; first += details::VECTOR_BLOCK) {
+            const std::size_t m = std::min(count - first, details::VECTOR_BLOCK);
+            for (std::size_t i = 0; i < m; i++) t[i] = details::tan_kernel(x[first + i]);
+            for (std::size_t i = 0; i < m; i++) {
+                const double v = x[first + i];
+                y[first + i] = std::fabs(v) <= details::TRIG_LIMIT ? t[i] : std::tan(v);
+            }
+        }
+    }
+
+    /**
+     * \brief y[i] = sqrt(x[i]), correctly rounded by the hardware instruction. The loop stays scalar
+     * unless errno is off (-fno-math-errno), std::sqrt must set it for negative arguments.
+     */
+    inline void vector_sqrt(const double x[], const std::size_t count, double y[]) {
+        for (std::size_t i = 0; i < count; i++) y[i] = std::sqrt(x[i]);
+    }
+
+    /**
+     * \brief y[i] = 1 / sqrt(x[i]), below 1.5 ulp, vectorized as vector_sqrt()
+     */
+    inline void vector_rsqrt(const double x[], const std::size_t count, double y[]) {
+        for (std::size_t i = 0; i < count; i++) y[i] = 1.0 / std::sqrt(x[i]);
+    }
+}
+#endif
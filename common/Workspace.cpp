@@ -0,0 +1,102 @@
+#include "Workspace.h"
+
+#include <new>
+#include <stdexcept>
+
+#include "Statistics.h"
+
+namespace {
+    std::byte *allocate_block(const std::size_t size) {
+        NUMERICS_COUNT(BYTES_ALLOCATED, size);
+        return static_cast<std::byte *>(::operator new(size, std::align_val_t(dimkashelk::Workspace::ALIGNMENT)));
+    }
+
+    void free_block(std::byte *block) {
+        ::operator delete(block, std::align_val_t(dimkashelk::Workspace::ALIGNMENT));
+    }
+}
+
+dimkashelk::Workspace::Scope::Scope(Workspace &workspace): workspace_(workspace),
+                                                           used_(workspace.used_),
+                                                           blocks_(workspace.blocks_.size()) {
+}
+
+dimkashelk::Workspace::Scope::~Scope() {
+    workspace_.release(used_, blocks_);
+}
+
+dimkashelk::Workspace::Workspace(const std::size_t capacity): data_(nullptr),
+                                                              capacity_(0),
+                                                              used_(0),
+                                                              peak_(0) {
+    reserve(capacity);
+}
+
+void dimkashelk::Workspace::reserve(const std::size_t capacity) {
+    if (used_ != 0) {
+        throw std::logic_error("Check workspace, it is in use");
+    }
+    if (capacity <= capacity_) {
+        return;
+    }
+    std::byte *data = allocate_block(bytes<std::byte>(capacity));
+    if (data_ != nullptr) {
+        free_block(data_);
+    }
+    data_ = data;
+    capacity_ = bytes<std::byte>(capacity);
+}
+
+void *dimkashelk::Workspace::allocate_bytes(const std::size_t size) {
+    if (used_ == 0 && peak_ > capacity_) {
+        /* the growth that release() leaves behind, so that a Scope never allocates when it ends */
+        reserve(peak_);
+    }
+    void *result;
+    if (used_ + size <= capacity_) {
+        result = data_ + used_;
+    } else {
+        /* the arena does not move while in use, the overflow goes to a block of its own */
+        blocks_.push_back(allocate_block(size == 0 ? ALIGNMENT : size));
+        result = blocks_.back();
+    }
+    used_ += size;
+    if (used_ > peak_) {
+        peak_ = used_;
+    }
+    return result;
+}
+
+void dimkashelk::Workspace::release(const std::size_t used, const std::size_t blocks) noexcept {
+    while (blocks_.size() > blocks) {
+        free_block(blocks_.back());
+        blocks_.pop_back();
+    }
+    used_ = used;
+}
+
+std::size_t dimkashelk::Workspace::get_capacity() const {
+    return capacity_;
+}
+
+std::size_t dimkashelk::Workspace::get_used() const {
+    return used_;
+}
+
+std::size_t dimkashelk::Workspace::get_peak() const {
+    return peak_;
+}
+
+dimkashelk::Workspace::~Workspace() {
+    for (std::byte *block: blocks_) {
+        free_block(block);
+    }
+    if (data_ != nullptr) {
+        free_block(data_);
+    }
+}
+
+dimkashelk::Workspace &dimkashelk::thread_workspace() {
+    thread_local Workspace workspace;
+    return workspace;
+}
@@ -0,0 +1,96 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+#include <cstddef>
+#include <vector>
+
+namespace dimkashelk {
+    /**
+     * \brief arena for the scratch arrays of the solvers, memory is handed out by moving a pointer.
+     *
+     * Allocations live until the Scope around them ends. A request beyond the capacity gets a block of its own,
+     * the first allocation after the arena is empty again grows it to the largest use seen, so repeated runs of
+     * the same sizes make no heap allocations after the first one and the end of a Scope never allocates. Not thread-safe, use one arena per thread,
+     * e.g. thread_workspace().
+     */
+    class Workspace {
+    public:
+        /**
+         * \brief every allocation starts at this alignment
+         */
+        static constexpr std::size_t ALIGNMENT = 64;
+
+        /**
+         * \brief restores the arena to its state at construction, allocations made since then are released
+         */
+        class Scope {
+        public:
+            explicit Scope(Workspace &workspace);
+
+            Scope(const Scope &) = delete;
+
+            Scope &operator=(const Scope &) = delete;
+
+            ~Scope();
+
+        private:
+            Workspace &workspace_;
+            std::size_t used_;
+            std::size_t blocks_;
+        };
+
+        /**
+         * \param capacity bytes reserved at once
+         */
+        explicit Workspace(std::size_t capacity = 0);
+
+        Workspace(const Workspace &) = delete;
+
+        Workspace &operator=(const Workspace &) = delete;
+
+        /**
+         * \brief uninitialized array of count elements, valid until the enclosing Scope ends
+         */
+        template<class T>
+        T *allocate(const std::size_t count) {
+            return static_cast<T *>(allocate_bytes(bytes<T>(count)));
+        }
+
+        /**
+         * \brief space taken by allocate<T>(count), sums of these give the sizes asked by reserve()
+         */
+        template<class T>
+        static constexpr std::size_t bytes(const std::size_t count) {
+            return (count * sizeof(T) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        }
+
+        /**
+         * \brief make capacity for bytes, only while nothing is allocated
+         */
+        void reserve(std::size_t capacity);
+
+        [[nodiscard]] std::size_t get_capacity() const;
+        [[nodiscard]] std::size_t get_used() const;
+        /**
+         * \brief largest number of bytes in use at one time
+         */
+        [[nodiscard]] std::size_t get_peak() const;
+
+        ~Workspace();
+
+    private:
+        std::byte *data_;
+        std::size_t capacity_;
+        std::size_t used_;
+        std::size_t peak_;
+        std::vector<std::byte *> blocks_;
+
+        void *allocate_bytes(std::size_t size);
+        void release(std::size_t used, std::size_t blocks) noexcept;
+    };
+
+    /**
+     * \brief arena of the calling thread, used by the solvers when no other one is given
+     */
+    Workspace &thread_workspace();
+}
+#endif
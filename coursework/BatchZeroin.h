@@ -0,0 +1,401 @@
+#ifndef BATCH_ZEROIN_H
+#define BATCH_ZEROIN_H
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../common/Statistics.h"
+#include "../common/ThreadPool.h"
+#include "zeroin.h"
+
+namespace dimkashelk {
+    /* number of root problems advanced together */
+    constexpr int ZEROIN_LANES = 8;
+    /* problems given to one task of the thread pool */
+    constexpr int ZEROIN_CHUNK = 1024;
+
+    /**
+     * \brief adapter of a scalar function g(problem, x) to the family interface of details::zeroin_lanes
+     */
+    template<class G>
+    class PointwiseProblems {
+    public:
+        explicit PointwiseProblems(G g): g_(std::move(g)) {
+        }
+
+        void operator()(const int problem[], const double x[], double f[], const int count) const {
+            for (int l = 0; l < count; l++) {
+                f[l] = g_(problem[l], x[l]);
+            }
+        }
+
+        [[nodiscard]] const G &get() const { return g_; }
+
+    private:
+        G g_;
+    };
+
+    template<class G>
+    PointwiseProblems<G> make_pointwise_problems(G g) {
+        return PointwiseProblems<G>(std::move(g));
+    }
+
+    namespace details {
+        /**
+         * \brief zeroin() as a resumable state machine, point() is the abscissa to evaluate next and
+         * advance() takes its function value, the sequence of points and the result are those of zeroin()
+         */
+        class ZeroinLane {
+        public:
+            void start(const double left, const double right, const double tol) {
+                left_ = left;
+                right_ = right;
+                tol_ = tol;
+                zflag_ = 0;
+                exit_ = false;
+                a_ = left;
+                b_ = right;
+                evaluations_ = 1;
+                x_ = a_;
+                stage_ = Stage::LEFT;
+            }
+
+            [[nodiscard]] bool done() const { return stage_ == Stage::DONE; }
+            [[nodiscard]] double point() const { return x_; }
+            [[nodiscard]] double result() const { return b_; }
+            [[nodiscard]] int flag() const { return zflag_; }
+            [[nodiscard]] int evaluations() const { return evaluations_; }
+
+            /**
+             * \brief |f| at the best estimate b once a bracket is known, infinity while bracketing
+             */
+            [[nodiscard]] double residual() const {
+                return (stage_ == Stage::STEP || stage_ == Stage::DONE) ? std::fabs(fb_) : HUGE_VAL;
+            }
+
+            void advance(const double fx) {
+                switch (stage_) {
+                    case Stage::LEFT:
+                        fa_ = fx;
+                        request(b_, Stage::RIGHT);
+                        return;
+                    case Stage::RIGHT:
+                        fb_ = fx;
+                        /* Check constraints */
+                        if (tol_ <= 0.0 || left_ == right_) {
+                            exit_ = true;
+                            zflag_ = 2;
+                        }
+                        if (fa_ * (fb_ / std::fabs(fb_)) > 0.0) {
+                            /* try to bracket a zero, first an even number of zeros within the range */
+                            dx_ = (b_ - a_) / SEGMENTS;
+                            x1_ = a_;
+                            f1_ = fa_;
+                            i_ = 0;
+                            x2_ = x1_ + dx_;
+                            request(x2_, Stage::SEGMENT);
+                            return;
+                        }
+                        skip_ = false;
+                        iterate();
+                        return;
+                    case Stage::SEGMENT:
+                        f2_ = fx;
+                        if (f1_ * (f2_ / std::fabs(f2_)) < 0.0) {
+                            bracket(x1_, f1_, x2_, f2_);
+                            return;
+                        }
+                        x1_ = x2_;
+                        f1_ = f2_;
+                        if (++i_ < SEGMENTS) {
+                            x2_ = x1_ + dx_;
+                            request(x2_, Stage::SEGMENT);
+                            return;
+                        }
+                        /* now try extending the user supplied range */
+                        x1_ = a_;
+                        f1_ = fa_;
+                        x2_ = b_;
+                        f2_ = fb_;
+                        i_ = 0;
+                        extend();
+                        return;
+                    case Stage::EXTEND:
+                        if (lower_) {
+                            f1_ = fx;
+                        } else {
+                            f2_ = fx;
+                        }
+                        if (f1_ * (f2_ / std::fabs(f2_)) <= 0.0) {
+                            bracket(x1_, f1_, x2_, f2_);
+                            return;
+                        }
+                        i_++;
+                        extend();
+                        return;
+                    case Stage::STEP:
+                        fb_ = fx;
+                        /* zero is already between b and c, otherwise swap a and c */
+                        skip_ = (fb_ * (fc_ / std::fabs(fc_))) <= 0.0;
+                        iterate();
+                        return;
+                    case Stage::DONE:
+                        return;
+                }
+            }
+
+        private:
+            enum class Stage { LEFT, RIGHT, SEGMENT, EXTEND, STEP, DONE };
+
+            static constexpr int SEGMENTS = 10;
+            static constexpr int EXTENSIONS = 20;
+            static constexpr double FACTOR = 1.6;
+            static constexpr double EPS = 2.2e-16;
+
+            Stage stage_ = Stage::DONE;
+            double left_ = 0.0, right_ = 0.0, tol_ = 0.0;
+            double a_ = 0.0, b_ = 0.0, c_ = 0.0, d_ = 0.0, e_ = 0.0;
+            double fa_ = 0.0, fb_ = 0.0, fc_ = 0.0;
+            double x1_ = 0.0, x2_ = 0.0, f1_ = 0.0, f2_ = 0.0, dx_ = 0.0, x_ = 0.0;
+            int zflag_ = 0, i_ = 0, evaluations_ = 0;
+            bool exit_ = false, skip_ = false, lower_ = false;
+
+            void request(const double x, const Stage stage) {
+                x_ = x;
+                stage_ = stage;
+                evaluations_++;
+            }
+
+            void bracket(const double a, const double fa, const double b, const double fb) {
+                a_ = a;
+                fa_ = fa;
+                b_ = b;
+                fb_ = fb;
+                skip_ = false;
+                iterate();
+            }
+
+            void extend() {
+                if (i_ >= EXTENSIONS) {
+                    /* unsuccessful in trying to bracket an odd number of zeros */
+                    exit_ = true;
+                    zflag_ = 1;
+                    stage_ = Stage::DONE;
+                    return;
+                }
+                /* extend the range in the downhill direction */
+                lower_ = std::fabs(f1_) < std::fabs(f2_);
+                if (lower_) {
+                    x1_ -= (x2_ - x1_) * FACTOR;
+                    request(x1_, Stage::EXTEND);
+                } else {
+                    x2_ += (x2_ - x1_) * FACTOR;
+                    request(x2_, Stage::EXTEND);
+                }
+            }
+
+            void iterate() {
+                if (exit_) {
+                    stage_ = Stage::DONE;
+                    return;
+                }
+                if (!skip_) {
+                    c_ = a_;
+                    fc_ = fa_;
+                    d_ = b_ - a_;
+                    e_ = d_;
+                }
+                if (std::fabs(fc_) < std::fabs(fb_)) {
+                    a_ = b_;
+                    b_ = c_;
+                    c_ = a_;
+                    fa_ = fb_;
+                    fb_ = fc_;
+                    fc_ = fa_;
+                }
+                /* Convergence test */
+                const double tol1 = 2.0 * EPS * std::fabs(b_) + 0.5 * tol_;
+                const double xm = 0.5 * (c_ - b_);
+                if ((std::fabs(xm) < tol1) || (fb_ == 0.0)) {
+                    exit_ = true;
+                    stage_ = Stage::DONE;
+                    return;
+                }
+                /* Is bisection necessary ? */
+                if ((std::fabs(e_) < tol1) || (std::fabs(fa_) <= std::fabs(fb_))) {
+                    d_ = xm;
+                    e_ = d_;
+                } else {
+                    double p, q, r, s;
+                    if (a_ == c_) {
+                        s = fb_ / fa_;
+                        p = 2.0 * xm * s;
+                        q = 1.0 - s;
+                    } else {
+                        q = fa_ / fc_;
+                        r = fb_ / fc_;
+                        s = fb_ / fa_;
+                        p = s * (2.0 * xm * q * (q - r) - (b_ - a_) * (r - 1.0));
+                        q = (q - 1.0) * (r - 1.0) * (s - 1.0);
+                    }
+                    if (p > 0.0) q = -q;
+                    p = std::fabs(p);
+                    /* Is the interpolation acceptable? */
+                    if (((2.0 * p) > (3.0 * xm * q - std::fabs(tol1 * q))) || (p >= std::fabs(0.5 * e_ * q))) {
+                        d_ = xm;
+                        e_ = d_;
+                    } else {
+                        e_ = d_;
+                        d_ = p / q;
+                    }
+                }
+                /* Complete step */
+                a_ = b_;
+                fa_ = fb_;
+                if (std::fabs(d_) > tol1) {
+                    b_ = b_ + d_;
+                } else if (xm > 0.0) {
+                    b_ = b_ + std::fabs(tol1);
+                } else {
+                    b_ = b_ - std::fabs(tol1);
+                }
+                request(b_, Stage::STEP);
+            }
+        };
+
+        /**
+         * \brief roots of problems first ... first + count - 1 on ZEROIN_LANES lanes, a lane that finishes
+         * takes the next problem, so every call of fun gets up to ZEROIN_LANES points
+         * \param fun family of functions, fun(const int problem[], const double x[], double f[], int count)
+         * sets f[l] = f_problem[l](x[l]) for l < count
+         */
+        template<class Family>
+        void zeroin_lanes(Family &&fun, const int first, const int count, const double left[], const double right[],
+                          const double tol, double result[], int flag[], int no_fun[]) {
+            constexpr int L = ZEROIN_LANES;
+            ZeroinLane lanes[L];
+            int owner[L];
+            int problem[L];
+            double x[L];
+            double f[L];
+            int active = 0;
+            int next = 0;
+            for (; active < L && next < count; active++, next++) {
+                owner[active] = first + next;
+                lanes[active].start(left[first + next], right[first + next], tol);
+            }
+            while (active > 0) {
+                for (int l = 0; l < active; l++) {
+                    problem[l] = owner[l];
+                    x[l] = lanes[l].point();
+                }
+                fun(static_cast<const int *>(problem), static_cast<const double *>(x), static_cast<double *>(f),
+                    active);
+                NUMERICS_COUNT(ROOT_CALLS, active);
+                for (int l = 0; l < active;) {
+                    lanes[l].advance(f[l]);
+                    if (!lanes[l].done()) {
+                        l++;
+                        continue;
+                    }
+                    result[owner[l]] = lanes[l].result();
+                    flag[owner[l]] = lanes[l].flag();
+                    no_fun[owner[l]] = lanes[l].evaluations();
+                    if (next < count) {
+                        /* the lane continues with a new problem, its first point is requested next round */
+                        owner[l] = first + next;
+                        lanes[l].start(left[first + next], right[first + next], tol);
+                        next++;
+                        l++;
+                    } else {
+                        /* keep the active lanes in front */
+                        active--;
+                        lanes[l] = lanes[active];
+                        owner[l] = owner[active];
+                        f[l] = f[active];
+                        if (l == active) {
+                            break;
+                        }
+                        /* the moved lane has not consumed its value yet */
+                    }
+                }
+            }
+        }
+
+        template<class Family>
+        void zeroin_chunk(Family &fun, const int first, const int count, const double left[], const double right[],
+                          const double tol, double result[], int flag[], int no_fun[]) {
+            zeroin_lanes(fun, first, count, left, right, tol, result, flag, no_fun);
+        }
+
+        /**
+         * \brief a scalar function gains nothing from lanes, the problems are solved one by one by zeroin()
+         */
+        template<class G>
+        void zeroin_chunk(const PointwiseProblems<G> &fun, const int first, const int count, const double left[],
+                          const double right[], const double tol, double result[], int flag[], int no_fun[]) {
+            for (int k = first; k < first + count; k++) {
+                int evaluations = 0;
+                result[k] = zeroin(left[k], right[k], [&](const double x) {
+                    evaluations++;
+                    return fun.get()(k, x);
+                }, tol, flag + k);
+                no_fun[k] = evaluations;
+            }
+        }
+    }
+
+    /**
+     * \brief zeroin() for many independent problems, each with its own bracket,
+     * results are the same as those of zeroin() for every problem
+     */
+    template<class F>
+    class BatchZeroin {
+    public:
+        /**
+         * \brief
+         * \param pool threads for chunks of ZEROIN_CHUNK problems, nullptr for serial execution
+         * \param fun family of functions, see details::zeroin_lanes, use make_pointwise_problems() for a scalar one
+         * \param left left end-points of the initial intervals
+         * \param right right end-points of the initial intervals
+         * \param tol desired length of interval of uncertainty of the results
+         */
+        BatchZeroin(ThreadPool *pool, const F &fun, const std::vector<double> &left, const std::vector<double> &right,
+                    const double tol): result_(left.size()),
+                                       flag_(left.size()),
+                                       no_fun_(left.size()) {
+            if (left.empty() || left.size() != right.size()) {
+                throw std::logic_error("Check intervals");
+            }
+            const int count = static_cast<int>(left.size());
+            const int chunks = (count + ZEROIN_CHUNK - 1) / ZEROIN_CHUNK;
+            auto task = [&](const int chunk) {
+                const int first = chunk * ZEROIN_CHUNK;
+                details::zeroin_chunk(fun, first, std::min(ZEROIN_CHUNK, count - first), left.data(), right.data(),
+                                      tol, result_.data(), flag_.data(), no_fun_.data());
+            };
+            if (pool == nullptr) {
+                for (int chunk = 0; chunk < chunks; chunk++) {
+                    task(chunk);
+                }
+            } else {
+                pool->run(chunks, task);
+            }
+        }
+
+        [[nodiscard]] const std::vector<double> &getResult() const { return result_; }
+        /**
+         * \brief 0 normal return, 1 could not bracket a zero, 2 tol <= 0 or left == right
+         */
+        [[nodiscard]] const std::vector<int> &getFlag() const { return flag_; }
+        [[nodiscard]] const std::vector<int> &getNoFun() const { return no_fun_; }
+
+    private:
+        std::vector<double> result_;
+        std::vector<int> flag_;
+        std::vector<int> no_fun_;
+    };
+}
+#endif
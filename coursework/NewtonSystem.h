@@ -0,0 +1,296 @@
+#ifndef NEWTON_SYSTEM_H
+#define NEWTON_SYSTEM_H
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../common/Statistics.h"
+#include "../second_lab/Decomp.h"
+#include "../second_lab/Jacobian.h"
+#include "../second_lab/Matrix.h"
+#include "../second_lab/Solve.h"
+
+namespace dimkashelk {
+    /**
+     * \brief zero of a system F(x) = 0 in R^n, the multidimensional counterpart of zeroin() for problems with
+     * coupled unknowns, e.g. shooting for several initial values at once instead of nesting scalar searches.
+     *
+     * Newton's method with Broyden's update. The Jacobian is computed by ColoredJacobian (n calls of F, colors
+     * calls for a sparse pattern, stored dense either way) and factorized by Decomp only when it is refreshed. Between refreshes the
+     * inverse is kept as H = (I + u_k s_k^T) ... (I + u_1 s_1^T) J^-1 (Sherman-Morrison form of the rank-1
+     * updates, C. G. Broyden), so a step costs one solve with the stored factors, O(kn) for the updates and
+     * usually a single call of F. Every step is safeguarded by a backtracking line search on |F|^2 with
+     * quadratic interpolation; if it fails the Jacobian is refreshed, if it fails with a fresh Jacobian the
+     * search stops. F is any callable f(int n, const double x[], double fx[]).
+     */
+    template<class F>
+    class NewtonSystem {
+    public:
+        /**
+         * \brief
+         * \param fun function F of the system
+         * \param n number of equations and unknowns
+         * \param tol tolerance of the residual, the root is accepted when max |F_i(x)| <= tol
+         * \param step_tol the root is also accepted when max |s_i| / (1 + |x_i|) <= step_tol for the step s,
+         *        0 to use the residual only
+         * \param max_fun maximum number of calls of F, 100 (n + 1) if 0
+         * \param max_updates number of Broyden updates before the Jacobian is refreshed, min(n + 10, 30) if 0,
+         *        u and s of the updates take 2 max_updates n doubles and a step applies all of them
+         */
+        NewtonSystem(F fun, const int n, const double tol, const double step_tol = 0.0, const int max_fun = 0,
+                     const int max_updates = 0):
+            NewtonSystem(std::move(fun), JacobianColoring(n), tol, step_tol, max_fun, max_updates) {
+        }
+
+        /**
+         * \brief system with a sparse Jacobian, its refreshes perturb the columns of one color at once.
+         * Only the calls of F are saved, the Jacobian is still stored as a dense n x n Matrix and factorized
+         * by the dense Decomp.
+         * \param coloring coloring of the nonzero pattern of dF/dx
+         */
+        NewtonSystem(F fun, JacobianColoring coloring, const double tol, const double step_tol = 0.0,
+                     const int max_fun = 0, const int max_updates = 0): fun_(std::move(fun)),
+            n_(coloring.get_size()),
+            tol_(tol),
+            step_tol_(step_tol),
+            max_fun_(max_fun > 0 ? max_fun : 100 * (coloring.get_size() + 1)),
+            max_updates_(max_updates > 0 ? max_updates : std::min(coloring.get_size() + 10, 30)),
+            differences_(System{std::addressof(fun_)}, std::move(coloring)),
+            jacobian_(n_, n_),
+            f_(n_),
+            trial_(n_),
+            f_trial_(n_),
+            direction_(n_),
+            rhs_(n_),
+            hy_(n_),
+            u_(static_cast<std::size_t>(max_updates_) * n_),
+            s_(static_cast<std::size_t>(max_updates_) * n_),
+            updates_(0),
+            flag_(0),
+            no_fun_(0),
+            iterations_(0),
+            jacobians_(0),
+            residual_(0.0) {
+            if (tol < 0.0 || step_tol < 0.0 || (tol == 0.0 && step_tol == 0.0)) {
+                throw std::logic_error("Check tolerance");
+            }
+        }
+
+        /**
+         * \brief solve F(x) = 0
+         * \param x initial estimate on input, approximation of the root on output, of size n
+         * \return flag, 0 normal return, 1 too many calls of F, 2 the line search failed with a fresh Jacobian
+         *         (a local minimum of |F| or a noisy F), 3 the Jacobian is singular to working precision
+         */
+        int operator()(double x[]) {
+            constexpr double ALPHA = 1.0e-4;
+            constexpr int MAX_BACKTRACKS = 10;
+            flag_ = 0;
+            no_fun_ = 0;
+            iterations_ = 0;
+            jacobians_ = 0;
+            updates_ = 0;
+            evaluate(x, f_.data());
+            bool refresh = true;
+            bool fresh = false;
+            for (;;) {
+                residual_ = norm(f_.data());
+                if (residual_ <= tol_) {
+                    break;
+                }
+                if (no_fun_ >= max_fun_) {
+                    flag_ = 1;
+                    break;
+                }
+                if (refresh) {
+                    if (!factorize(x)) {
+                        flag_ = 3;
+                        break;
+                    }
+                    refresh = false;
+                    fresh = true;
+                }
+
+                /* quasi-Newton direction d = -H F(x) */
+                apply(f_.data(), direction_.data());
+                for (int i = 0; i < n_; i++) direction_[i] = -direction_[i];
+
+                /* g(lambda) = |F(x + lambda d)|^2 / 2, g'(0) = -2 g(0) for the exact Jacobian */
+                const double g0 = 0.5 * dot(f_.data(), f_.data());
+                double lambda = 1.0;
+                bool accepted = false;
+                for (int k = 0; k <= MAX_BACKTRACKS && no_fun_ < max_fun_; k++) {
+                    for (int i = 0; i < n_; i++) trial_[i] = x[i] + lambda * direction_[i];
+                    evaluate(trial_.data(), f_trial_.data());
+                    const double g = 0.5 * dot(f_trial_.data(), f_trial_.data());
+                    if (g <= (1.0 - 2.0 * ALPHA * lambda) * g0) {
+                        accepted = true;
+                        break;
+                    }
+                    /* minimum of the quadratic through g(0), g'(0) and g(lambda), kept in [0.1, 0.5] lambda */
+                    const double curvature = g - g0 + 2.0 * g0 * lambda;
+                    const double minimum = curvature > 0.0 ? g0 * lambda * lambda / curvature : 0.5 * lambda;
+                    lambda = std::clamp(std::isfinite(minimum) ? minimum : 0.1 * lambda, 0.1 * lambda,
+                                        0.5 * lambda);
+                }
+                if (!accepted) {
+                    if (no_fun_ >= max_fun_) {
+                        flag_ = 1;
+                        break;
+                    }
+                    if (fresh) {
+                        flag_ = 2;
+                        break;
+                    }
+                    /* the updated Jacobian gives no descent, refresh it at the same x */
+                    refresh = true;
+                    continue;
+                }
+
+                /* s = lambda d, y = F(x + s) - F(x) */
+                double step = 0.0;
+                for (int i = 0; i < n_; i++) {
+                    direction_[i] *= lambda;
+                    x[i] = trial_[i];
+                    step = std::max(step, std::fabs(direction_[i]) / (1.0 + std::fabs(x[i])));
+                    trial_[i] = f_trial_[i] - f_[i];
+                }
+                std::swap(f_, f_trial_);
+                iterations_++;
+                if (step <= step_tol_) {
+                    residual_ = norm(f_.data());
+                    break;
+                }
+                /* a backtracked step shows that the updated Jacobian is poor, the next one starts afresh */
+                refresh = !update(direction_.data(), trial_.data()) || (lambda < 1.0 && !fresh);
+                fresh = false;
+            }
+            return flag_;
+        }
+
+        /**
+         * \brief 0 normal return, 1 too many calls of F, 2 the line search failed, 3 singular Jacobian
+         */
+        [[nodiscard]] int getFlag() const { return flag_; }
+        /**
+         * \brief total number of calls of F, including the ones of the Jacobians
+         */
+        [[nodiscard]] int getNoFun() const { return no_fun_; }
+        [[nodiscard]] int getIterations() const { return iterations_; }
+        /**
+         * \brief number of Jacobians computed and factorized
+         */
+        [[nodiscard]] int getJacobians() const { return jacobians_; }
+        /**
+         * \brief max |F_i| at the returned x
+         */
+        [[nodiscard]] double getResidual() const { return residual_; }
+        [[nodiscard]] int getSize() const { return n_; }
+
+    private:
+        /* F(x) as the right hand side y' = F(y) of the differences, the object is neither copied nor moved */
+        struct System {
+            F *fun;
+
+            int operator()(const int n, double, const double y[], double fy[]) const {
+                (*fun)(n, y, fy);
+                return 0;
+            }
+        };
+
+        F fun_;
+        int n_;
+        double tol_;
+        double step_tol_;
+        int max_fun_;
+        int max_updates_;
+        ColoredJacobian<System> differences_;
+        Matrix jacobian_;
+        Decomp decomp_;
+        Solve solve_;
+        std::vector<double> f_;
+        std::vector<double> trial_;
+        std::vector<double> f_trial_;
+        std::vector<double> direction_;
+        std::vector<double> rhs_;
+        std::vector<double> hy_;
+        /* u_k and s_k of the updates, one row of n per update */
+        std::vector<double> u_;
+        std::vector<double> s_;
+        int updates_;
+        int flag_;
+        int no_fun_;
+        int iterations_;
+        int jacobians_;
+        double residual_;
+
+        void evaluate(const double x[], double fx[]) {
+            fun_(n_, x, fx);
+            no_fun_++;
+            NUMERICS_COUNT(ROOT_CALLS, 1);
+        }
+
+        /* Jacobian at x by differences with F(x) = f_, factorized in its own storage */
+        bool factorize(const double x[]) {
+            const int calls = differences_(0.0, x, f_.data(), jacobian_);
+            no_fun_ += calls;
+            NUMERICS_COUNT(ROOT_CALLS, calls);
+            NUMERICS_COUNT(JACOBIANS, 1);
+            jacobians_++;
+            updates_ = 0;
+            decomp_.factorize_in_place(jacobian_);
+            const double cond = decomp_.get_cond();
+            return decomp_.get_flag() == 0 && cond + 1.0 != cond;
+        }
+
+        /* z = H v with the factors and the first updates_ rank-1 updates */
+        void apply(const double v[], double z[]) {
+            std::copy(v, v + n_, rhs_.begin());
+            solve_(decomp_, rhs_);
+            const ConstMatrixView result = solve_.get_result_view();
+            for (int i = 0; i < n_; i++) z[i] = result(i, 0);
+            for (int k = 0; k < updates_; k++) {
+                const double *u = u_.data() + static_cast<std::size_t>(k) * n_;
+                const double *s = s_.data() + static_cast<std::size_t>(k) * n_;
+                const double c = dot(s, z);
+                for (int i = 0; i < n_; i++) z[i] += c * u[i];
+            }
+        }
+
+        /*
+         * Broyden's update B+ = B + (y - B s) s^T / s^T s, by Sherman-Morrison H+ = (I + u s^T) H with
+         * u = (s - H y) / s^T H y. Returns false when the Jacobian has to be refreshed instead.
+         */
+        bool update(const double s[], const double y[]) {
+            if (updates_ >= max_updates_) {
+                return false;
+            }
+            apply(y, hy_.data());
+            const double denominator = dot(s, hy_.data());
+            if (!(std::fabs(denominator) > 1.0e-12 * std::sqrt(dot(s, s) * dot(hy_.data(), hy_.data())))) {
+                return false;
+            }
+            double *u = u_.data() + static_cast<std::size_t>(updates_) * n_;
+            std::copy(s, s + n_, s_.data() + static_cast<std::size_t>(updates_) * n_);
+            for (int i = 0; i < n_; i++) u[i] = (s[i] - hy_[i]) / denominator;
+            updates_++;
+            return true;
+        }
+
+        [[nodiscard]] double dot(const double a[], const double b[]) const {
+            double sum = 0.0;
+            for (int i = 0; i < n_; i++) sum += a[i] * b[i];
+            return sum;
+        }
+
+        [[nodiscard]] double norm(const double v[]) const {
+            double result = 0.0;
+            for (int i = 0; i < n_; i++) result = std::max(result, std::fabs(v[i]));
+            return result;
+        }
+    };
+}
+#endif
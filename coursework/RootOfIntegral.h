@@ -0,0 +1,130 @@
+#ifndef ROOT_OF_INTEGRAL_H
+#define ROOT_OF_INTEGRAL_H
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../common/BatchQuanc8.h"
+#include "BatchZeroin.h"
+
+namespace dimkashelk {
+    /**
+     * \brief root alpha of F(alpha) = target - integral of g(y, alpha) over [a, b], zeroin() driven through
+     * details::ZeroinLane with a quadrature tolerance that follows the progress of the root search.
+     *
+     * Every value of F is computed by Quanc8 with abs_err = rel_err = clamp(theta * r, quad_tol, loose_tol),
+     * r being |F| at the best estimate so far: while r is large only the sign of F matters and a loose
+     * integral is enough, near the root the tolerance reaches quad_tol, so the answer is as accurate as with
+     * quad_tol everywhere. The values of F are cached with their tolerance and reused for the same alpha.
+     */
+    template<class G>
+    class RootOfIntegral {
+    public:
+        /**
+         * \brief
+         * \param g integrand g(y, alpha)
+         * \param a lower bound of integration
+         * \param b upper bound of integration
+         * \param target value of the integral at the root
+         * \param quad_tol tolerance of the quadrature near the root
+         * \param loose_tol tolerance of the quadrature far from the root
+         * \param theta ratio of the tolerance to the residual
+         */
+        RootOfIntegral(G g, const double a, const double b, const double target, const double quad_tol,
+                       const double loose_tol = 1.0e-2, const double theta = 0.01): g_(std::move(g)),
+            a_(a),
+            b_(b),
+            target_(target),
+            quad_tol_(quad_tol),
+            loose_tol_(std::max(loose_tol, quad_tol)),
+            theta_(theta),
+            flag_(0),
+            no_fun_(0),
+            integrals_(0),
+            hits_(0) {
+            if (quad_tol <= 0.0) {
+                throw std::logic_error("Check tolerance");
+            }
+        }
+
+        /**
+         * \brief find the root as zeroin(left, right, F, tol)
+         * \return abscissa approximating the root
+         */
+        double operator()(const double left, const double right, const double tol) {
+            details::ZeroinLane lane;
+            lane.start(left, right, tol);
+            while (!lane.done()) {
+                const double tolerance = std::clamp(theta_ * lane.residual(), quad_tol_, loose_tol_);
+                lane.advance(value(lane.point(), tolerance));
+            }
+            flag_ = lane.flag();
+            return lane.result();
+        }
+
+        /**
+         * \brief F(alpha) with the quadrature tolerance quad_tol, or a cached value at least as accurate
+         */
+        double operator()(const double alpha) {
+            return value(alpha, quad_tol_);
+        }
+
+        /**
+         * \brief flag of zeroin(), 0 normal return, 1 could not bracket a zero, 2 tol <= 0 or left == right
+         */
+        [[nodiscard]] int getFlag() const { return flag_; }
+        /**
+         * \brief total number of evaluations of g
+         */
+        [[nodiscard]] int getNoFun() const { return no_fun_; }
+        [[nodiscard]] int getIntegrals() const { return integrals_; }
+        [[nodiscard]] int getCacheHits() const { return hits_; }
+
+    private:
+        struct Entry {
+            double alpha;
+            double tolerance;
+            double value;
+        };
+
+        G g_;
+        double a_;
+        double b_;
+        double target_;
+        double quad_tol_;
+        double loose_tol_;
+        double theta_;
+        int flag_;
+        int no_fun_;
+        int integrals_;
+        int hits_;
+        std::vector<Entry> cache_;
+
+        double value(const double alpha, const double tolerance) {
+            for (const Entry &entry: cache_) {
+                if (entry.alpha == alpha && entry.tolerance <= tolerance) {
+                    hits_++;
+                    return entry.value;
+                }
+            }
+            auto fun = [this, alpha](const double x[], double f[], const int count) {
+                for (int i = 0; i < count; i++) {
+                    f[i] = g_(x[i], alpha);
+                }
+            };
+            double result = 0.0, error = 0.0, flag = 0.0;
+            int no_fun = 0;
+            details::quanc8(fun, a_, b_, tolerance, tolerance, std::addressof(result), std::addressof(error),
+                            std::addressof(no_fun), std::addressof(flag));
+            no_fun_ += no_fun;
+            integrals_++;
+            const double v = target_ - result;
+            cache_.push_back({alpha, tolerance, v});
+            return v;
+        }
+    };
+}
+#endif
@@ -2,7 +2,8 @@
 #include <cmath>
 #include <functional>
 #include "../common/Quanc8.h"
-#include "zeroin.h"
+#include "../common/BatchQuanc8.h"
+#include "RootOfIntegral.h"
 
 double integrand(double y, double alpha) {
     return 1.0 / sqrt(2 * (alpha + pow(y, 3) / 3 - y));
@@ -11,15 +12,20 @@ double integrand(double y, double alpha) {
 double to_solve(double alpha) {
     double a = 0, b = 1;
     double abserr = 1e-6, relerr = 1e-6;
-    auto func = std::bind(integrand, std::placeholders::_1, alpha);
-    dimkashelk::Quanc8 quanc8(func, a, b, abserr, relerr);
+    auto func = [alpha](const double x[], double f[], const int count) {
+        for (int i = 0; i < count; i++) {
+            f[i] = integrand(x[i], alpha);
+        }
+    };
+    dimkashelk::BatchQuanc8<decltype(func)> quanc8(func, a, b, abserr, relerr);
     return 1 - quanc8.getResult();
 }
 
 double find_alpha(double a, double b) {
     double tol = 1e-12;
-    int flag = 0;
-    double res = zeroin(a, b, to_solve, tol, &flag);
+    auto g = [](double y, double alpha) { return integrand(y, alpha); };
+    dimkashelk::RootOfIntegral<decltype(g)> root(g, 0, 1, 1, 1e-6);
+    double res = root(a, b, tol);
     return res;
 }
 
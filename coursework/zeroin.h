@@ -4,12 +4,15 @@
 /*                                              */
 /************************************************/
 
+#ifndef ZEROIN_H
+#define ZEROIN_H
 #include <cmath>
 
-#define  EPSILON  2.2e-16
+#include "../common/Statistics.h"
 
+template<class F>
 double zeroin(double left, double right,
-              double (*f)(double x),
+              F &&f,
               double tol,
               int *flag)
 
@@ -25,8 +28,8 @@ double zeroin(double left, double right,
    -----
    left     : left end-point of the initial interval
    right    : right end-point of the initial interval
-   (*f)()   : pointer to function which evaluates f(x) for any x
-	      in the interval left, right
+   f        : any callable evaluating f(x) for any x in the interval
+	      left, right, a function pointer, lambda or function object
    tol      : desired length of interval of uncertainty of
 	      the final result.  tol >= 0.0
 
@@ -68,13 +71,13 @@ double zeroin(double left, double right,
     double a, b, c, d, e;
     double fa, fb, fc, tol1;
     double xm, p, q, r, s;
-    int zflag, skip, exit, bracket;
+    int zflag;
+    bool skip, exit, bracket;
     int nstep, i, nseg;
     double factor, x1, x2, dx, f1, f2;
 
-/* constants */
-#define  TRUE   1
-#define  FALSE  0
+/* constants, not macros, the header is included by library code */
+    constexpr double EPSILON = 2.2e-16;
     zero = 0.0;
     half = 0.5;
     one = 1.0;
@@ -83,21 +86,22 @@ double zeroin(double left, double right,
 
 /* Initialization */
     zflag = 0;
-    exit = FALSE;
+    exit = false;
     a = left;
     b = right;
-    fa = (*f)(a);
-    fb = (*f)(b);
+    fa = f(a);
+    fb = f(b);
+    NUMERICS_COUNT(ROOT_CALLS, 2);
 
 /* Check constraints */
     if (tol <= zero || left == right) {
-        exit = TRUE;
+        exit = true;
         zflag = 2;
     }
 
     if (fa * (fb / fabs(fb)) > zero) {
         /* try to bracket a zero ... */
-        bracket = FALSE;
+        bracket = false;
 
         /* first check the possibility of an even number of zeros
            within the user supplied range */
@@ -107,10 +111,11 @@ double zeroin(double left, double right,
         f1 = fa;
         for (i = 0; i < nseg; ++i) {
             x2 = x1 + dx;
-            f2 = (*f)(x2);
+            f2 = f(x2);
+            NUMERICS_COUNT(ROOT_CALLS, 1);
             if (f1 * (f2 / fabs(f2)) < zero) {
                 /* this segment brackets a zero */
-                bracket = TRUE;
+                bracket = true;
                 a = x1;
                 fa = f1;
                 b = x2;
@@ -133,14 +138,16 @@ double zeroin(double left, double right,
                 /* extend the range in the downhill direction */
                 if (fabs(f1) < fabs(f2)) {
                     x1 -= (x2 - x1) * factor;
-                    f1 = (*f)(x1);
+                    f1 = f(x1);
+                    NUMERICS_COUNT(ROOT_CALLS, 1);
                 } else {
                     x2 += (x2 - x1) * factor;
-                    f2 = (*f)(x2);
+                    f2 = f(x2);
+                    NUMERICS_COUNT(ROOT_CALLS, 1);
                 }
                 if (f1 * (f2 / fabs(f2)) <= zero) {
                     /* we have bracketed a zero (or odd number of) */
-                    bracket = TRUE;
+                    bracket = true;
                     a = x1;
                     fa = f1;
                     b = x2;
@@ -152,14 +159,14 @@ double zeroin(double left, double right,
         if (!bracket) {
             /* we have been unsuccessful in trying to bracket an
                odd number of zeros */
-            exit = TRUE;
+            exit = true;
             zflag = 1;
         }
     }
 
 
 /* Begin step */
-    skip = FALSE;
+    skip = false;
     while (!exit) {
 
         if (!skip) {
@@ -182,7 +189,7 @@ double zeroin(double left, double right,
         tol1 = two * EPSILON * fabs(b) + half * tol;
         xm = half * (c - b);
         /* bail out if the solution is found to the desired accuracy */
-        if ((fabs(xm) < tol1) || (fb == zero)) exit = TRUE;
+        if ((fabs(xm) < tol1) || (fb == zero)) exit = true;
 
         if (!exit) {  /* proceed with step */
 
@@ -230,11 +237,12 @@ double zeroin(double left, double right,
                 else
                     b = b - fabs(tol1);
             }
-            fb = (*f)(b);            /* function value at the new point */
+            fb = f(b);            /* function value at the new point */
+            NUMERICS_COUNT(ROOT_CALLS, 1);
 
             if ((fb * (fc / fabs(fc))) <= zero)
-                skip = TRUE;       /* zero is already between b and c */
-            else skip = FALSE; /* swap a and c to get zero between b and c */
+                skip = true;       /* zero is already between b and c */
+            else skip = false; /* swap a and c to get zero between b and c */
 
         }  /* if not exit , end of step */
     }  /* while */
@@ -246,7 +254,5 @@ double zeroin(double left, double right,
 /* return the abscissa with the minimum absolute value */
     return (b);
 
-#undef TRUE
-#undef FALSE
-
 }  /* ---- end of zeroin() ---- */
+#endif
@@ -1,27 +1,160 @@
 #include "Langrage.h"
 
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <cstddef>
 
+namespace {
+    constexpr std::size_t EVALUATE_BLOCK = 8;
+}
+
 dimkashelk::Langrage::Langrage(const std::vector<std::pair<double, double> > &points):
-    points_(points)
-{}
+    exponent_(0)
+{
+    if (points.empty()) {
+        throw std::logic_error("Check points");
+    }
+    nodes_.reserve(points.size());
+    values_.reserve(points.size());
+    weights_.reserve(points.size());
+    for (const auto &point: points) {
+        nodes_.push_back(point.first);
+        values_.push_back(point.second);
+    }
+    const size_t n = nodes_.size();
+    weights_.assign(n, 1.0);
+    std::vector<int> exponents(n);
+    for (size_t i = 0; i < n; i++) {
+        int exponent = 0;
+        const double product = product_of_differences(nodes_[i], i, exponent);
+        weights_[i] = 1.0 / product;
+        exponents[i] = -exponent;
+    }
+    /* the weights are 1 / product 2^exponents[i], the largest exponent becomes 0 */
+    const int largest = *std::max_element(exponents.begin(), exponents.end());
+    for (size_t i = 0; i < n; i++) {
+        weights_[i] = std::ldexp(weights_[i], exponents[i] - largest);
+    }
+    exponent_ = -largest;
+    rescale();
+}
 
 double dimkashelk::Langrage::operator()(const double x) const {
-    double res = 0.0;
-    for (size_t i = 0; i < points_.size(); i++) {
-        res += calculateFraction(i, x) * points_[i].second;
+    double numerator = 0.0;
+    double denominator = 0.0;
+    for (size_t i = 0; i < nodes_.size(); i++) {
+        const double diff = x - nodes_[i];
+        if (diff == 0.0) {
+            return values_[i];
+        }
+        const double t = weights_[i] / diff;
+        numerator += t * values_[i];
+        denominator += t;
+    }
+    return numerator / denominator;
+}
+
+void dimkashelk::Langrage::evaluate(const double x[], const std::size_t count, double result[]) const {
+    const size_t n = nodes_.size();
+    for (size_t start = 0; start < count; start += EVALUATE_BLOCK) {
+        const size_t size = std::min(EVALUATE_BLOCK, count - start);
+        if (size < EVALUATE_BLOCK) {
+            for (size_t k = 0; k < size; k++) {
+                result[start + k] = operator()(x[start + k]);
+            }
+            break;
+        }
+        /* the queries of a block are independent lanes of the same reduction over the nodes */
+        double numerator[EVALUATE_BLOCK] = {};
+        double denominator[EVALUATE_BLOCK] = {};
+        double q[EVALUATE_BLOCK];
+        std::copy(x + start, x + start + EVALUATE_BLOCK, q);
+        bool hit = false;
+        for (size_t i = 0; i < n; i++) {
+            const double node = nodes_[i];
+            const double weight = weights_[i];
+            const double value = values_[i];
+            for (size_t k = 0; k < EVALUATE_BLOCK; k++) {
+                const double diff = q[k] - node;
+                hit |= diff == 0.0;
+                const double t = weight / diff;
+                numerator[k] += t * value;
+                denominator[k] += t;
+            }
+        }
+        for (size_t k = 0; k < EVALUATE_BLOCK; k++) {
+            result[start + k] = numerator[k] / denominator[k];
+        }
+        if (hit) {
+            /* a query on a node, redo the block on the scalar path */
+            for (size_t k = 0; k < EVALUATE_BLOCK; k++) {
+                result[start + k] = operator()(q[k]);
+            }
+        }
     }
-    return res;
 }
 
-double dimkashelk::Langrage::calculateFraction(const std::size_t index, const double x) const {
-    double res = 1.0;
-    double x_cur = points_[index].first;
-    for (size_t i = 0; i < points_.size(); i++) {
-        if (i != index) {
-            res *= (x - points_[i].first) / (x_cur - points_[i].first);
+void dimkashelk::Langrage::evaluate(const std::vector<double> &x, std::vector<double> &result) const {
+    result.resize(x.size());
+    evaluate(x.data(), x.size(), result.data());
+}
+
+void dimkashelk::Langrage::add(const double x, const double y) {
+    const size_t n = nodes_.size();
+    int exponent = 0;
+    const double product = product_of_differences(x, n, exponent);
+    for (size_t i = 0; i < n; i++) {
+        weights_[i] /= nodes_[i] - x;
+    }
+    /* the new weight is 2^exponent_ / product 2^exponent, the larger of it and the old ones becomes near 1 */
+    const int shift = std::max(exponent_ - exponent, 0);
+    for (size_t i = 0; i < n; i++) {
+        weights_[i] = std::ldexp(weights_[i], -shift);
+    }
+    nodes_.push_back(x);
+    values_.push_back(y);
+    weights_.push_back(std::ldexp(1.0 / product, exponent_ - exponent - shift));
+    exponent_ -= shift;
+    rescale();
+}
+
+std::size_t dimkashelk::Langrage::size() const {
+    return nodes_.size();
+}
+
+double dimkashelk::Langrage::product_of_differences(const double x, const size_t skip, int &exponent) const {
+    /* the product is kept as mantissa 2^exponent, it overflows for many nodes on a wide interval
+       and underflows on a narrow one */
+    double product = 1.0;
+    exponent = 0;
+    for (size_t j = 0; j < nodes_.size(); j++) {
+        if (j == skip) {
+            continue;
+        }
+        const double diff = x - nodes_[j];
+        if (diff == 0.0) {
+            throw std::logic_error("Check points");
+        }
+        int k = 0;
+        product = std::frexp(product * diff, &k);
+        exponent += k;
+    }
+    return product;
+}
+
+void dimkashelk::Langrage::rescale() {
+    /* the form is invariant to a common factor of the weights, a power of 2 keeps the largest near 1 exactly */
+    double largest = 0.0;
+    for (const double weight: weights_) {
+        largest = std::max(largest, std::fabs(weight));
+    }
+    if (largest > 0.0 && std::isfinite(largest)) {
+        int k = 0;
+        std::frexp(largest, &k);
+        for (double &weight: weights_) {
+            weight = std::ldexp(weight, -k);
         }
+        exponent_ -= k;
     }
-    return res;
 }
@@ -1,19 +1,47 @@
 #ifndef COMPUTATIONAL_MATHEMATICS_LANGRAGE_H
 #define COMPUTATIONAL_MATHEMATICS_LANGRAGE_H
 
+#include <cstddef>
 #include <vector>
 
 namespace dimkashelk {
+    /**
+     * \brief Lagrange polynomial in the barycentric form, weights are computed once and every evaluation
+     * takes O(n) with one division per node
+     */
     class Langrage {
     public:
         explicit Langrage(const std::vector<std::pair<double, double> > &points);
 
         double operator()(double x) const;
 
+        /**
+         * \brief evaluate at many points, a block of queries is processed per pass over the nodes
+         * \param x query points
+         * \param count number of queries
+         * \param result values of the polynomial, of size count
+         */
+        void evaluate(const double x[], std::size_t count, double result[]) const;
+
+        void evaluate(const std::vector<double> &x, std::vector<double> &result) const;
+
+        /**
+         * \brief add a node in O(n), the weights of the present nodes are updated
+         */
+        void add(double x, double y);
+
+        [[nodiscard]] std::size_t size() const;
+
     private:
-        const std::vector<std::pair<double, double> > points_;
+        std::vector<double> nodes_;
+        std::vector<double> values_;
+        std::vector<double> weights_;
+        /* weights_ hold the true weights multiplied by 2^exponent_ */
+        int exponent_;
 
-        double calculateFraction(std::size_t index, double x) const;
+        /* product of x - nodes_[j] over j != skip as the returned mantissa times 2^exponent */
+        double product_of_differences(double x, std::size_t skip, int &exponent) const;
+        void rescale();
     };
 }
 #endif
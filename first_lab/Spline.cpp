@@ -1,86 +1,253 @@
 #include "Spline.h"
 
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
+#include <utility>
 
-dimkashelk::Spline::Spline(const std::vector<std::pair<double, double> > &points) {
-    std::vector<double> B(points.size());
-    std::vector<double> C(points.size());
-    std::vector<double> D(points.size());
+#include "../common/Tridiagonal.h"
+#include "../common/Workspace.h"
 
-    const size_t count_minus_1 = points.size() - 1;
-    if (points.size() < 2) { throw std::logic_error("Check points"); }
-    if (points.size() > 2) {
-        D[0] = points[1].first - points[0].first;
-        C[1] = (points[1].second - points[0].second) / D[0];
+namespace {
+    constexpr std::size_t EVALUATE_BLOCK = 64;
+}
+
+dimkashelk::Spline::Spline(const std::vector<std::pair<double, double> > &points, ThreadPool *pool):
+    uniform_(false),
+    origin_(0.0),
+    inverse_step_(0.0) {
+    knots_.resize(points.size());
+    segments_.resize(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        knots_[i] = points[i].first;
+        segments_[i].a = points[i].second;
+    }
+    build(pool);
+}
+
+dimkashelk::Spline::Spline(std::vector<double> &&x, const std::vector<double> &y, ThreadPool *pool):
+    knots_(std::move(x)),
+    uniform_(false),
+    origin_(0.0),
+    inverse_step_(0.0) {
+    if (knots_.size() != y.size()) {
+        throw std::logic_error("Check points");
+    }
+    segments_.resize(y.size());
+    for (size_t i = 0; i < y.size(); i++) {
+        segments_[i].a = y[i];
+    }
+    build(pool);
+}
+
+void dimkashelk::Spline::append(const double x, const double y) {
+    append(&x, &y, 1);
+}
+
+void dimkashelk::Spline::append(const double x[], const double y[], const std::size_t count) {
+    const size_t old = knots_.size();
+    /* the whole batch is checked first, so a bad point leaves the spline as it was */
+    double previous = knots_.back();
+    for (size_t i = 0; i < count; i++) {
+        if (x[i] <= previous) {
+            throw std::logic_error("Check points");
+        }
+        previous = x[i];
+    }
+    for (size_t i = 0; i < count; i++) {
+        knots_.push_back(x[i]);
+        segments_.push_back({y[i], 0.0, 0.0, 0.0});
+    }
+    if (count == 0) {
+        return;
+    }
+    if (old < APPEND_WINDOW + 2) {
+        build(nullptr);
+        return;
+    }
+
+    /* the influence of the old end condition decays by about 0.27 per knot, the second derivative
+       at the start of the window is kept and the window is solved again with the end condition */
+    const size_t n = knots_.size();
+    const size_t k = old - 1 - APPEND_WINDOW;
+    const size_t m = n - 1 - k;
+    Workspace &workspace = thread_workspace();
+    Workspace::Scope scope(workspace);
+    double *lower = workspace.allocate<double>(m - 1);
+    double *diag = workspace.allocate<double>(m);
+    double *upper = workspace.allocate<double>(m - 1);
+    double *sigma = workspace.allocate<double>(m + 1);
+    sigma[0] = segments_[k].c / 3.0;
+    auto h = [this](const size_t i) { return knots_[i + 1] - knots_[i]; };
+    auto delta = [this, &h](const size_t i) { return (segments_[i + 1].a - segments_[i].a) / h(i); };
+    for (size_t i = k + 1; i + 1 < n; i++) {
+        const size_t j = i - k - 1;
+        diag[j] = 2.0 * (h(i - 1) + h(i));
+        upper[j] = h(i);
+        if (j > 0) {
+            lower[j - 1] = h(i - 1);
+        }
+        sigma[j + 1] = delta(i) - delta(i - 1);
+    }
+    sigma[1] -= h(k) * sigma[0];
+    diag[m - 1] = -h(n - 2);
+    lower[m - 2] = h(n - 2);
+    sigma[m] = (delta(n - 2) - delta(n - 3)) / (knots_[n - 1] - knots_[n - 3]) -
+               (delta(n - 3) - delta(n - 4)) / (knots_[n - 2] - knots_[n - 4]);
+    sigma[m] = -sigma[m] * h(n - 2) * h(n - 2) / (knots_[n - 1] - knots_[n - 4]);
+    details::tridiagonal(static_cast<int>(m), lower, diag, upper, sigma + 1);
+    set_coefficients(k, sigma);
+
+    if (uniform_) {
+        const double step = 1.0 / inverse_step_;
+        for (size_t i = old; i < n && uniform_; i++) {
+            uniform_ = std::fabs(knots_[i] - (origin_ + static_cast<double>(i) * step)) <= 1.0e-9 * step;
+        }
+    }
+}
+
+std::size_t dimkashelk::Spline::size() const {
+    return knots_.size();
+}
+
+void dimkashelk::Spline::build(ThreadPool *pool) {
+    const size_t count = knots_.size();
+    if (count < 2) { throw std::logic_error("Check points"); }
+    const std::vector<double> &x = knots_;
+    auto y = [this](const size_t i) { return segments_[i].a; };
+    Workspace &workspace = thread_workspace();
+    Workspace::Scope scope(workspace);
+    double *B = workspace.allocate<double>(count);
+    double *C = workspace.allocate<double>(count);
+    double *D = workspace.allocate<double>(count);
+
+    const size_t count_minus_1 = count - 1;
+    if (count > 2) {
+        D[0] = x[1] - x[0];
+        C[1] = (y(1) - y(0)) / D[0];
         for (size_t i = 2; i <= count_minus_1; i++) {
-            D[i - 1] = points[i].first - points[i - 1].first;
+            D[i - 1] = x[i] - x[i - 1];
             B[i - 1] = 2.0 * (D[i - 2] + D[i - 1]);
-            C[i] = (points[i].second - points[i - 1].second) / D[i - 1];
+            C[i] = (y(i) - y(i - 1)) / D[i - 1];
             C[i - 1] = C[i] - C[i - 1];
         }
         B[0] = -D[0];
-        B[points.size() - 1] = -D[points.size() - 2];
+        B[count - 1] = -D[count - 2];
         C[0] = 0.0;
-        C[points.size() - 1] = 0.0;
-        if (points.size() != 3) {
-            C[0] = C[2] / (points[3].first - points[1].first) - C[1] / (points[2].first - points[0].first);
-            C[points.size() - 1] = C[points.size() - 2] /
-                                   (points[points.size() - 1].first - points[points.size() - 3].first) -
-                                   C[points.size() - 3] /
-                                   (points[points.size() - 2].first - points[points.size() - 4].first);
-            C[0] = C[0] * D[0] * D[0] / (points[3].first - points[0].first);
-            C[points.size() - 1] = -C[points.size() - 1] * D[points.size() - 2] * D[points.size() - 2] /
-                                   (points[points.size() - 1].first - points[points.size() - 4].first);
+        C[count - 1] = 0.0;
+        if (count != 3) {
+            C[0] = C[2] / (x[3] - x[1]) - C[1] / (x[2] - x[0]);
+            C[count - 1] = C[count - 2] / (x[count - 1] - x[count - 3]) -
+                           C[count - 3] / (x[count - 2] - x[count - 4]);
+            C[0] = C[0] * D[0] * D[0] / (x[3] - x[0]);
+            C[count - 1] = -C[count - 1] * D[count - 2] * D[count - 2] / (x[count - 1] - x[count - 4]);
         }
-        for (size_t i = 2; i <= points.size(); i++) {
-            const double current = D[i - 2] / B[i - 2];
-            B[i - 1] = B[i - 1] - current * D[i - 2];
-            C[i - 1] = C[i - 1] - current * C[i - 2];
-        }
-        C[points.size() - 1] = C[points.size() - 1] / B[points.size() - 1];
-        for (size_t i = 1; i <= count_minus_1; i++) {
-            const size_t d = points.size() - i;
-            C[d - 1] = (C[d - 1] - D[d - 1] * C[d]) / B[d - 1];
-        }
-        B[points.size() - 1] = (points[points.size() - 1].second - points[count_minus_1 - 1].second) /
-                               D[count_minus_1 - 1] + D[count_minus_1 - 1] *
-                               (C[count_minus_1 - 1] + 2. * C[points.size() - 1]);
-        for (size_t i = 1; i <= count_minus_1; i++) {
-            B[i - 1] = (points[i].second - points[i - 1].second) / D[i - 1] - D[i - 1] * (C[i] + 2. * C[i - 1]);
-            D[i - 1] = (C[i] - C[i - 1]) / D[i - 1];
-            C[i - 1] = 3.0 * C[i - 1];
-        }
-        C[points.size() - 1] = 3. * C[points.size() - 1];
-        D[points.size() - 1] = D[points.size() - 2];
+        details::tridiagonal(static_cast<int>(count), D, B, D, C, pool);
+        set_coefficients(0, C);
     } else {
-        B[0] = (points[1].second - points[0].second) / (points[1].first - points[0].first);
-        C[0] = 0.0;
-        D[0] = 0.0;
-        B[1] = B[0];
-        C[1] = 0.0;
-        D[1] = 0.0;
-    }
-    points_ = points;
-    for (const auto &point: points) {
-        a_.push_back(point.second);
-    }
-    b_ = B;
-    c_ = C;
-    d_ = D;
+        const double slope = (y(1) - y(0)) / (x[1] - x[0]);
+        segments_[0] = {y(0), slope, 0.0, 0.0};
+        segments_[1] = {y(1), slope, 0.0, 0.0};
+    }
+
+    /* uniform knots give the interval by one multiplication, locate() corrects rounding */
+    origin_ = knots_[0];
+    const double step = (knots_[count - 1] - knots_[0]) / static_cast<double>(count - 1);
+    inverse_step_ = (step != 0.0) ? 1.0 / step : 0.0;
+    uniform_ = step > 0.0;
+    for (size_t i = 1; i < count && uniform_; i++) {
+        uniform_ = std::fabs(knots_[i] - (origin_ + static_cast<double>(i) * step)) <= 1.0e-9 * step;
+    }
+}
+
+void dimkashelk::Spline::set_coefficients(const std::size_t first, const double sigma[]) {
+    /* sigma[i - first] is a third of the second derivative at knot i */
+    const size_t count = knots_.size();
+    for (size_t i = first; i + 1 < count; i++) {
+        const double h = knots_[i + 1] - knots_[i];
+        const double s0 = sigma[i - first];
+        const double s1 = sigma[i + 1 - first];
+        SplineSegment &s = segments_[i];
+        s.b = (segments_[i + 1].a - s.a) / h - h * (s1 + 2. * s0);
+        s.d = (s1 - s0) / h;
+        s.c = 3.0 * s0;
+    }
+    const double h = knots_[count - 1] - knots_[count - 2];
+    const double s0 = sigma[count - 2 - first];
+    const double s1 = sigma[count - 1 - first];
+    SplineSegment &s = segments_[count - 1];
+    s.b = (s.a - segments_[count - 2].a) / h + h * (s0 + 2. * s1);
+    s.c = 3. * s1;
+    s.d = segments_[count - 2].d;
 }
 
 double dimkashelk::Spline::operator()(const double number) const {
-    size_t i = 1;
-    size_t j = points_.size() + 1;
-    do {
-        const size_t k = (i + j) / 2;
-        if (number < points_[k - 1].first) {
-            j = k;
+    const std::size_t i = locate(number);
+    const SplineSegment &s = segments_[i];
+    const double DX = number - knots_[i];
+    return s.a + DX * (s.b + DX * (s.c + DX * s.d));
+}
+
+void dimkashelk::Spline::evaluate(const double numbers[], const std::size_t count, double result[]) const {
+    std::size_t index[EVALUATE_BLOCK];
+    double dx[EVALUATE_BLOCK];
+    std::size_t current = 0;
+    for (std::size_t start = 0; start < count; start += EVALUATE_BLOCK) {
+        const std::size_t size = std::min(EVALUATE_BLOCK, count - start);
+        for (std::size_t k = 0; k < size; k++) {
+            const double number = numbers[start + k];
+            current = advance(current, number);
+            index[k] = current;
+            dx[k] = number - knots_[current];
+        }
+        /* Horner on gathered coefficients, free of branches */
+        double *out = result + start;
+        for (std::size_t k = 0; k < size; k++) {
+            const SplineSegment &s = segments_[index[k]];
+            out[k] = s.a + dx[k] * (s.b + dx[k] * (s.c + dx[k] * s.d));
         }
-        if (number >= points_[k - 1].first) {
-            i = k;
+    }
+}
+
+void dimkashelk::Spline::evaluate(const std::vector<double> &numbers, std::vector<double> &result) const {
+    result.resize(numbers.size());
+    evaluate(numbers.data(), numbers.size(), result.data());
+}
+
+bool dimkashelk::Spline::is_uniform() const {
+    return uniform_;
+}
+
+std::size_t dimkashelk::Spline::locate(const double number) const {
+    /* the last knot with knot <= number, the first one for numbers before the knots */
+    const std::size_t last = knots_.size() - 1;
+    if (uniform_) {
+        const double position = (number - origin_) * inverse_step_;
+        std::size_t i = 0;
+        if (position >= static_cast<double>(last)) {
+            i = last;
+        } else if (position > 0.0) {
+            i = static_cast<std::size_t>(position);
         }
-    } while (j > i + 1);
-    const double DX = number - points_[i - 1].first;
-    return a_[i - 1] + DX * b_[i - 1] + DX * DX * c_[i - 1] + DX * DX * DX * d_[i - 1];
+        while (i < last && number >= knots_[i + 1]) i++;
+        while (i > 0 && number < knots_[i]) i--;
+        return i;
+    }
+    const auto it = std::upper_bound(knots_.begin() + 1, knots_.end(), number);
+    return static_cast<std::size_t>(it - knots_.begin()) - 1;
+}
+
+std::size_t dimkashelk::Spline::advance(std::size_t index, const double number) const {
+    /* a short walk from the previous interval, otherwise a fresh search */
+    const std::size_t last = knots_.size() - 1;
+    if (index > 0 && number < knots_[index]) {
+        return locate(number);
+    }
+    for (int k = 0; k < 4; k++) {
+        if (index == last || number < knots_[index + 1]) {
+            return index;
+        }
+        index++;
+    }
+    return locate(number);
 }
@@ -1,21 +1,85 @@
 #ifndef SPLINE_H
 #define SPLINE_H
 
+#include <cstddef>
 #include <vector>
 
 namespace dimkashelk {
+    /**
+     * \brief coefficients of one interval, s(x) = a + b * dx + c * dx^2 + d * dx^3, dx = x - knot
+     */
+    struct alignas(32) SplineSegment {
+        double a;
+        double b;
+        double c;
+        double d;
+    };
+
+    class ThreadPool;
+
+    /**
+     * \brief cubic spline with the end conditions of Forsythe, Malcolm and Moler, the third derivative
+     * at each end matches the cubic through the last four points
+     */
     class Spline {
     public:
-        explicit Spline(const std::vector<std::pair<double, double> > &points);
+        /**
+         * \brief number of knots solved again by append()
+         */
+        static constexpr std::size_t APPEND_WINDOW = 40;
+
+        /**
+         * \param points knots in increasing order with values
+         * \param pool threads for the partitioned tridiagonal solve, nullptr for the serial one
+         */
+        explicit Spline(const std::vector<std::pair<double, double> > &points, ThreadPool *pool = nullptr);
+
+        /**
+         * \param x knots in increasing order, the buffer is taken over by the spline
+         * \param y values at the knots
+         * \param pool threads for the partitioned tridiagonal solve, nullptr for the serial one
+         */
+        Spline(std::vector<double> &&x, const std::vector<double> &y, ThreadPool *pool = nullptr);
 
         double operator()(double number) const;
 
+        /**
+         * \brief evaluate at many points, sorted queries are found by walking the knots
+         * \param numbers query points
+         * \param count number of queries
+         * \param result values of the spline, of size count
+         */
+        void evaluate(const double numbers[], std::size_t count, double result[]) const;
+
+        void evaluate(const std::vector<double> &numbers, std::vector<double> &result) const;
+
+        /**
+         * \brief add knots after the last one, only the last APPEND_WINDOW intervals are computed again.
+         * The result differs from a new spline by less than rounding, the window keeps the second
+         * derivative at its first knot and the influence of that choice has decayed there.
+         */
+        void append(double x, double y);
+
+        void append(const double x[], const double y[], std::size_t count);
+
+        [[nodiscard]] bool is_uniform() const;
+
+        [[nodiscard]] std::size_t size() const;
+
     private:
-        std::vector<std::pair<double, double>> points_;
-        std::vector<double> a_;
-        std::vector<double> b_;
-        std::vector<double> c_;
-        std::vector<double> d_;
+        std::vector<double> knots_;
+        std::vector<SplineSegment> segments_;
+        bool uniform_;
+        double origin_;
+        double inverse_step_;
+
+        [[nodiscard]] std::size_t locate(double number) const;
+
+        [[nodiscard]] std::size_t advance(std::size_t index, double number) const;
+
+        void build(ThreadPool *pool);
+
+        void set_coefficients(std::size_t first, const double sigma[]);
     };
 }
 #endif
@@ -0,0 +1,46 @@
+#include "BandMatrix.h"
+
+#include <stdexcept>
+
+dimkashelk::BandMatrix::BandMatrix(): size_(0),
+                                      lower_(0),
+                                      upper_(0),
+                                      stride_(1) {
+}
+
+dimkashelk::BandMatrix::BandMatrix(const int size, const int lower, const int upper): size_(size),
+    lower_(lower),
+    upper_(upper),
+    stride_(lower + upper + 1) {
+    if (size < 1 || lower < 0 || upper < 0 || lower >= size || upper >= size) {
+        throw std::logic_error("Check size of band matrix");
+    }
+    data_.assign(static_cast<std::size_t>(size) * stride_, 0.0);
+}
+
+dimkashelk::BandMatrix::BandMatrix(const std::vector<std::vector<double> > &matrix, const int lower,
+                                   const int upper): BandMatrix(static_cast<int>(matrix.size()), lower, upper) {
+    for (const auto &row: matrix) {
+        if (row.size() != matrix.size()) {
+            throw std::logic_error("Check size of matrix");
+        }
+    }
+    for (int i = 0; i < size_; i++) {
+        for (int j = 0; j < size_; j++) {
+            if (in_band(i, j)) {
+                operator()(i, j) = matrix[i][j];
+            }
+        }
+    }
+}
+
+double dimkashelk::BandMatrix::get(const int i, const int j) const {
+    if (i < 0 || j < 0 || i >= size_ || j >= size_) {
+        throw std::out_of_range("Check index");
+    }
+    return in_band(i, j) ? operator()(i, j) : 0.0;
+}
+
+bool dimkashelk::BandMatrix::in_band(const int i, const int j) const {
+    return i - lower_ <= j && j <= i + upper_;
+}
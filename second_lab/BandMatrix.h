@@ -0,0 +1,53 @@
+#ifndef BAND_MATRIX_H
+#define BAND_MATRIX_H
+#include <cstddef>
+#include <vector>
+
+namespace dimkashelk {
+    /**
+     * \brief square band matrix with lower subdiagonals and upper superdiagonals in compact storage,
+     * the band of column j is contiguous, element (i, j) is data[j * stride + upper + i - j]
+     */
+    class BandMatrix {
+    public:
+        BandMatrix();
+
+        BandMatrix(int size, int lower, int upper);
+
+        /**
+         * \brief band part of a dense matrix, elements outside the band are ignored
+         */
+        BandMatrix(const std::vector<std::vector<double> > &matrix, int lower, int upper);
+
+        /**
+         * \brief element inside the band, i - lower <= j <= i + upper is not checked
+         */
+        double &operator()(const int i, const int j) {
+            return data_[static_cast<std::size_t>(j) * stride_ + upper_ + i - j];
+        }
+
+        double operator()(const int i, const int j) const {
+            return data_[static_cast<std::size_t>(j) * stride_ + upper_ + i - j];
+        }
+
+        /**
+         * \brief element (i, j), zero outside the band
+         */
+        [[nodiscard]] double get(int i, int j) const;
+        [[nodiscard]] bool in_band(int i, int j) const;
+
+        [[nodiscard]] const double *get_data() const { return data_.data(); }
+        [[nodiscard]] int get_size() const { return size_; }
+        [[nodiscard]] int get_lower() const { return lower_; }
+        [[nodiscard]] int get_upper() const { return upper_; }
+        [[nodiscard]] int get_stride() const { return stride_; }
+
+    private:
+        int size_;
+        int lower_;
+        int upper_;
+        int stride_;
+        std::vector<double> data_;
+    };
+}
+#endif
@@ -0,0 +1,242 @@
+#include "BandSolve.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+#include "../common/Statistics.h"
+#include "../common/Workspace.h"
+
+int dimkashelk::details::band_decomp(int n, int kl, int ku,
+                                     double *ab, int ldab, double *cond,
+                                     int pivot[], int *flag)
+
+/* Purpose ...
+   -------
+   Decomposes a band matrix by gaussian elimination with partial
+   pivoting and estimates the condition of the matrix, decomp()
+   for band storage.
+
+   Input ...
+   -----
+   n    = order of the matrix
+   kl   = number of subdiagonals
+   ku   = number of superdiagonals
+   ab   = matrix in band storage, element (i, j) is
+          ab[j * ldab + kl + ku + i - j], the first kl elements
+          of every column must be zero, they receive the fill-in
+   ldab = column dimension of ab, ldab >= 2 * kl + ku + 1
+
+   Output ...
+   ------
+   ab    = U with kl + ku superdiagonals and the multipliers of L
+           below the diagonal
+   cond  = estimate of the condition of the matrix in the 1-norm,
+           1.0e+32 for a singular matrix
+   pivot = pivot[k] is the row interchanged with row k in step k
+   flag  = 0 : successful execution
+           2 : illegal user input
+           3 : matrix is singular
+
+   Notes ...
+   -----
+   The elimination is that of LAPACK dgbtf2, the condition estimate
+   is the one step of inverse iteration of decomp(). Uses no work
+   space beyond b[] of the estimate, which is allocated here.
+*/
+
+{
+    NUMERICS_TIMER(FACTOR);
+    NUMERICS_COUNT(FACTORIZATIONS, 1);
+    const double EPSILON = 2.2e-16;
+    const int kv = kl + ku;
+    double anorm, ynorm, znorm, t, ek, pvt;
+    int i, j, k, m, km, ju;
+
+    *flag = 0;
+    if (ab == nullptr || pivot == nullptr || n < 1 || kl < 0 || ku < 0 || ldab < 2 * kl + ku + 1) {
+        *flag = 2;
+        return (0);
+    }
+    auto at = [=](const int r, const int c) -> double & {
+        return ab[static_cast<std::size_t>(c) * ldab + kv + r - c];
+    };
+
+    /* --- compute 1-norm of a --- */
+    anorm = 0.0;
+    for (j = 0; j < n; ++j) {
+        t = 0.0;
+        for (i = std::max(0, j - ku); i <= std::min(n - 1, j + kl); ++i) t += std::fabs(at(i, j));
+        anorm = std::max(anorm, t);
+    }
+
+    ju = 0;
+    for (k = 0; k < n; ++k) {
+        km = std::min(kl, n - 1 - k);
+        /* Find pivot in the lower part of the kth column */
+        m = 0;
+        pvt = std::fabs(at(k, k));
+        for (i = 1; i <= km; ++i) {
+            t = std::fabs(at(k + i, k));
+            if (t > pvt) {
+                m = i;
+                pvt = t;
+            }
+        }
+        pivot[k] = k + m;
+        if (pvt <= anorm * EPSILON) {
+            /* Singular or nearly singular */
+            *cond = 1.0e+32;
+            *flag = 3;
+            return (0);
+        }
+        /* the columns reached by U grow with the interchanges */
+        ju = std::max(ju, std::min(k + ku + m, n - 1));
+        if (m != 0) {
+            NUMERICS_COUNT(PIVOT_SWAPS, 1);
+            for (j = k; j <= ju; ++j) std::swap(at(k, j), at(k + m, j));
+        }
+        pvt = at(k, k);
+        for (i = 1; i <= km; ++i) at(k + i, k) /= pvt;
+        for (j = k + 1; j <= ju; ++j) {
+            t = at(k, j);
+            if (t == 0.0) continue;
+            double *column = std::addressof(at(k + 1, j));
+            const double *multipliers = std::addressof(at(k + 1, k));
+            for (i = 0; i < km; ++i) column[i] -= multipliers[i] * t;
+        }
+    }
+
+    /* cond = (1-norm of a)*(an estimate of 1-norm of a-inverse),
+       y solves (a-transpose)*y = e, z solves a*z = y */
+    Workspace &workspace = thread_workspace();
+    Workspace::Scope scope(workspace);
+    double *work = workspace.allocate<double>(n);
+    for (k = 0; k < n; ++k) {
+        t = 0.0;
+        for (i = std::max(0, k - kv); i < k; ++i) t += at(i, k) * work[i];
+        ek = t < 0.0 ? -1.0 : 1.0;
+        work[k] = -(ek + t) / at(k, k);
+    }
+    for (k = n - 2; k >= 0; --k) {
+        km = std::min(kl, n - 1 - k);
+        t = 0.0;
+        for (i = 1; i <= km; ++i) t += at(k + i, k) * work[k + i];
+        work[k] -= t;
+        m = pivot[k];
+        if (m != k) std::swap(work[m], work[k]);
+    }
+    ynorm = 0.0;
+    for (i = 0; i < n; ++i) ynorm += std::fabs(work[i]);
+    band_solve(n, kl, ku, ab, ldab, pivot, work);
+    znorm = 0.0;
+    for (i = 0; i < n; ++i) znorm += std::fabs(work[i]);
+
+    *cond = anorm * znorm / ynorm;
+    if (*cond < 1.0) *cond = 1.0;
+    if (*cond + 1.0 == *cond) *flag = 3;
+    return (0);
+} /* --- end of function band_decomp() --- */
+
+int dimkashelk::details::band_solve(int n, int kl, int ku,
+                                    const double *ab, int ldab,
+                                    const int pivot[], double b[])
+
+/* Purpose :
+   -------
+   Solution of a * x = b with the factors of band_decomp(),
+   b is overwritten by x.
+*/
+
+{
+    NUMERICS_TIMER(SOLVE);
+    NUMERICS_COUNT(SOLVES, 1);
+    const int kv = kl + ku;
+    int i, j, km, m;
+    double t;
+
+    /* Forward elimination: apply interchanges and multipliers. */
+    for (j = 0; j < n - 1; ++j) {
+        km = std::min(kl, n - 1 - j);
+        m = pivot[j];
+        if (m != j) std::swap(b[m], b[j]);
+        t = b[j];
+        const double *multipliers = ab + (static_cast<std::size_t>(j) * ldab + kv + 1);
+        for (i = 0; i < km; ++i) b[j + 1 + i] -= multipliers[i] * t;
+    }
+
+    /* Back substitution, by columns of U. */
+    for (j = n - 1; j >= 0; --j) {
+        const double *column = ab + static_cast<std::size_t>(j) * ldab;
+        b[j] /= column[kv];
+        t = b[j];
+        const int i0 = std::max(0, j - kv);
+        for (i = i0; i < j; ++i) b[i] -= column[kv + i - j] * t;
+    }
+    return (0);
+} /* --- end of function band_solve() --- */
+
+dimkashelk::BandSolve::BandSolve(): size_(0),
+                                    lower_(0),
+                                    upper_(0),
+                                    ldab_(0),
+                                    cond_(0.0),
+                                    flag_(0) {
+}
+
+void dimkashelk::BandSolve::operator()(const BandMatrix &matrix) {
+    if (matrix.get_size() == 0) {
+        throw std::logic_error("Check matrix");
+    }
+    size_ = matrix.get_size();
+    lower_ = matrix.get_lower();
+    upper_ = matrix.get_upper();
+    ldab_ = 2 * lower_ + upper_ + 1;
+    factors_.assign(static_cast<std::size_t>(size_) * ldab_, 0.0);
+    pivot_.resize(size_);
+    const int stride = matrix.get_stride();
+    for (int j = 0; j < size_; j++) {
+        /* the first lower_ elements of every column are left zero for the fill-in */
+        std::copy(matrix.get_data() + static_cast<std::size_t>(j) * stride,
+                  matrix.get_data() + static_cast<std::size_t>(j + 1) * stride,
+                  factors_.data() + (static_cast<std::size_t>(j) * ldab_ + lower_));
+    }
+    details::band_decomp(size_, lower_, upper_, factors_.data(), ldab_, std::addressof(cond_), pivot_.data(),
+                         std::addressof(flag_));
+}
+
+void dimkashelk::BandSolve::operator()(const std::vector<double> &matrix_right) {
+    if (size_ == 0 || static_cast<int>(matrix_right.size()) != size_) {
+        throw std::logic_error("Check data");
+    }
+    if (flag_ != 0) {
+        throw std::logic_error("Check matrix, it is singular");
+    }
+    result_ = matrix_right;
+    details::band_solve(size_, lower_, upper_, factors_.data(), ldab_, pivot_.data(), result_.data());
+}
+
+void dimkashelk::BandSolve::operator()(const BandMatrix &matrix_left, const std::vector<double> &matrix_right) {
+    if (matrix_left.get_size() != static_cast<int>(matrix_right.size())) {
+        throw std::logic_error("Check data");
+    }
+    operator()(matrix_left);
+    operator()(matrix_right);
+}
+
+std::vector<double> dimkashelk::BandSolve::get_result() const {
+    return result_;
+}
+
+double dimkashelk::BandSolve::get_cond() const {
+    return cond_;
+}
+
+int dimkashelk::BandSolve::get_flag() const {
+    return flag_;
+}
+
+int dimkashelk::BandSolve::get_size() const {
+    return size_;
+}
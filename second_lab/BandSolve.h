@@ -0,0 +1,55 @@
+#ifndef BAND_SOLVE_H
+#define BAND_SOLVE_H
+#include <vector>
+
+#include "BandMatrix.h"
+
+namespace dimkashelk {
+    namespace details {
+        int band_decomp(int n, int kl, int ku,
+                        double *ab, int ldab, double *cond,
+                        int pivot[], int *flag);
+
+        int band_solve(int n, int kl, int ku,
+                       const double *ab, int ldab,
+                       const int pivot[], double b[]);
+    }
+
+    /**
+     * \brief LU factorization with partial pivoting of a band matrix in compact storage,
+     * O(n * kl * (kl + ku)) work and O(n * (2 kl + ku)) memory instead of the O(n^3) and O(n^2) of Decomp
+     */
+    class BandSolve {
+    public:
+        BandSolve();
+
+        /**
+         * \brief factorize a copy of the matrix, the factors are reused by operator()(rhs)
+         */
+        void operator()(const BandMatrix &matrix);
+
+        /**
+         * \brief solve with the last factorization, only O(n * (2 kl + ku)) work per call
+         */
+        void operator()(const std::vector<double> &matrix_right);
+
+        void operator()(const BandMatrix &matrix_left, const std::vector<double> &matrix_right);
+
+        [[nodiscard]] std::vector<double> get_result() const;
+        [[nodiscard]] double get_cond() const;
+        [[nodiscard]] int get_flag() const;
+        [[nodiscard]] int get_size() const;
+
+    private:
+        int size_;
+        int lower_;
+        int upper_;
+        int ldab_;
+        double cond_;
+        int flag_;
+        std::vector<double> factors_;
+        std::vector<int> pivot_;
+        std::vector<double> result_;
+    };
+}
+#endif
@@ -0,0 +1,425 @@
+#ifndef BATCH_DECOMP_H
+#define BATCH_DECOMP_H
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace dimkashelk {
+    /* number of systems processed together, one per SIMD lane */
+    constexpr int BATCH_LANES = 8;
+
+    namespace details {
+        template<int N>
+        void solve_batch(const double *a, double b[], const int pivot[]);
+
+        template<int N>
+        void decomp_batch(double *a, double cond[], int pivot[], int flag[])
+
+        /* Purpose ...
+           -------
+           decomp() for BATCH_LANES matrices of order N at once.
+
+           Storage ...
+           -------
+           The matrices are interleaved, element (i, j) of the l-th
+           matrix is a[(i * N + j) * BATCH_LANES + l], pivot[k] of the
+           l-th matrix is pivot[k * BATCH_LANES + l], cond[l] and
+           flag[l] belong to the l-th matrix.
+
+           Notes ...
+           -----
+           Every lane performs the same operations in the same order
+           as decomp(), so the factors, the pivot vector and cond are
+           those decomp() gives for the matrix. Row interchanges and
+           the singularity tests are done with selects instead of
+           branches, so all the loops over the lanes are vectorized.
+           A singular lane gets flag 3 and cond 1.0e+32, the other
+           lanes are not affected. No memory is allocated.
+        */
+
+        {
+            constexpr int L = BATCH_LANES;
+            constexpr double EPSILON = 2.2e-16;
+            double anorm[L], small[L], t[L], pvt[L], ek[L], ynorm[L], znorm[L];
+            double work[N * L];
+            int m[L], bad[L];
+            int i, j, k, l;
+
+            for (l = 0; l < L; ++l) {
+                flag[l] = 0;
+                bad[l] = 0;
+                pivot[(N - 1) * L + l] = 1;
+            }
+
+            /* --- compute 1-norm of a --- */
+            for (l = 0; l < L; ++l) anorm[l] = 0.0;
+            for (j = 0; j < N; ++j) {
+                for (l = 0; l < L; ++l) t[l] = 0.0;
+                for (i = 0; i < N; ++i) {
+                    const double *pa = a + (i * N + j) * L;
+                    for (l = 0; l < L; ++l) t[l] += std::fabs(pa[l]);
+                }
+                for (l = 0; l < L; ++l) anorm[l] = (t[l] > anorm[l]) ? t[l] : anorm[l];
+            }
+            for (l = 0; l < L; ++l) small[l] = anorm[l] * EPSILON;
+
+            if (N == 1) {
+                for (l = 0; l < L; ++l) {
+                    cond[l] = (a[l] == 0.0) ? 1.0e+32 : 1.0;
+                    flag[l] = (a[l] == 0.0) ? 3 : 0;
+                }
+                return;
+            }
+
+            /* Apply Gaussian elimination with partial pivoting. */
+            for (k = 0; k < N - 1; ++k) {
+                double *pk = a + (k * N) * L;
+
+                /* Find pivot and label as row m. */
+                for (l = 0; l < L; ++l) {
+                    m[l] = k;
+                    pvt[l] = std::fabs(pk[k * L + l]);
+                }
+                for (i = k + 1; i < N; ++i) {
+                    const double *pa = a + (i * N + k) * L;
+                    for (l = 0; l < L; ++l) {
+                        const double v = std::fabs(pa[l]);
+                        m[l] = (v > pvt[l]) ? i : m[l];
+                        pvt[l] = (v > pvt[l]) ? v : pvt[l];
+                    }
+                }
+                for (l = 0; l < L; ++l) {
+                    pivot[k * L + l] = m[l];
+                    pivot[(N - 1) * L + l] = (m[l] != k) ? -pivot[(N - 1) * L + l] : pivot[(N - 1) * L + l];
+                }
+
+                /* Interchange rows m and k for the lower partition,
+                   lanes with m == k swap the row with itself. */
+                for (j = k; j < N; ++j) {
+                    for (l = 0; l < L; ++l) {
+                        double *pa = a + (m[l] * N + j) * L + l;
+                        const double x = pk[j * L + l];
+                        pk[j * L + l] = *pa;
+                        *pa = x;
+                    }
+                }
+
+                /* Mark the lanes with too small pivot, they go on with
+                   a unit pivot so that no NaN is produced */
+                for (l = 0; l < L; ++l) {
+                    pvt[l] = pk[k * L + l];
+                    bad[l] = (std::fabs(pvt[l]) < small[l]) ? 1 : bad[l];
+                    pvt[l] = bad[l] ? 1.0 : pvt[l];
+                }
+
+                /* eliminate the lower matrix partition by rows
+                   and store the multipliers in the k sub-column */
+                for (i = k + 1; i < N; ++i) {
+                    double *pa = a + (i * N) * L;
+                    for (l = 0; l < L; ++l) {
+                        t[l] = -(pa[k * L + l] / pvt[l]);
+                        pa[k * L + l] = t[l];
+                        /* the multipliers are free of the scale of the matrix */
+                        t[l] = (std::fabs(t[l]) > EPSILON) ? t[l] : 0.0;
+                    }
+                    for (j = k + 1; j < N; ++j) {
+                        for (l = 0; l < L; ++l) pa[j * L + l] += pk[j * L + l] * t[l];
+                    }
+                }
+            }
+
+            /* Estimate the condition as decomp() does.
+               Solve (a-transpose)*y = e   */
+            for (k = 0; k < N; ++k) {
+                for (l = 0; l < L; ++l) t[l] = 0.0;
+                for (i = 0; i < k; ++i) {
+                    const double *pa = a + (i * N + k) * L;
+                    for (l = 0; l < L; ++l) t[l] += pa[l] * work[i * L + l];
+                }
+                const double *pa = a + (k * N + k) * L;
+                for (l = 0; l < L; ++l) {
+                    ek[l] = (t[l] < 0.0) ? -1.0 : 1.0;
+                    bad[l] = (std::fabs(pa[l]) < small[l]) ? 1 : bad[l];
+                    work[k * L + l] = -(ek[l] + t[l]) / (bad[l] ? 1.0 : pa[l]);
+                }
+            }
+
+            for (k = N - 2; k >= 0; --k) {
+                for (l = 0; l < L; ++l) t[l] = 0.0;
+                for (i = k + 1; i < N; ++i) {
+                    const double *pa = a + (i * N + k) * L;
+                    for (l = 0; l < L; ++l) t[l] += pa[l] * work[i * L + l];
+                }
+                for (l = 0; l < L; ++l) {
+                    work[k * L + l] = t[l];
+                    m[l] = pivot[k * L + l];
+                }
+                for (i = k + 1; i < N; ++i) {
+                    for (l = 0; l < L; ++l) {
+                        const double x = work[k * L + l];
+                        const double y = work[i * L + l];
+                        work[k * L + l] = (m[l] == i) ? y : x;
+                        work[i * L + l] = (m[l] == i) ? x : y;
+                    }
+                }
+            }
+
+            for (l = 0; l < L; ++l) ynorm[l] = 0.0;
+            for (i = 0; i < N; ++i) {
+                for (l = 0; l < L; ++l) ynorm[l] += std::fabs(work[i * L + l]);
+            }
+
+            /* --- solve a * z = y */
+            for (l = 0; l < L; ++l) {
+                if (bad[l]) {
+                    /* keep the singular lanes finite */
+                    for (i = 0; i < N; ++i) work[i * L + l] = 0.0;
+                }
+            }
+            solve_batch<N>(a, work, pivot);
+
+            for (l = 0; l < L; ++l) znorm[l] = 0.0;
+            for (i = 0; i < N; ++i) {
+                for (l = 0; l < L; ++l) znorm[l] += std::fabs(work[i * L + l]);
+            }
+
+            /* --- estimate condition --- */
+            for (l = 0; l < L; ++l) {
+                double c = anorm[l] * znorm[l] / ynorm[l];
+                if (c < 1.0) c = 1.0;
+                cond[l] = bad[l] ? 1.0e+32 : c;
+                flag[l] = (bad[l] || c + 1.0 == c) ? 3 : 0;
+            }
+        }
+
+        template<int N>
+        void solve_batch(const double *a, double b[], const int pivot[])
+
+        /* Purpose :
+           -------
+           solve() for BATCH_LANES systems of order N at once, a and
+           pivot are obtained from decomp_batch(), the i-th element
+           of the l-th right hand side is b[i * BATCH_LANES + l].
+           b is overwritten by the solutions.
+        */
+
+        {
+            constexpr int L = BATCH_LANES;
+            double t[L];
+            int i, j, k, l;
+
+            if (N == 1) {
+                for (l = 0; l < L; ++l) b[l] /= a[l];
+                return;
+            }
+
+            /* Forward elimination: apply multipliers. */
+            for (k = 0; k < N - 1; k++) {
+                const int *m = pivot + k * L;
+                for (i = k + 1; i < N; ++i) {
+                    for (l = 0; l < L; ++l) {
+                        const double x = b[k * L + l];
+                        const double y = b[i * L + l];
+                        b[k * L + l] = (m[l] == i) ? y : x;
+                        b[i * L + l] = (m[l] == i) ? x : y;
+                    }
+                }
+                for (i = k + 1; i < N; ++i) {
+                    const double *pa = a + (i * N + k) * L;
+                    for (l = 0; l < L; ++l) b[i * L + l] += pa[l] * b[k * L + l];
+                }
+            }
+
+            /* Back substitution. */
+            for (k = N - 1; k >= 0; --k) {
+                for (l = 0; l < L; ++l) t[l] = b[k * L + l];
+                for (j = k + 1; j < N; ++j) {
+                    const double *pa = a + (k * N + j) * L;
+                    for (l = 0; l < L; ++l) t[l] -= pa[l] * b[j * L + l];
+                }
+                const double *pa = a + (k * N + k) * L;
+                for (l = 0; l < L; ++l) b[k * L + l] = t[l] / pa[l];
+            }
+        }
+    }
+
+    template<int N>
+    class BatchSolve;
+
+    /**
+     * \brief LU factorizations of many matrices of order N stored interleaved by BATCH_LANES,
+     * all the memory is allocated by the constructor
+     */
+    template<int N>
+    class BatchDecomp {
+        static_assert(N >= 1, "Check order of matrices");
+        friend class BatchSolve<N>;
+
+    public:
+        /**
+         * \brief
+         * \param count number of matrices
+         */
+        explicit BatchDecomp(const int count): count_(count),
+                                               blocks_((std::max(count, 0) + BATCH_LANES - 1) / BATCH_LANES),
+                                               data_(get_size(std::max(count, 0))),
+                                               pivot_(static_cast<std::size_t>(blocks_) * N * BATCH_LANES),
+                                               cond_(static_cast<std::size_t>(blocks_) * BATCH_LANES),
+                                               flag_(static_cast<std::size_t>(blocks_) * BATCH_LANES) {
+            if (count < 1) {
+                throw std::logic_error("Check count");
+            }
+            fill_padding();
+        }
+
+        /**
+         * \brief number of doubles in an interleaved buffer of count matrices
+         */
+        static std::size_t get_size(const int count) {
+            return static_cast<std::size_t>((count + BATCH_LANES - 1) / BATCH_LANES) * N * N * BATCH_LANES;
+        }
+
+        /**
+         * \brief position of element (i, j) of a matrix in an interleaved buffer
+         */
+        static std::size_t get_index(const int matrix, const int i, const int j) {
+            return (static_cast<std::size_t>(matrix / BATCH_LANES) * N * N + i * N + j) * BATCH_LANES
+                   + matrix % BATCH_LANES;
+        }
+
+        /**
+         * \brief element (i, j) of a matrix, set the matrices here and call factorize()
+         */
+        double &operator()(const int matrix, const int i, const int j) {
+            return data_[get_index(matrix, i, j)];
+        }
+
+        /**
+         * \brief copy get_size(count) doubles of interleaved matrices and factorize them
+         */
+        void operator()(const double *matrices) {
+            for (std::size_t i = 0; i < data_.size(); i++) {
+                data_[i] = matrices[i];
+            }
+            fill_padding();
+            factorize();
+        }
+
+        /**
+         * \brief factorize the matrices set by operator()(matrix, i, j)
+         */
+        void factorize() {
+            constexpr int L = BATCH_LANES;
+            for (int block = 0; block < blocks_; block++) {
+                details::decomp_batch<N>(data_.data() + static_cast<std::size_t>(block) * N * N * L,
+                                         cond_.data() + block * L, pivot_.data() + block * N * L,
+                                         flag_.data() + block * L);
+            }
+        }
+
+        [[nodiscard]] int get_count() const { return count_; }
+        [[nodiscard]] double get_cond(const int matrix) const { return cond_[matrix]; }
+        [[nodiscard]] int get_flag(const int matrix) const { return flag_[matrix]; }
+
+    private:
+        int count_;
+        int blocks_;
+        std::vector<double> data_;
+        std::vector<int> pivot_;
+        std::vector<double> cond_;
+        std::vector<int> flag_;
+
+        /* unused lanes of the last block hold unit matrices */
+        void fill_padding() {
+            for (int matrix = count_; matrix < blocks_ * BATCH_LANES; matrix++) {
+                for (int i = 0; i < N; i++) {
+                    for (int j = 0; j < N; j++) {
+                        data_[get_index(matrix, i, j)] = (i == j) ? 1.0 : 0.0;
+                    }
+                }
+            }
+        }
+    };
+
+    /**
+     * \brief solutions of many systems of order N factorized by BatchDecomp,
+     * all the memory is allocated by the constructor
+     */
+    template<int N>
+    class BatchSolve {
+    public:
+        /**
+         * \brief
+         * \param count number of systems
+         */
+        explicit BatchSolve(const int count): count_(count),
+                                              data_right_(get_size(std::max(count, 0))) {
+            if (count < 1) {
+                throw std::logic_error("Check count");
+            }
+        }
+
+        /**
+         * \brief number of doubles in an interleaved buffer of count right hand sides
+         */
+        static std::size_t get_size(const int count) {
+            return static_cast<std::size_t>((count + BATCH_LANES - 1) / BATCH_LANES) * N * BATCH_LANES;
+        }
+
+        /**
+         * \brief position of element i of a right hand side in an interleaved buffer
+         */
+        static std::size_t get_index(const int system, const int i) {
+            return (static_cast<std::size_t>(system / BATCH_LANES) * N + i) * BATCH_LANES + system % BATCH_LANES;
+        }
+
+        /**
+         * \brief element i of a right hand side, set them here and call operator()(decomp)
+         */
+        double &operator()(const int system, const int i) {
+            return data_right_[get_index(system, i)];
+        }
+
+        /**
+         * \brief copy get_size(count) doubles of interleaved right hand sides and solve the systems
+         */
+        void operator()(const BatchDecomp<N> &decomp, const double *matrix_right) {
+            for (std::size_t i = 0; i < data_right_.size(); i++) {
+                data_right_[i] = matrix_right[i];
+            }
+            operator()(decomp);
+        }
+
+        /**
+         * \brief solve the systems with the right hand sides set by operator()(system, i)
+         */
+        void operator()(const BatchDecomp<N> &decomp) {
+            if (decomp.count_ != count_) {
+                throw std::logic_error("Check data");
+            }
+            constexpr int L = BATCH_LANES;
+            for (int block = 0; block < decomp.blocks_; block++) {
+                details::solve_batch<N>(decomp.data_.data() + static_cast<std::size_t>(block) * N * N * L,
+                                        data_right_.data() + static_cast<std::size_t>(block) * N * L,
+                                        decomp.pivot_.data() + block * N * L);
+            }
+        }
+
+        [[nodiscard]] double get_result(const int system, const int i) const {
+            return data_right_[get_index(system, i)];
+        }
+
+        /**
+         * \brief interleaved solutions, get_size(count) doubles
+         */
+        [[nodiscard]] const double *get_data() const { return data_right_.data(); }
+        [[nodiscard]] int get_count() const { return count_; }
+
+    private:
+        int count_;
+        std::vector<double> data_right_;
+    };
+}
+#endif
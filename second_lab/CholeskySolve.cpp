@@ -0,0 +1,235 @@
+#include "CholeskySolve.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+#include "../common/Statistics.h"
+#include "../common/Workspace.h"
+
+int dimkashelk::details::band_cholesky(int n, int kd,
+                                       double *ab, int ldab,
+                                       double *cond, int *flag)
+
+/* Purpose ...
+   -------
+   Cholesky factorization a = L * L-transpose of a symmetric
+   positive definite band matrix and an estimate of its condition.
+
+   Input ...
+   -----
+   n    = order of the matrix
+   kd   = number of subdiagonals
+   ab   = lower band of the matrix, element (i, j), i >= j,
+          is ab[j * ldab + i - j]
+   ldab = column dimension of ab, ldab >= kd + 1
+
+   Output ...
+   ------
+   ab   = lower band of L
+   cond = estimate of the condition of the matrix in the 1-norm,
+          1.0e+32 if the matrix is not positive definite
+   flag = 0 : successful execution
+          2 : illegal user input
+          3 : matrix is not positive definite
+
+   Notes ...
+   -----
+   The factorization is that of LAPACK dpbtf2, the condition estimate
+   is the one step of inverse iteration of decomp().
+*/
+
+{
+    NUMERICS_TIMER(FACTOR);
+    NUMERICS_COUNT(FACTORIZATIONS, 1);
+    const double EPSILON = 2.2e-16;
+    double anorm, ynorm, znorm, t, ek, d;
+    int i, j, k, kn;
+
+    *flag = 0;
+    if (ab == nullptr || n < 1 || kd < 0 || ldab < kd + 1) {
+        *flag = 2;
+        return (0);
+    }
+    auto at = [=](const int r, const int c) -> double & {
+        return ab[static_cast<std::size_t>(c) * ldab + r - c];
+    };
+
+    /* --- compute 1-norm of a from its lower band --- */
+    Workspace &workspace = thread_workspace();
+    Workspace::Scope scope(workspace);
+    double *work = workspace.allocate<double>(n);
+    std::fill(work, work + n, 0.0);
+    for (j = 0; j < n; ++j) {
+        kn = std::min(kd, n - 1 - j);
+        work[j] += std::fabs(at(j, j));
+        for (i = 1; i <= kn; ++i) {
+            t = std::fabs(at(j + i, j));
+            work[j] += t;
+            work[j + i] += t;
+        }
+    }
+    anorm = *std::max_element(work, work + n);
+
+    for (j = 0; j < n; ++j) {
+        d = at(j, j);
+        if (d <= anorm * EPSILON) {
+            /* Not positive definite to working precision */
+            *cond = 1.0e+32;
+            *flag = 3;
+            return (0);
+        }
+        d = std::sqrt(d);
+        at(j, j) = d;
+        kn = std::min(kd, n - 1 - j);
+        double *l = ab + (static_cast<std::size_t>(j) * ldab + 1);
+        for (i = 0; i < kn; ++i) l[i] /= d;
+        /* rank one update of the trailing band */
+        for (k = 0; k < kn; ++k) {
+            t = l[k];
+            double *column = ab + static_cast<std::size_t>(j + 1 + k) * ldab;
+            for (i = k; i < kn; ++i) column[i - k] -= l[i] * t;
+        }
+    }
+
+    /* cond = (1-norm of a)*(an estimate of 1-norm of a-inverse),
+       L * w = e with e chosen for growth, L-transpose * y = w,
+       then a * z = y */
+    for (k = 0; k < n; ++k) {
+        t = 0.0;
+        for (i = std::max(0, k - kd); i < k; ++i) t += at(k, i) * work[i];
+        ek = t < 0.0 ? -1.0 : 1.0;
+        work[k] = -(ek + t) / at(k, k);
+    }
+    for (k = n - 1; k >= 0; --k) {
+        kn = std::min(kd, n - 1 - k);
+        t = work[k];
+        for (i = 1; i <= kn; ++i) t -= at(k + i, k) * work[k + i];
+        work[k] = t / at(k, k);
+    }
+    ynorm = 0.0;
+    for (i = 0; i < n; ++i) ynorm += std::fabs(work[i]);
+    band_cholesky_solve(n, kd, ab, ldab, work);
+    znorm = 0.0;
+    for (i = 0; i < n; ++i) znorm += std::fabs(work[i]);
+
+    *cond = anorm * znorm / ynorm;
+    if (*cond < 1.0) *cond = 1.0;
+    if (*cond + 1.0 == *cond) *flag = 3;
+    return (0);
+} /* --- end of function band_cholesky() --- */
+
+int dimkashelk::details::band_cholesky_solve(int n, int kd,
+                                             const double *ab, int ldab,
+                                             double b[])
+
+/* Purpose :
+   -------
+   Solution of a * x = b with the factor of band_cholesky(),
+   b is overwritten by x.
+*/
+
+{
+    NUMERICS_TIMER(SOLVE);
+    NUMERICS_COUNT(SOLVES, 1);
+    int i, j, kn;
+    double t;
+
+    /* L * y = b */
+    for (j = 0; j < n; ++j) {
+        const double *column = ab + static_cast<std::size_t>(j) * ldab;
+        kn = std::min(kd, n - 1 - j);
+        b[j] /= column[0];
+        t = b[j];
+        for (i = 1; i <= kn; ++i) b[j + i] -= column[i] * t;
+    }
+    /* L-transpose * x = y */
+    for (j = n - 1; j >= 0; --j) {
+        const double *column = ab + static_cast<std::size_t>(j) * ldab;
+        kn = std::min(kd, n - 1 - j);
+        t = b[j];
+        for (i = 1; i <= kn; ++i) t -= column[i] * b[j + i];
+        b[j] = t / column[0];
+    }
+    return (0);
+} /* --- end of function band_cholesky_solve() --- */
+
+dimkashelk::CholeskySolve::CholeskySolve(): size_(0),
+                                            band_(0),
+                                            cond_(0.0),
+                                            flag_(0) {
+}
+
+void dimkashelk::CholeskySolve::operator()(const BandMatrix &matrix) {
+    if (matrix.get_size() == 0) {
+        throw std::logic_error("Check matrix");
+    }
+    size_ = matrix.get_size();
+    band_ = matrix.get_lower();
+    factors_.resize(static_cast<std::size_t>(size_) * (band_ + 1));
+    const int stride = matrix.get_stride();
+    for (int j = 0; j < size_; j++) {
+        /* the diagonal and the subdiagonals of column j */
+        const double *column = matrix.get_data() + (static_cast<std::size_t>(j) * stride + matrix.get_upper());
+        std::copy(column, column + band_ + 1, factors_.data() + static_cast<std::size_t>(j) * (band_ + 1));
+    }
+    factorize();
+}
+
+void dimkashelk::CholeskySolve::operator()(const ConstMatrixView &matrix) {
+    if (matrix.empty()) {
+        throw std::logic_error("Check matrix");
+    }
+    if (matrix.get_rows() != matrix.get_cols()) {
+        throw std::logic_error("Check size of matrix");
+    }
+    size_ = matrix.get_rows();
+    band_ = size_ - 1;
+    factors_.resize(static_cast<std::size_t>(size_) * size_);
+    for (int j = 0; j < size_; j++) {
+        for (int i = j; i < size_; i++) {
+            factors_[static_cast<std::size_t>(j) * size_ + i - j] = matrix(i, j);
+        }
+    }
+    factorize();
+}
+
+void dimkashelk::CholeskySolve::factorize() {
+    details::band_cholesky(size_, band_, factors_.data(), band_ + 1, std::addressof(cond_), std::addressof(flag_));
+}
+
+void dimkashelk::CholeskySolve::operator()(const std::vector<double> &matrix_right) {
+    if (size_ == 0 || static_cast<int>(matrix_right.size()) != size_) {
+        throw std::logic_error("Check data");
+    }
+    if (flag_ != 0) {
+        throw std::logic_error("Check matrix, it is not positive definite");
+    }
+    result_ = matrix_right;
+    details::band_cholesky_solve(size_, band_, factors_.data(), band_ + 1, result_.data());
+}
+
+void dimkashelk::CholeskySolve::operator()(const BandMatrix &matrix_left, const std::vector<double> &matrix_right) {
+    if (matrix_left.get_size() != static_cast<int>(matrix_right.size())) {
+        throw std::logic_error("Check data");
+    }
+    operator()(matrix_left);
+    operator()(matrix_right);
+}
+
+std::vector<double> dimkashelk::CholeskySolve::get_result() const {
+    return result_;
+}
+
+double dimkashelk::CholeskySolve::get_cond() const {
+    return cond_;
+}
+
+int dimkashelk::CholeskySolve::get_flag() const {
+    return flag_;
+}
+
+int dimkashelk::CholeskySolve::get_size() const {
+    return size_;
+}
@@ -0,0 +1,58 @@
+#ifndef CHOLESKY_SOLVE_H
+#define CHOLESKY_SOLVE_H
+#include <vector>
+
+#include "BandMatrix.h"
+#include "Matrix.h"
+
+namespace dimkashelk {
+    namespace details {
+        int band_cholesky(int n, int kd,
+                          double *ab, int ldab,
+                          double *cond, int *flag);
+
+        int band_cholesky_solve(int n, int kd,
+                                const double *ab, int ldab,
+                                double b[]);
+    }
+
+    /**
+     * \brief Cholesky factorization a = L L^T of a symmetric positive definite matrix,
+     * only the lower triangle is read. Band matrices keep their band, a dense matrix
+     * is stored as a band with n - 1 subdiagonals
+     */
+    class CholeskySolve {
+    public:
+        CholeskySolve();
+
+        /**
+         * \brief factorize the lower band of the matrix, flag 3 if it is not positive definite
+         */
+        void operator()(const BandMatrix &matrix);
+
+        void operator()(const ConstMatrixView &matrix);
+
+        /**
+         * \brief solve with the last factorization
+         */
+        void operator()(const std::vector<double> &matrix_right);
+
+        void operator()(const BandMatrix &matrix_left, const std::vector<double> &matrix_right);
+
+        [[nodiscard]] std::vector<double> get_result() const;
+        [[nodiscard]] double get_cond() const;
+        [[nodiscard]] int get_flag() const;
+        [[nodiscard]] int get_size() const;
+
+    private:
+        int size_;
+        int band_;
+        double cond_;
+        int flag_;
+        std::vector<double> factors_;
+        std::vector<double> result_;
+
+        void factorize();
+    };
+}
+#endif
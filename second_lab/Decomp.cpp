@@ -1,12 +1,149 @@
 #include "Decomp.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <cmath>
 #include "Solve.h"
+#include "../common/Statistics.h"
+#include "../common/ThreadPool.h"
+#include "../common/Workspace.h"
+
+namespace {
+    /* number of columns eliminated before the trailing matrix is updated */
+    constexpr int DECOMP_PANEL = 64;
+    /* number of trailing columns kept in cache by update_trailing() */
+    constexpr int DECOMP_TILE = 256;
+    /* number of trailing rows updated by one task */
+    constexpr int DECOMP_CHUNK = 256;
+
+    template<class Task>
+    void run_tasks(dimkashelk::ThreadPool *pool, const int count, const Task &task) {
+        if (pool == nullptr) {
+            for (int i = 0; i < count; ++i) task(i);
+            return;
+        }
+        pool->run(count, task);
+    }
+
+    template<class Real>
+    void update_panel_rows(int k0, int k1, int j0, int j1, int ndim, Real negligible,
+                           const int pivot[], Real *a)
+
+    /* Purpose ...
+       -------
+       Applies the interchanges and the elimination steps k0 ... k1-1
+       of a panel to the rows k0 ... k1-1 of the columns j0 ... j1-1.
+    */
+
+    {
+        int i, j, k, m;
+        Real t, *pa, *pb;
+
+        /* Interchange rows of the trailing columns. */
+        for (k = k0; k < k1; ++k) {
+            m = pivot[k];
+            if (m == k) continue;
+            pa = a + (m * ndim);
+            pb = a + (k * ndim);
+            for (j = j0; j < j1; ++j) {
+                t = pa[j];
+                pa[j] = pb[j];
+                pb[j] = t;
+            }
+        }
+
+        /* Eliminate the panel rows of the trailing columns. */
+        for (k = k0; k < k1; ++k) {
+            pb = a + (k * ndim);
+            for (i = k + 1; i < k1; ++i) {
+                t = a[(i * ndim + k)];
+                if (fabs(t) <= negligible) continue;
+                pa = a + (i * ndim);
+                for (j = j0; j < j1; ++j) pa[j] += pb[j] * t;
+            }
+        }
+    }
 
+    template<class Real>
+    void update_trailing(int rows, int cols, int depth, int ndim, Real negligible,
+                         const Real *l, const Real *u, Real *c)
+
+    /* Purpose ...
+       -------
+       Rank-depth update of the trailing matrix,
+           c[i][j] += l[i][k] * u[k][j],  k = 0 ... depth-1,
+       where multipliers l[i][k] with fabs() <= negligible are skipped.
+       All the blocks are in rowwise storage with row dimension ndim,
+       depth must not exceed DECOMP_PANEL.
+
+       Notes ...
+       -----
+       The terms are added in the same order as in the unblocked
+       elimination, so the result is identical. A 4 x 8 block of c
+       is kept in registers while the k loop runs, the innermost
+       loops have fixed length and are vectorized by the compiler
+       (e.g. AVX2 or AVX-512 with -march=native). The block is also
+       4 x 8 for float, wider blocks were slower with some compilers.
+    */
+
+    {
+        Real lp[4 * DECOMP_PANEL]; /* packed multipliers of 4 rows */
+        Real acc[4][8];
+        int i, j, k, r, q, jj, cn;
+        Real t, *pc;
+        const Real *uk;
+
+        for (jj = 0; jj < cols; jj += DECOMP_TILE) {
+            cn = std::min(DECOMP_TILE, cols - jj);
+            for (i = 0; i < rows; i += 4) {
+                const int rn = std::min(4, rows - i);
+                for (k = 0; k < depth; ++k) {
+                    for (r = 0; r < 4; ++r) {
+                        t = (r < rn) ? l[((i + r) * ndim + k)] : 0.0;
+                        lp[k * 4 + r] = (fabs(t) > negligible) ? t : 0.0;
+                    }
+                }
+                pc = c + (i * ndim + jj);
+                if (rn == 4) {
+                    for (j = 0; j + 8 <= cn; j += 8) {
+                        for (r = 0; r < 4; ++r)
+                            for (q = 0; q < 8; ++q) acc[r][q] = pc[(r * ndim + j + q)];
+                        for (k = 0; k < depth; ++k) {
+                            uk = u + (k * ndim + jj + j);
+                            for (r = 0; r < 4; ++r) {
+                                t = lp[k * 4 + r];
+                                for (q = 0; q < 8; ++q) acc[r][q] += uk[q] * t;
+                            }
+                        }
+                        for (r = 0; r < 4; ++r)
+                            for (q = 0; q < 8; ++q) pc[(r * ndim + j + q)] = acc[r][q];
+                    }
+                } else {
+                    j = 0;
+                }
+                /* remaining columns and rows */
+                for (r = 0; r < rn; ++r) {
+                    for (k = 0; k < depth; ++k) {
+                        t = lp[k * 4 + r];
+                        if (t == 0.0) continue;
+                        uk = u + (k * ndim + jj);
+                        for (q = j; q < cn; ++q) pc[(r * ndim + q)] += uk[q] * t;
+                    }
+                }
+            }
+        }
+    }
+}
+
+int dimkashelk::details::decomp_workspace(const int n) {
+    return n;
+}
+
+template<class Real>
 int dimkashelk::details::decomp(int n, int ndim,
-                                double *a, double *cond,
-                                int pivot[], int *flag)
+                                Real *a, double *cond,
+                                int pivot[], int *flag,
+                                ThreadPool *pool, Real work[])
 
 /* Purpose ...
    -------
@@ -20,6 +157,11 @@ int dimkashelk::details::decomp(int n, int ndim,
    n    = order of the matrix
    ndim = row dimension of matrix as defined in the calling program
    *a   = pointer to matrix to be triangularized
+   pool = threads sharing the update of the trailing matrix,
+          NULL for serial execution. The result does not depend
+          on the number of threads.
+   work = scratch of decomp_workspace(n) elements,
+          NULL to allocate it internally.
 
    Output ...
    ------
@@ -28,6 +170,8 @@ int dimkashelk::details::decomp(int n, int ndim,
            so that
            (permutation matrix) * a = L * U
    cond      = an estimate of the condition of a .
+           For Real = float the elimination and the estimate are
+           done in single precision.
            For the linear system a * x = b, changes in a and b
            may cause changes cond times as large in x.
            If cond+1.0 .eq. cond , a is singular to working
@@ -45,7 +189,8 @@ int dimkashelk::details::decomp(int n, int ndim,
 
    Work Space ...
    ----------
-   The vector work[0..n] is allocated internally by decomp().
+   The vector work[0..n] is taken from the caller, or is
+   allocated internally by decomp() when work == NULL.
 
    This C code written by ...  Peter & Nigel,
    ----------------------      Design Software,
@@ -76,14 +221,17 @@ int dimkashelk::details::decomp(int n, int ndim,
 
 {
     /* --- function decomp() --- */
-    double EPSILON = 2.2e-16;
-    double ek, t, pvt, anorm, ynorm, znorm;
-    int i, j, k, m;
-    double *pa, *pb; /* temporary pointers */
-    double *work;
+    NUMERICS_TIMER(FACTOR);
+    NUMERICS_COUNT(FACTORIZATIONS, 1);
+    double EPSILON = sizeof(Real) < sizeof(double) ? 1.2e-7 : 2.2e-16;
+    Real ek, t, pvt, small, negligible;
+    double anorm, ynorm, znorm;
+    int i, j, k, m, k0, k1;
+    Real *pa, *pb; /* temporary pointers */
+    Real *owned;
 
     *flag = 0;
-    work = (double *) NULL;
+    owned = (Real *) NULL;
 
     if (a == NULL || pivot == NULL || n < 1 || ndim < n) {
         *flag = 2;
@@ -102,70 +250,122 @@ int dimkashelk::details::decomp(int n, int ndim,
         return (0);
     }
 
-    work = (double *) malloc(n * sizeof(double));
     if (work == NULL) {
-        *flag = 1;
-        return (0);
+        owned = (Real *) malloc(n * sizeof(Real));
+        NUMERICS_COUNT(BYTES_ALLOCATED, n * sizeof(Real));
+        if (owned == NULL) {
+            *flag = 1;
+            return (0);
+        }
+        work = owned;
     }
 
-    /* --- compute 1-norm of a --- */
+    /* --- compute 1-norm of a ---
+       the column sums are accumulated in work[] so that a
+       is traversed by rows */
 
+    for (j = 0; j < n; ++j) work[j] = 0.0;
+    for (i = 0; i < n; ++i) {
+        pa = a + i * ndim;
+        for (j = 0; j < n; ++j) work[j] += fabs(pa[j]);
+    }
     anorm = 0.0;
     for (j = 0; j < n; ++j) {
-        t = 0.0;
-        for (i = 0; i < n; ++i) t += fabs(a[(i * ndim + j)]);
-        if (t > anorm) anorm = t;
+        if (work[j] > anorm) anorm = work[j];
     }
-
-    /* Apply Gaussian elimination with partial pivoting. */
-
-    for (k = 0; k < n - 1; ++k) {
-        /* Find pivot and label as row m.
-           This will be the element with largest magnitude in
-           the lower part of the kth column. */
-        m = k;
-        pvt = fabs(a[(m * ndim + k)]);
-        for (i = k + 1; i < n; ++i) {
-            t = fabs(a[(i * ndim + k)]);
-            if (t > pvt) {
-                m = i;
-                pvt = t;
+    small = anorm * EPSILON;
+    /* multipliers below negligible are skipped, they do not depend on the scale of a as small does */
+    negligible = EPSILON;
+
+    /* Apply Gaussian elimination with partial pivoting.
+       The columns are processed in panels of DECOMP_PANEL columns.
+       Inside a panel the elimination is done column by column, the
+       rest of the matrix is then updated once per panel. */
+
+    for (k0 = 0; k0 < n - 1; k0 += DECOMP_PANEL) {
+        k1 = std::min(k0 + DECOMP_PANEL, n - 1);
+
+        for (k = k0; k < k1; ++k) {
+            /* Find pivot and label as row m.
+               This will be the element with largest magnitude in
+               the lower part of the kth column. */
+            m = k;
+            pvt = fabs(a[(m * ndim + k)]);
+            for (i = k + 1; i < n; ++i) {
+                t = fabs(a[(i * ndim + k)]);
+                if (t > pvt) {
+                    m = i;
+                    pvt = t;
+                }
+            }
+            pivot[k] = m;
+            pvt = a[(m * ndim + k)];
+
+            if (m != k) {
+                NUMERICS_COUNT(PIVOT_SWAPS, 1);
+                pivot[n - 1] = -pivot[n - 1];
+                /* Interchange rows m and k inside the panel, the
+                   multipliers of the panel move with their rows and
+                   are put back after the panel update. */
+                for (j = k0; j < k1; ++j) {
+                    pa = a + (m * ndim + j);
+                    pb = a + (k * ndim + j);
+                    t = *pa;
+                    *pa = *pb;
+                    *pb = t;
+                }
+            }
+            /* row k is now the pivot row */
+
+            /* Bail out if pivot is too small */
+            if (fabs(pvt) < small) {
+                /* Singular or nearly singular */
+                *cond = 1.0e+32;
+                *flag = 3;
+                goto DecompExit;
             }
-        }
-        pivot[k] = m;
-        pvt = a[(m * ndim + k)];
 
-        if (m != k) {
-            pivot[n - 1] = -pivot[n - 1];
-            /* Interchange rows m and k for the lower partition. */
-            for (j = k; j < n; ++j) {
-                pa = a + (m * ndim + j);
-                pb = a + (k * ndim + j);
-                t = *pa;
-                *pa = *pb;
-                *pb = t;
+            /* eliminate the lower panel partition by rows
+               and store the multipliers in the k sub-column */
+            for (i = k + 1; i < n; ++i) {
+                pa = a + (i * ndim + k); /* element to eliminate */
+                t = -(*pa / pvt); /* compute multiplier   */
+                *pa = t; /* store multiplier     */
+                if (fabs(t) > negligible) {
+                    for (j = k + 1; j < k1; ++j) /* eliminate i th row */
+                        a[(i * ndim + j)] += a[(k * ndim + j)] * t;
+                }
             }
         }
-        /* row k is now the pivot row */
 
-        /* Bail out if pivot is too small */
-        if (fabs(pvt) < anorm * EPSILON) {
-            /* Singular or nearly singular */
-            *cond = 1.0e+32;
-            *flag = 3;
-            goto DecompExit;
+        if (k1 < n) {
+            /* Update the trailing matrix. The column tiles and then the
+               row chunks of every tile are independent of each other. */
+            const int tiles = (n - k1 + DECOMP_TILE - 1) / DECOMP_TILE;
+            const int chunks = (n - k1 + DECOMP_CHUNK - 1) / DECOMP_CHUNK;
+            run_tasks(pool, tiles, [=](const int tile) {
+                const int j0 = k1 + tile * DECOMP_TILE;
+                update_panel_rows(k0, k1, j0, std::min(j0 + DECOMP_TILE, n), ndim, negligible, pivot, a);
+            });
+            run_tasks(pool, tiles * chunks, [=](const int task) {
+                const int j0 = k1 + (task / chunks) * DECOMP_TILE;
+                const int i0 = k1 + (task % chunks) * DECOMP_CHUNK;
+                update_trailing(std::min(DECOMP_CHUNK, n - i0), std::min(DECOMP_TILE, n - j0), k1 - k0,
+                                ndim, negligible, a + (i0 * ndim + k0), a + (k0 * ndim + j0), a + (i0 * ndim + j0));
+            });
         }
 
-        /* eliminate the lower matrix partition by rows
-           and store the multipliers in the k sub-column */
-        for (i = k + 1; i < n; ++i) {
-            pa = a + (i * ndim + k); /* element to eliminate */
-            t = -(*pa / pvt); /* compute multiplier   */
-            *pa = t; /* store multiplier     */
-            for (j = k + 1; j < n; ++j) /* eliminate i th row */
-            {
-                if (fabs(t) > anorm * EPSILON)
-                    a[(i * ndim + j)] += a[(k * ndim + j)] * t;
+        /* Put the multipliers of the panel back into the rows they
+           were computed for. */
+        for (k = k1 - 1; k > k0; --k) {
+            m = pivot[k];
+            if (m == k) continue;
+            pa = a + (m * ndim);
+            pb = a + (k * ndim);
+            for (j = k0; j < k; ++j) {
+                t = pa[j];
+                pa[j] = pb[j];
+                pb[j] = t;
             }
         }
     } /* End of Gaussian elimination. */
@@ -227,55 +427,127 @@ int dimkashelk::details::decomp(int n, int ndim,
     if (*cond + 1.0 == *cond) *flag = 3;
 
 DecompExit:
-    if (work != NULL) {
-        free(work);
-        work = (double *) NULL;
+    if (owned != NULL) {
+        free(owned);
+        owned = (Real *) NULL;
     }
     return (0);
 } /* --- end of function decomp() --- */
 
+template int dimkashelk::details::decomp<double>(int n, int ndim, double *a, double *cond, int pivot[], int *flag,
+                                                 ThreadPool *pool, double work[]);
+template int dimkashelk::details::decomp<float>(int n, int ndim, float *a, double *cond, int pivot[], int *flag,
+                                                ThreadPool *pool, float work[]);
+
 dimkashelk::Decomp::Decomp(): cond_(0.0),
                               size_(0),
+                              ndim_(0),
                               data_(nullptr),
                               pivot_(nullptr),
-                              flag_(0) {
+                              flag_(0),
+                              workspace_(nullptr) {
 }
 
 void dimkashelk::Decomp::operator()(const std::vector<std::vector<double> > &matrix) {
     if (matrix.empty()) {
         throw std::logic_error("Check matrix");
     }
-    if (matrix.size() != matrix[0].size()) {
+    for (const auto &row: matrix) {
+        if (matrix.size() != row.size()) {
+            throw std::logic_error("Check size of matrix");
+        }
+    }
+    const int size = static_cast<int>(matrix.size());
+    data_ = nullptr;
+    storage_.resize(size, size);
+    for (int i = 0; i < size; i++) {
+        std::copy(matrix[i].begin(), matrix[i].end(), storage_.get_view().get_row(i));
+    }
+    factorize(storage_.get_data(), size, storage_.get_stride());
+}
+
+void dimkashelk::Decomp::operator()(const ConstMatrixView &matrix) {
+    if (matrix.empty()) {
+        throw std::logic_error("Check matrix");
+    }
+    if (matrix.get_rows() != matrix.get_cols()) {
         throw std::logic_error("Check size of matrix");
     }
-    free();
-    size_ = static_cast<int>(matrix.size());
-    data_ = new double[size_ * size_];
-    try {
-        pivot_ = new int[matrix.size() * matrix.size()];
-    } catch (...) {
-        delete[] data_;
-        throw;
+    const int size = matrix.get_rows();
+    data_ = nullptr;
+    storage_.resize(size, size);
+    for (int i = 0; i < size; i++) {
+        std::copy(matrix.get_row(i), matrix.get_row(i) + size, storage_.get_view().get_row(i));
     }
-    int ind = 0;
-    for (auto &i: matrix) {
-        for (double j: i) {
-            data_[ind] = j;
-            ind++;
-        }
+    factorize(storage_.get_data(), size, storage_.get_stride());
+}
+
+void dimkashelk::Decomp::factorize_in_place(const MatrixView &matrix) {
+    if (matrix.empty()) {
+        throw std::logic_error("Check matrix");
+    }
+    if (matrix.get_rows() != matrix.get_cols() || matrix.get_stride() < matrix.get_cols()) {
+        throw std::logic_error("Check size of matrix");
+    }
+    factorize(matrix.get_data(), matrix.get_rows(), matrix.get_stride());
+}
+
+void dimkashelk::Decomp::factorize(double *data, const int size, const int ndim) {
+    if (size != size_) {
+        free();
+        pivot_ = new int[size];
+        NUMERICS_COUNT(BYTES_ALLOCATED, size * sizeof(int));
     }
-    details::decomp(size_, size_, data_, std::addressof(cond_), pivot_, std::addressof(flag_));
+    size_ = size;
+    ndim_ = ndim;
+    data_ = data;
+    Workspace &workspace = workspace_ == nullptr ? thread_workspace() : *workspace_;
+    Workspace::Scope scope(workspace);
+    double *work = workspace.allocate<double>(details::decomp_workspace(size_));
+    details::decomp(size_, ndim_, data_, std::addressof(cond_), pivot_, std::addressof(flag_), pool_.get(), work);
+}
+
+void dimkashelk::Decomp::set_threads(const unsigned threads) {
+    if (threads == 1) {
+        pool_.reset();
+        return;
+    }
+    pool_ = std::make_unique<ThreadPool>(threads);
+}
+
+unsigned dimkashelk::Decomp::get_threads() const {
+    return pool_ == nullptr ? 1 : pool_->get_threads();
+}
+
+void dimkashelk::Decomp::set_workspace(Workspace *workspace) {
+    workspace_ = workspace;
+}
+
+std::size_t dimkashelk::Decomp::workspace_size(const int n) {
+    return Workspace::bytes<double>(details::decomp_workspace(n));
+}
+
+double dimkashelk::Decomp::get_cond() const {
+    return cond_;
+}
+
+int dimkashelk::Decomp::get_flag() const {
+    return flag_;
+}
+
+int dimkashelk::Decomp::get_size() const {
+    return size_;
 }
 
 dimkashelk::Decomp::~Decomp() {
     free();
 }
 
-void dimkashelk::Decomp::free() const {
-    if (data_ != nullptr) {
-        delete[] data_;
-    }
+void dimkashelk::Decomp::free() {
+    data_ = nullptr;
     if (pivot_ != nullptr) {
         delete[] pivot_;
+        pivot_ = nullptr;
     }
+    size_ = 0;
 }
@@ -1,12 +1,29 @@
 #ifndef DECOMP_H
 #define DECOMP_H
+#include <cstddef>
+#include <memory>
 #include <vector>
 
+#include "Matrix.h"
+
 namespace dimkashelk {
+    class ThreadPool;
+    class Workspace;
+
     namespace details {
+        /**
+         * \brief instantiated for double and float matrices, cond is double for both
+         */
+        template<class Real>
         int decomp(int n, int ndim,
-                   double *a, double *cond,
-                   int pivot[], int *flag);
+                   Real *a, double *cond,
+                   int pivot[], int *flag,
+                   ThreadPool *pool = nullptr, Real work[] = nullptr);
+
+        /**
+         * \brief number of elements of the work array of decomp()
+         */
+        int decomp_workspace(int n);
     }
 
     class Solve;
@@ -17,18 +34,62 @@ namespace dimkashelk {
     public:
         Decomp();
 
+        Decomp(const Decomp &) = delete;
+
+        Decomp &operator=(const Decomp &) = delete;
+
         void operator()(const std::vector<std::vector<double> > &matrix);
 
+        /**
+         * \brief factorize a copy of the matrix, the storage of the copy is reused between calls
+         * \param matrix square matrix
+         */
+        void operator()(const ConstMatrixView &matrix);
+
+        /**
+         * \brief factorize the matrix in its own storage without copying,
+         * the matrix is overwritten by the factors and must outlive their use
+         * \param matrix square matrix
+         */
+        void factorize_in_place(const MatrixView &matrix);
+
+        /**
+         * \brief set number of threads used by the factorization
+         * \param threads 1 for serial execution, 0 for all hardware threads
+         */
+        void set_threads(unsigned threads);
+
+        [[nodiscard]] unsigned get_threads() const;
+
+        /**
+         * \brief arena for the scratch of the factorization
+         * \param workspace nullptr for thread_workspace() of the calling thread
+         */
+        void set_workspace(Workspace *workspace);
+
+        /**
+         * \brief bytes drawn from the workspace by a factorization of order n
+         */
+        static std::size_t workspace_size(int n);
+        [[nodiscard]] double get_cond() const;
+        [[nodiscard]] int get_flag() const;
+        [[nodiscard]] int get_size() const;
+
         ~Decomp();
 
     private:
         double cond_;
         int size_;
+        int ndim_;
         double *data_;
         int *pivot_;
         int flag_;
+        Matrix storage_;
+        std::unique_ptr<ThreadPool> pool_;
+        Workspace *workspace_;
 
-        void free() const;
+        void factorize(double *data, int size, int ndim);
+        void free();
     };
 }
 #endif
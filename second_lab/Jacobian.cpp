@@ -0,0 +1,111 @@
+#include "Jacobian.h"
+
+#include <numeric>
+
+dimkashelk::JacobianColoring::JacobianColoring(const int size): size_(size),
+                                                                colors_(size),
+                                                                dense_(true),
+                                                                column_colors_(std::max(size, 0)),
+                                                                color_ptr_(std::max(size, 0) + 1),
+                                                                color_columns_(std::max(size, 0)) {
+    if (size < 1) {
+        throw std::logic_error("Check size of Jacobian");
+    }
+    /* color j is column j with all rows, no entries are listed */
+    std::iota(column_colors_.begin(), column_colors_.end(), 0);
+    std::iota(color_ptr_.begin(), color_ptr_.end(), 0);
+    std::iota(color_columns_.begin(), color_columns_.end(), 0);
+}
+
+dimkashelk::JacobianColoring::JacobianColoring(const SparseMatrix &pattern): size_(pattern.get_size()),
+                                                                             colors_(0),
+                                                                             dense_(false) {
+    const int n = size_;
+    if (n < 1) {
+        throw std::logic_error("Check size of Jacobian");
+    }
+    const std::vector<int> &row_ptr = pattern.get_row_ptr();
+    const std::vector<int> &columns = pattern.get_columns();
+    const int nonzeros = pattern.get_nonzeros();
+
+    /* transpose of the pattern, rows of every column with the position of the nonzero */
+    std::vector<int> col_ptr(n + 1, 0);
+    std::vector<int> col_rows(nonzeros);
+    std::vector<int> col_positions(nonzeros);
+    for (int p = 0; p < nonzeros; p++) col_ptr[columns[p] + 1]++;
+    for (int j = 0; j < n; j++) col_ptr[j + 1] += col_ptr[j];
+    std::vector<int> next(col_ptr.begin(), col_ptr.end() - 1);
+    for (int i = 0; i < n; i++) {
+        for (int p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+            const int q = next[columns[p]]++;
+            col_rows[q] = i;
+            col_positions[q] = p;
+        }
+    }
+
+    /* greedy coloring, largest column first: the smallest color not used by a column
+       that shares a row with column j */
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](const int a, const int b) {
+        return col_ptr[a + 1] - col_ptr[a] > col_ptr[b + 1] - col_ptr[b];
+    });
+    column_colors_.assign(n, -1);
+    std::vector<int> forbidden(n, -1);
+    for (const int j: order) {
+        for (int q = col_ptr[j]; q < col_ptr[j + 1]; q++) {
+            const int i = col_rows[q];
+            for (int p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+                const int color = column_colors_[columns[p]];
+                if (color >= 0) forbidden[color] = j;
+            }
+        }
+        int color = 0;
+        while (forbidden[color] == j) color++;
+        column_colors_[j] = color;
+        colors_ = std::max(colors_, color + 1);
+    }
+
+    /* columns and nonzeros ordered by color */
+    color_ptr_.assign(colors_ + 1, 0);
+    entry_ptr_.assign(colors_ + 1, 0);
+    for (int j = 0; j < n; j++) {
+        color_ptr_[column_colors_[j] + 1]++;
+        entry_ptr_[column_colors_[j] + 1] += col_ptr[j + 1] - col_ptr[j];
+    }
+    for (int c = 0; c < colors_; c++) {
+        color_ptr_[c + 1] += color_ptr_[c];
+        entry_ptr_[c + 1] += entry_ptr_[c];
+    }
+    color_columns_.resize(n);
+    entry_rows_.resize(nonzeros);
+    entry_columns_.resize(nonzeros);
+    entry_positions_.resize(nonzeros);
+    std::vector<int> next_column(color_ptr_.begin(), color_ptr_.end() - 1);
+    std::vector<int> next_entry(entry_ptr_.begin(), entry_ptr_.end() - 1);
+    for (int j = 0; j < n; j++) {
+        const int c = column_colors_[j];
+        color_columns_[next_column[c]++] = j;
+        for (int q = col_ptr[j]; q < col_ptr[j + 1]; q++) {
+            const int e = next_entry[c]++;
+            entry_rows_[e] = col_rows[q];
+            entry_columns_[e] = j;
+            entry_positions_[e] = col_positions[q];
+        }
+    }
+}
+
+void dimkashelk::JacobianColoring::clear(const MatrixView jacobian) const {
+    if (dense_) {
+        return;
+    }
+    for (int i = 0; i < size_; i++) {
+        std::fill(jacobian.get_row(i), jacobian.get_row(i) + size_, 0.0);
+    }
+}
+
+void dimkashelk::JacobianColoring::check(const SparseMatrix &jacobian) const {
+    if (dense_ || jacobian.get_size() != size_ || static_cast<std::size_t>(jacobian.get_nonzeros()) != get_nonzeros()) {
+        throw std::logic_error("Check pattern of Jacobian");
+    }
+}
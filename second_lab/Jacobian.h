@@ -0,0 +1,279 @@
+#ifndef JACOBIAN_H
+#define JACOBIAN_H
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Matrix.h"
+#include "SparseMatrix.h"
+#include "../common/Dual.h"
+
+namespace dimkashelk {
+    /**
+     * \brief grouping of the columns of a Jacobian into colors, columns of one color have no nonzero
+     * in a common row, so one directional derivative along the sum of their unit vectors gives all of them
+     * (A. R. Curtis, M. J. D. Powell, J. K. Reid). Colors are chosen greedily, largest column first.
+     * The columns of color c are get_color_columns()[get_color_ptr()[c] ... get_color_ptr()[c + 1] - 1],
+     * its nonzeros are entries get_entry_ptr()[c] ... get_entry_ptr()[c + 1] - 1, entry e is row
+     * get_entry_rows()[e], column get_entry_columns()[e], at get_entry_positions()[e] in the values of
+     * the pattern. A dense pattern lists no entries, color c is column c with all rows.
+     */
+    class JacobianColoring {
+    public:
+        /**
+         * \brief dense pattern of order size, every column has its own color
+         */
+        explicit JacobianColoring(int size);
+
+        /**
+         * \brief coloring of the nonzero pattern of a sparse Jacobian, the values are not used
+         */
+        explicit JacobianColoring(const SparseMatrix &pattern);
+
+        [[nodiscard]] int get_size() const { return size_; }
+        [[nodiscard]] int get_colors() const { return colors_; }
+        [[nodiscard]] std::size_t get_nonzeros() const {
+            return dense_ ? static_cast<std::size_t>(size_) * size_ : entry_rows_.size();
+        }
+        [[nodiscard]] bool is_dense() const { return dense_; }
+        [[nodiscard]] const std::vector<int> &get_column_colors() const { return column_colors_; }
+        [[nodiscard]] const std::vector<int> &get_color_ptr() const { return color_ptr_; }
+        [[nodiscard]] const std::vector<int> &get_color_columns() const { return color_columns_; }
+        [[nodiscard]] const std::vector<int> &get_entry_ptr() const { return entry_ptr_; }
+        [[nodiscard]] const std::vector<int> &get_entry_rows() const { return entry_rows_; }
+        [[nodiscard]] const std::vector<int> &get_entry_columns() const { return entry_columns_; }
+        [[nodiscard]] const std::vector<int> &get_entry_positions() const { return entry_positions_; }
+
+        /**
+         * \brief sets the Jacobian to 0 outside the pattern, a sparse Jacobian must have the pattern
+         */
+        void clear(MatrixView jacobian) const;
+
+        void check(const SparseMatrix &jacobian) const;
+
+    private:
+        int size_;
+        int colors_;
+        bool dense_;
+        std::vector<int> column_colors_;
+        std::vector<int> color_ptr_;
+        std::vector<int> color_columns_;
+        std::vector<int> entry_ptr_;
+        std::vector<int> entry_rows_;
+        std::vector<int> entry_columns_;
+        std::vector<int> entry_positions_;
+    };
+
+    namespace details {
+        /* stores value(i, j) for the nonzeros (i, j) of color c into a dense Jacobian */
+        template<class Value>
+        void store_color(MatrixView jacobian, const JacobianColoring &coloring, const int c, Value &&value) {
+            if (coloring.is_dense()) {
+                for (int i = 0; i < coloring.get_size(); i++) jacobian(i, c) = value(i, c);
+                return;
+            }
+            const std::vector<int> &entry_ptr = coloring.get_entry_ptr();
+            const std::vector<int> &entry_rows = coloring.get_entry_rows();
+            const std::vector<int> &entry_columns = coloring.get_entry_columns();
+            for (int e = entry_ptr[c]; e < entry_ptr[c + 1]; e++) {
+                jacobian(entry_rows[e], entry_columns[e]) = value(entry_rows[e], entry_columns[e]);
+            }
+        }
+
+        /* the same into a sparse Jacobian with the pattern of the coloring, which is not dense */
+        template<class Value>
+        void store_color(SparseMatrix &jacobian, const JacobianColoring &coloring, const int c, Value &&value) {
+            const std::vector<int> &entry_ptr = coloring.get_entry_ptr();
+            const std::vector<int> &entry_rows = coloring.get_entry_rows();
+            const std::vector<int> &entry_columns = coloring.get_entry_columns();
+            const std::vector<int> &entry_positions = coloring.get_entry_positions();
+            for (int e = entry_ptr[c]; e < entry_ptr[c + 1]; e++) {
+                jacobian.get_values()[entry_positions[e]] = value(entry_rows[e], entry_columns[e]);
+            }
+        }
+
+        inline void prepare_jacobian(MatrixView jacobian, const JacobianColoring &coloring) {
+            if (jacobian.get_rows() != coloring.get_size() || jacobian.get_cols() != coloring.get_size()) {
+                throw std::logic_error("Check size of Jacobian");
+            }
+            coloring.clear(jacobian);
+        }
+
+        inline void prepare_jacobian(const SparseMatrix &jacobian, const JacobianColoring &coloring) {
+            coloring.check(jacobian);
+        }
+    }
+
+    /**
+     * \brief Jacobian J = dF/dy and dF/dt of a system y' = F(t, y) by forward mode automatic differentiation.
+     * F is a functor templated on the number type, template<class T> int operator()(int n, T t, T y[], T yp[]),
+     * instantiated with double it is an ordinary right hand side of rkf45. One call of F with Dual<N> gives
+     * N directional derivatives, so a dense Jacobian costs (n + 1) / N calls and a colored one (colors + 1) / N,
+     * the derivatives are exact up to rounding.
+     */
+    template<class F, int N = DUAL_LANES>
+    class AutoJacobian {
+    public:
+        /**
+         * \brief dense Jacobian of order neqn
+         */
+        AutoJacobian(F fun, const int neqn):
+            AutoJacobian(std::move(fun), JacobianColoring(neqn)) {
+        }
+
+        /**
+         * \brief Jacobian with the nonzero pattern of the coloring, its directions are the colors
+         */
+        AutoJacobian(F fun, JacobianColoring coloring):
+            fun_(std::move(fun)),
+            coloring_(std::move(coloring)),
+            sweeps_(0),
+            y_(coloring_.get_size()),
+            yp_(coloring_.get_size()) {
+            if (coloring_.get_size() < 1) {
+                throw std::logic_error("Check number of equations");
+            }
+        }
+
+        /**
+         * \brief evaluate the Jacobian at (t, y), the arguments of Rosenbrock23::Jacobian
+         * \param yp F(t, y), not used, the values come with the derivatives
+         * \param jacobian dense matrix of order neqn, or a SparseMatrix with the pattern of the coloring
+         * \param dfdt dF/dt, not computed if NULL
+         * \return number of calls of F
+         */
+        template<class Jacobian>
+        int operator()(const double t, const double y[], const double yp[], Jacobian &&jacobian,
+                       double dfdt[] = nullptr) {
+            const int n = coloring_.get_size();
+            const int colors = coloring_.get_colors();
+            const int directions = colors + (dfdt != nullptr ? 1 : 0);
+            const std::vector<int> &column_colors = coloring_.get_column_colors();
+            details::prepare_jacobian(jacobian, coloring_);
+            sweeps_ = 0;
+            for (int first = 0; first < std::max(directions, 1); first += N) {
+                /* seed lane k with the sum of the unit vectors of color first + k, the lane after
+                   the last color with t */
+                for (int j = 0; j < n; j++) {
+                    y_[j] = Dual<N>(y[j]);
+                    const int k = column_colors[j] - first;
+                    if (k >= 0 && k < N) y_[j].derivative[k] = 1.0;
+                }
+                Dual<N> ts(t);
+                if (dfdt != nullptr && colors - first >= 0 && colors - first < N) ts.derivative[colors - first] = 1.0;
+                fun_(n, ts, y_.data(), yp_.data());
+                sweeps_++;
+
+                const int last = std::min(first + N, colors);
+                for (int c = first; c < last; c++) {
+                    details::store_color(jacobian, coloring_, c, [&](const int i, int) {
+                        return yp_[i].derivative[c - first];
+                    });
+                }
+                if (dfdt != nullptr && colors - first >= 0 && colors - first < N) {
+                    for (int i = 0; i < n; i++) dfdt[i] = yp_[i].derivative[colors - first];
+                }
+            }
+            return sweeps_;
+        }
+
+        [[nodiscard]] const JacobianColoring &getColoring() const { return coloring_; }
+        [[nodiscard]] int getSweeps() const { return sweeps_; }
+
+    private:
+        F fun_;
+        JacobianColoring coloring_;
+        int sweeps_;
+        std::vector<Dual<N> > y_;
+        std::vector<Dual<N> > yp_;
+    };
+
+    /**
+     * \brief Jacobian J = dF/dy and dF/dt of a system y' = F(t, y) by forward differences, all columns of a
+     * color are perturbed at once. F is any callable int(int n, double t, double y[], double yp[]), a sparse
+     * Jacobian costs colors + 1 calls of F instead of n + 1. The fallback for right hand sides that are not
+     * templated on the number type.
+     */
+    template<class F>
+    class ColoredJacobian {
+    public:
+        /**
+         * \brief dense Jacobian of order neqn
+         */
+        ColoredJacobian(F fun, const int neqn):
+            ColoredJacobian(std::move(fun), JacobianColoring(neqn)) {
+        }
+
+        /**
+         * \brief Jacobian with the nonzero pattern of the coloring
+         */
+        ColoredJacobian(F fun, JacobianColoring coloring):
+            fun_(std::move(fun)),
+            coloring_(std::move(coloring)),
+            y_(coloring_.get_size()),
+            f_(coloring_.get_size()),
+            delta_(coloring_.get_size()) {
+            if (coloring_.get_size() < 1) {
+                throw std::logic_error("Check number of equations");
+            }
+        }
+
+        /**
+         * \brief evaluate the Jacobian at (t, y), the arguments of Rosenbrock23::Jacobian
+         * \param yp F(t, y)
+         * \param jacobian dense matrix of order neqn, or a SparseMatrix with the pattern of the coloring
+         * \param dfdt dF/dt, not computed if NULL
+         * \return number of calls of F
+         */
+        template<class Jacobian>
+        int operator()(const double t, const double y[], const double yp[], Jacobian &&jacobian,
+                       double dfdt[] = nullptr) {
+            constexpr double SQRT_EPSILON = 1.4832396974191326e-08;
+            const int n = coloring_.get_size();
+            const int colors = coloring_.get_colors();
+            const std::vector<int> &color_ptr = coloring_.get_color_ptr();
+            const std::vector<int> &color_columns = coloring_.get_color_columns();
+            details::prepare_jacobian(jacobian, coloring_);
+            std::copy(y, y + n, y_.begin());
+            for (int j = 0; j < n; j++) {
+                delta_[j] = SQRT_EPSILON * std::max(std::fabs(y[j]), 1.0e-5);
+            }
+            int calls = 0;
+            for (int c = 0; c < colors; c++) {
+                for (int q = color_ptr[c]; q < color_ptr[c + 1]; q++) {
+                    const int j = color_columns[q];
+                    y_[j] = y[j] + delta_[j];
+                }
+                fun_(n, t, y_.data(), f_.data());
+                calls++;
+                for (int q = color_ptr[c]; q < color_ptr[c + 1]; q++) {
+                    const int j = color_columns[q];
+                    y_[j] = y[j];
+                }
+                details::store_color(jacobian, coloring_, c, [&](const int i, const int j) {
+                    return (f_[i] - yp[i]) / delta_[j];
+                });
+            }
+            if (dfdt != nullptr) {
+                const double delta = SQRT_EPSILON * std::max(std::fabs(t), 1.0);
+                fun_(n, t + delta, y_.data(), f_.data());
+                calls++;
+                for (int i = 0; i < n; i++) dfdt[i] = (f_[i] - yp[i]) / delta;
+            }
+            return calls;
+        }
+
+        [[nodiscard]] const JacobianColoring &getColoring() const { return coloring_; }
+
+    private:
+        F fun_;
+        JacobianColoring coloring_;
+        std::vector<double> y_;
+        std::vector<double> f_;
+        std::vector<double> delta_;
+    };
+}
+#endif
@@ -0,0 +1,358 @@
+#include "Krylov.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "../common/Statistics.h"
+#include "../common/Workspace.h"
+
+namespace {
+    double dot(const double x[], const double y[], const std::size_t n) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < n; i++) sum += x[i] * y[i];
+        return sum;
+    }
+
+    double norm(const double x[], const std::size_t n) {
+        return std::sqrt(dot(x, x, n));
+    }
+
+    void precondition(const dimkashelk::Preconditioner &m, const double r[], double z[], const std::size_t n) {
+        if (m) {
+            m(r, z);
+        } else {
+            std::copy(r, r + n, z);
+        }
+    }
+}
+
+dimkashelk::LinearOperator dimkashelk::make_operator(const SparseMatrix &matrix) {
+    return [&matrix](const double x[], double y[]) {
+        const std::vector<int> &row_ptr = matrix.get_row_ptr();
+        const std::vector<int> &columns = matrix.get_columns();
+        const std::vector<double> &values = matrix.get_values();
+        for (int i = 0; i < matrix.get_size(); i++) {
+            double sum = 0.0;
+            for (int p = row_ptr[i]; p < row_ptr[i + 1]; p++) sum += values[p] * x[columns[p]];
+            y[i] = sum;
+        }
+    };
+}
+
+dimkashelk::KrylovSolve::KrylovSolve(const Method method, const double tolerance, const int max_iterations,
+                                     const int restart): method_(method),
+                                                         tolerance_(tolerance),
+                                                         max_iterations_(max_iterations),
+                                                         restart_(restart),
+                                                         flag_(0),
+                                                         iterations_(0),
+                                                         matvecs_(0),
+                                                         residual_(0.0) {
+    if (tolerance <= 0.0 || max_iterations < 1 || restart < 1) {
+        throw std::logic_error("Check parameters of Krylov solver");
+    }
+}
+
+void dimkashelk::KrylovSolve::operator()(const LinearOperator &a, const std::vector<double> &matrix_right,
+                                         const Preconditioner &m) {
+    result_.assign(matrix_right.size(), 0.0);
+    run(a, matrix_right, m);
+}
+
+void dimkashelk::KrylovSolve::operator()(const LinearOperator &a, const std::vector<double> &matrix_right,
+                                         const Preconditioner &m, const std::vector<double> &guess) {
+    if (guess.size() != matrix_right.size()) {
+        throw std::logic_error("Check data");
+    }
+    result_ = guess;
+    run(a, matrix_right, m);
+}
+
+void dimkashelk::KrylovSolve::run(const LinearOperator &a, const std::vector<double> &matrix_right,
+                                  const Preconditioner &m) {
+    if (!a || matrix_right.empty()) {
+        throw std::logic_error("Check data");
+    }
+    const std::size_t n = matrix_right.size();
+    flag_ = 0;
+    iterations_ = 0;
+    matvecs_ = 0;
+    residuals_.clear();
+    Workspace &workspace = thread_workspace();
+    Workspace::Scope scope(workspace);
+    double *r = workspace.allocate<double>(n);
+    apply(a, result_.data(), r);
+    for (std::size_t i = 0; i < n; i++) r[i] = matrix_right[i] - r[i];
+    const double bnorm = norm(matrix_right.data(), n);
+    if (bnorm == 0.0) {
+        result_.assign(n, 0.0);
+        residual_ = 0.0;
+        return;
+    }
+    residual_ = norm(r, n) / bnorm;
+    if (residual_ > tolerance_) {
+        switch (method_) {
+            case Method::CONJUGATE_GRADIENT:
+                conjugate_gradient(a, matrix_right, m, r, bnorm);
+                break;
+            case Method::GMRES:
+                gmres(a, matrix_right, m, r, bnorm);
+                break;
+            case Method::BICGSTAB:
+                bicgstab(a, matrix_right, m, r, bnorm);
+                break;
+        }
+        /* the recurrences only estimate the residual, a converged method whose true residual misses the
+           tolerance is reported apart */
+        apply(a, result_.data(), r);
+        for (std::size_t i = 0; i < n; i++) r[i] = matrix_right[i] - r[i];
+        residual_ = norm(r, n) / bnorm;
+        if (flag_ == 0 && !(residual_ <= tolerance_)) {
+            flag_ = 3;
+        }
+    }
+}
+
+std::size_t dimkashelk::KrylovSolve::workspace_size(const int n) const {
+    const std::size_t vector = Workspace::bytes<double>(n);
+    switch (method_) {
+        case Method::CONJUGATE_GRADIENT:
+            return 4 * vector;
+        case Method::GMRES:
+            return (restart_ + 4) * vector + Workspace::bytes<double>(static_cast<std::size_t>(restart_) * (restart_ + 1)) +
+                   3 * Workspace::bytes<double>(restart_) + Workspace::bytes<double>(restart_ + 1);
+        case Method::BICGSTAB:
+            return 8 * vector;
+    }
+    return 0;
+}
+
+void dimkashelk::KrylovSolve::apply(const LinearOperator &a, const double x[], double y[]) {
+    NUMERICS_COUNT(MATVECS, 1);
+    matvecs_++;
+    a(x, y);
+}
+
+bool dimkashelk::KrylovSolve::record(const double residual) {
+    iterations_++;
+    residuals_.push_back(residual);
+    return residual <= tolerance_;
+}
+
+void dimkashelk::KrylovSolve::conjugate_gradient(const LinearOperator &a, const std::vector<double> &b,
+                                                 const Preconditioner &m, double r[], const double bnorm) {
+    const std::size_t n = b.size();
+    double *x = result_.data();
+    Workspace &workspace = thread_workspace();
+    double *z = workspace.allocate<double>(n);
+    double *q = workspace.allocate<double>(n);
+    double *p = workspace.allocate<double>(n);
+    precondition(m, r, z, n);
+    std::copy(z, z + n, p);
+    double rz = dot(r, z, n);
+    while (iterations_ < max_iterations_) {
+        apply(a, p, q);
+        const double pq = dot(p, q, n);
+        if (!(pq > 0.0)) {
+            /* a or M is not positive definite */
+            flag_ = 2;
+            return;
+        }
+        const double alpha = rz / pq;
+        for (std::size_t i = 0; i < n; i++) {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+        }
+        if (record(norm(r, n) / bnorm)) {
+            return;
+        }
+        precondition(m, r, z, n);
+        const double rz_next = dot(r, z, n);
+        const double beta = rz_next / rz;
+        rz = rz_next;
+        for (std::size_t i = 0; i < n; i++) p[i] = z[i] + beta * p[i];
+    }
+    flag_ = 1;
+}
+
+void dimkashelk::KrylovSolve::gmres(const LinearOperator &a, const std::vector<double> &b, const Preconditioner &m,
+                                    double r[], const double bnorm) {
+    const std::size_t n = b.size();
+    const int restart = restart_;
+    double *x = result_.data();
+    Workspace &workspace = thread_workspace();
+    /* basis vector i is v + i * n */
+    double *v = workspace.allocate<double>(static_cast<std::size_t>(restart + 1) * n);
+    /* Hessenberg matrix by columns, h[j * (restart + 1) + i] = H(i, j) */
+    double *h = workspace.allocate<double>(static_cast<std::size_t>(restart) * (restart + 1));
+    double *cs = workspace.allocate<double>(restart);
+    double *sn = workspace.allocate<double>(restart);
+    double *g = workspace.allocate<double>(restart + 1);
+    double *y = workspace.allocate<double>(restart);
+    double *w = workspace.allocate<double>(n);
+    double *z = workspace.allocate<double>(n);
+    auto H = [&](const int i, const int j) -> double & { return h[static_cast<std::size_t>(j) * (restart + 1) + i]; };
+    auto V = [&](const int i) { return v + static_cast<std::size_t>(i) * n; };
+
+    for (;;) {
+        const double beta = norm(r, n);
+        for (std::size_t i = 0; i < n; i++) V(0)[i] = r[i] / beta;
+        std::fill(g, g + restart + 1, 0.0);
+        g[0] = beta;
+        int k = 0;
+        bool converged = false;
+        for (int j = 0; j < restart; j++) {
+            precondition(m, V(j), z, n);
+            apply(a, z, w);
+            for (int i = 0; i <= j; i++) {
+                const double t = dot(w, V(i), n);
+                H(i, j) = t;
+                for (std::size_t l = 0; l < n; l++) w[l] -= t * V(i)[l];
+            }
+            const double next = norm(w, n);
+            H(j + 1, j) = next;
+            for (int i = 0; i < j; i++) {
+                const double t = cs[i] * H(i, j) + sn[i] * H(i + 1, j);
+                H(i + 1, j) = -sn[i] * H(i, j) + cs[i] * H(i + 1, j);
+                H(i, j) = t;
+            }
+            const double d = std::hypot(H(j, j), H(j + 1, j));
+            if (d == 0.0) {
+                /* singular Hessenberg matrix, the Krylov space is invariant but a is singular */
+                flag_ = 2;
+                break;
+            }
+            cs[j] = H(j, j) / d;
+            sn[j] = H(j + 1, j) / d;
+            H(j, j) = d;
+            H(j + 1, j) = 0.0;
+            g[j + 1] = -sn[j] * g[j];
+            g[j] = cs[j] * g[j];
+            k = j + 1;
+            converged = record(std::fabs(g[j + 1]) / bnorm);
+            if (converged || next == 0.0 || iterations_ >= max_iterations_) {
+                converged = converged || next == 0.0;
+                break;
+            }
+            for (std::size_t l = 0; l < n; l++) V(j + 1)[l] = w[l] / next;
+        }
+
+        /* x += M^-1 * V * y with H * y = g */
+        for (int i = k - 1; i >= 0; i--) {
+            double t = g[i];
+            for (int l = i + 1; l < k; l++) t -= H(i, l) * y[l];
+            y[i] = t / H(i, i);
+        }
+        std::fill(w, w + n, 0.0);
+        for (int i = 0; i < k; i++) {
+            for (std::size_t l = 0; l < n; l++) w[l] += y[i] * V(i)[l];
+        }
+        precondition(m, w, z, n);
+        for (std::size_t l = 0; l < n; l++) x[l] += z[l];
+
+        if (converged || flag_ == 2) {
+            return;
+        }
+        if (iterations_ >= max_iterations_) {
+            flag_ = 1;
+            return;
+        }
+        /* restart with the true residual */
+        apply(a, x, r);
+        for (std::size_t l = 0; l < n; l++) r[l] = b[l] - r[l];
+    }
+}
+
+void dimkashelk::KrylovSolve::bicgstab(const LinearOperator &a, const std::vector<double> &b,
+                                       const Preconditioner &m, double r[], const double bnorm) {
+    const std::size_t n = b.size();
+    double *x = result_.data();
+    Workspace &workspace = thread_workspace();
+    double *shadow = workspace.allocate<double>(n);
+    double *p = workspace.allocate<double>(n);
+    double *v = workspace.allocate<double>(n);
+    double *s = workspace.allocate<double>(n);
+    double *t = workspace.allocate<double>(n);
+    double *phat = workspace.allocate<double>(n);
+    double *shat = workspace.allocate<double>(n);
+    std::copy(r, r + n, shadow);
+    std::fill(p, p + n, 0.0);
+    std::fill(v, v + n, 0.0);
+    double rho = 1.0;
+    double alpha = 1.0;
+    double omega = 1.0;
+    while (iterations_ < max_iterations_) {
+        const double rho_next = dot(shadow, r, n);
+        if (rho_next == 0.0) {
+            flag_ = 2;
+            return;
+        }
+        const double beta = (rho_next / rho) * (alpha / omega);
+        for (std::size_t i = 0; i < n; i++) p[i] = r[i] + beta * (p[i] - omega * v[i]);
+        precondition(m, p, phat, n);
+        apply(a, phat, v);
+        const double shadow_v = dot(shadow, v, n);
+        if (shadow_v == 0.0) {
+            flag_ = 2;
+            return;
+        }
+        alpha = rho_next / shadow_v;
+        for (std::size_t i = 0; i < n; i++) s[i] = r[i] - alpha * v[i];
+        const double half = norm(s, n) / bnorm;
+        if (half <= tolerance_) {
+            for (std::size_t i = 0; i < n; i++) x[i] += alpha * phat[i];
+            record(half);
+            return;
+        }
+        precondition(m, s, shat, n);
+        apply(a, shat, t);
+        const double tt = dot(t, t, n);
+        if (tt == 0.0) {
+            flag_ = 2;
+            return;
+        }
+        omega = dot(t, s, n) / tt;
+        for (std::size_t i = 0; i < n; i++) {
+            x[i] += alpha * phat[i] + omega * shat[i];
+            r[i] = s[i] - omega * t[i];
+        }
+        if (record(norm(r, n) / bnorm)) {
+            return;
+        }
+        if (omega == 0.0) {
+            flag_ = 2;
+            return;
+        }
+        rho = rho_next;
+    }
+    flag_ = 1;
+}
+
+std::vector<double> dimkashelk::KrylovSolve::get_result() const {
+    return result_;
+}
+
+int dimkashelk::KrylovSolve::get_flag() const {
+    return flag_;
+}
+
+int dimkashelk::KrylovSolve::get_iterations() const {
+    return iterations_;
+}
+
+int dimkashelk::KrylovSolve::get_matvecs() const {
+    return matvecs_;
+}
+
+double dimkashelk::KrylovSolve::get_residual() const {
+    return residual_;
+}
+
+const std::vector<double> &dimkashelk::KrylovSolve::get_residuals() const {
+    return residuals_;
+}
+
+dimkashelk::KrylovSolve::Method dimkashelk::KrylovSolve::get_method() const {
+    return method_;
+}
@@ -0,0 +1,99 @@
+#ifndef KRYLOV_H
+#define KRYLOV_H
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "SparseMatrix.h"
+
+namespace dimkashelk {
+    /**
+     * \brief y = a * x for vectors of size n, the matrix need not exist
+     */
+    using LinearOperator = std::function<void(const double x[], double y[])>;
+
+    /**
+     * \brief z = M^-1 * r for an approximation M of the matrix, an empty function is M = I
+     */
+    using Preconditioner = std::function<void(const double r[], double z[])>;
+
+    /**
+     * \brief matrix-vector product of a sparse matrix, the matrix must outlive the operator
+     */
+    LinearOperator make_operator(const SparseMatrix &matrix);
+
+    /**
+     * \brief iterative solution of a * x = b by a preconditioned Krylov method, memory linear in n.
+     * flag 0: ||b - a x|| <= tolerance * ||b|| in the 2-norm,
+     * 1: not converged in max_iterations, 2: breakdown of the method,
+     * 3: the recursive residual met the tolerance but the true ||b - a x|| does not
+     */
+    class KrylovSolve {
+    public:
+        enum class Method {
+            /* conjugate gradients, a and M symmetric positive definite */
+            CONJUGATE_GRADIENT,
+            /* restarted GMRES(restart), right preconditioning, Arnoldi by modified Gram-Schmidt */
+            GMRES,
+            /* BiCGStab of van der Vorst, right preconditioning, two products with a per iteration */
+            BICGSTAB
+        };
+
+        explicit KrylovSolve(Method method = Method::GMRES, double tolerance = 1.0e-10, int max_iterations = 1000,
+                             int restart = 30);
+
+        /**
+         * \brief solve starting from x = 0
+         * \param a product with the matrix
+         * \param matrix_right right hand side
+         * \param m preconditioner, empty for none
+         */
+        void operator()(const LinearOperator &a, const std::vector<double> &matrix_right,
+                        const Preconditioner &m = Preconditioner());
+
+        void operator()(const LinearOperator &a, const std::vector<double> &matrix_right, const Preconditioner &m,
+                        const std::vector<double> &guess);
+
+        /**
+         * \brief bytes drawn from thread_workspace() by a solve of order n besides the preconditioner
+         */
+        [[nodiscard]] std::size_t workspace_size(int n) const;
+
+        [[nodiscard]] std::vector<double> get_result() const;
+        [[nodiscard]] int get_flag() const;
+        [[nodiscard]] int get_iterations() const;
+        [[nodiscard]] int get_matvecs() const;
+        /**
+         * \brief relative residual ||b - a x|| / ||b|| of the result
+         */
+        [[nodiscard]] double get_residual() const;
+        /**
+         * \brief relative residual after every iteration
+         */
+        [[nodiscard]] const std::vector<double> &get_residuals() const;
+        [[nodiscard]] Method get_method() const;
+
+    private:
+        Method method_;
+        double tolerance_;
+        int max_iterations_;
+        int restart_;
+        int flag_;
+        int iterations_;
+        int matvecs_;
+        double residual_;
+        std::vector<double> result_;
+        std::vector<double> residuals_;
+
+        void run(const LinearOperator &a, const std::vector<double> &matrix_right, const Preconditioner &m);
+        void apply(const LinearOperator &a, const double x[], double y[]);
+        bool record(double residual);
+        void conjugate_gradient(const LinearOperator &a, const std::vector<double> &b, const Preconditioner &m,
+                                double r[], double bnorm);
+        void gmres(const LinearOperator &a, const std::vector<double> &b, const Preconditioner &m,
+                   double r[], double bnorm);
+        void bicgstab(const LinearOperator &a, const std::vector<double> &b, const Preconditioner &m,
+                      double r[], double bnorm);
+    };
+}
+#endif
@@ -0,0 +1,112 @@
+#include "Matrix.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+#include "../common/Statistics.h"
+
+namespace {
+    int get_padded_stride(const int cols) {
+        constexpr int count = static_cast<int>(dimkashelk::Matrix::MATRIX_ALIGNMENT / sizeof(double));
+        return (cols + count - 1) / count * count;
+    }
+}
+
+void dimkashelk::Matrix::Deleter::operator()(double *data) const {
+    std::free(data);
+}
+
+dimkashelk::Matrix::Matrix(): data_(nullptr),
+                              rows_(0),
+                              cols_(0),
+                              stride_(0),
+                              capacity_(0) {
+}
+
+dimkashelk::Matrix::Matrix(const int rows, const int cols): Matrix() {
+    resize(rows, cols);
+    std::fill(data_.get(), data_.get() + capacity_, 0.0);
+}
+
+dimkashelk::Matrix::Matrix(const std::vector<std::vector<double> > &matrix): Matrix() {
+    const int rows = static_cast<int>(matrix.size());
+    const int cols = rows == 0 ? 0 : static_cast<int>(matrix[0].size());
+    for (const auto &row: matrix) {
+        if (static_cast<int>(row.size()) != cols) {
+            throw std::logic_error("Check size of matrix");
+        }
+    }
+    resize(rows, cols);
+    for (int i = 0; i < rows; i++) {
+        std::copy(matrix[i].begin(), matrix[i].end(), data_.get() + static_cast<std::size_t>(i) * stride_);
+    }
+}
+
+dimkashelk::Matrix::Matrix(const ConstMatrixView &matrix): Matrix() {
+    resize(matrix.get_rows(), matrix.get_cols());
+    for (int i = 0; i < rows_; i++) {
+        std::copy(matrix.get_row(i), matrix.get_row(i) + cols_, data_.get() + static_cast<std::size_t>(i) * stride_);
+    }
+}
+
+dimkashelk::Matrix::Matrix(const Matrix &other): Matrix(other.get_view()) {
+}
+
+dimkashelk::Matrix::Matrix(Matrix &&other) noexcept: data_(std::move(other.data_)),
+                                                     rows_(other.rows_),
+                                                     cols_(other.cols_),
+                                                     stride_(other.stride_),
+                                                     capacity_(other.capacity_) {
+    other.rows_ = 0;
+    other.cols_ = 0;
+    other.stride_ = 0;
+    other.capacity_ = 0;
+}
+
+dimkashelk::Matrix &dimkashelk::Matrix::operator=(const Matrix &other) {
+    if (this != std::addressof(other)) {
+        resize(other.rows_, other.cols_);
+        for (int i = 0; i < rows_; i++) {
+            std::copy(other.get_view().get_row(i), other.get_view().get_row(i) + cols_,
+                      data_.get() + static_cast<std::size_t>(i) * stride_);
+        }
+    }
+    return *this;
+}
+
+dimkashelk::Matrix &dimkashelk::Matrix::operator=(Matrix &&other) noexcept {
+    if (this != std::addressof(other)) {
+        data_ = std::move(other.data_);
+        rows_ = other.rows_;
+        cols_ = other.cols_;
+        stride_ = other.stride_;
+        capacity_ = other.capacity_;
+        other.rows_ = 0;
+        other.cols_ = 0;
+        other.stride_ = 0;
+        other.capacity_ = 0;
+    }
+    return *this;
+}
+
+void dimkashelk::Matrix::resize(const int rows, const int cols) {
+    if (rows < 0 || cols < 0) {
+        throw std::logic_error("Check size of matrix");
+    }
+    const int stride = get_padded_stride(cols);
+    const std::size_t size = static_cast<std::size_t>(rows) * stride;
+    if (size > capacity_) {
+        void *data = std::aligned_alloc(MATRIX_ALIGNMENT, size * sizeof(double));
+        if (data == nullptr) {
+            throw std::bad_alloc();
+        }
+        NUMERICS_COUNT(BYTES_ALLOCATED, size * sizeof(double));
+        data_.reset(static_cast<double *>(data));
+        capacity_ = size;
+    }
+    rows_ = rows;
+    cols_ = cols;
+    stride_ = stride;
+}
@@ -0,0 +1,128 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace dimkashelk {
+    /**
+     * \brief non-owning view of a dense matrix in rowwise storage,
+     * element (i, j) is data[i * stride + j]
+     */
+    template<class T>
+    class BasicMatrixView {
+    public:
+        BasicMatrixView(): data_(nullptr),
+                           rows_(0),
+                           cols_(0),
+                           stride_(0) {
+        }
+
+        BasicMatrixView(T *data, const int rows, const int cols, const int stride): data_(data),
+            rows_(rows),
+            cols_(cols),
+            stride_(stride) {
+        }
+
+        BasicMatrixView(T *data, const int rows, const int cols): BasicMatrixView(data, rows, cols, cols) {
+        }
+
+        template<class U, class = std::enable_if_t<std::is_convertible_v<U *, T *> > >
+        BasicMatrixView(const BasicMatrixView<U> &other): BasicMatrixView(other.get_data(), other.get_rows(),
+                                                                          other.get_cols(), other.get_stride()) {
+        }
+
+        T &operator()(const int i, const int j) const {
+            return data_[static_cast<std::size_t>(i) * stride_ + j];
+        }
+
+        [[nodiscard]] T *get_row(const int i) const {
+            return data_ + static_cast<std::size_t>(i) * stride_;
+        }
+
+        /**
+         * \brief view of the rows x cols block starting at (row, col)
+         */
+        [[nodiscard]] BasicMatrixView get_block(const int row, const int col, const int rows, const int cols) const {
+            return BasicMatrixView(get_row(row) + col, rows, cols, stride_);
+        }
+
+        [[nodiscard]] T *get_data() const { return data_; }
+        [[nodiscard]] int get_rows() const { return rows_; }
+        [[nodiscard]] int get_cols() const { return cols_; }
+        [[nodiscard]] int get_stride() const { return stride_; }
+        [[nodiscard]] bool empty() const { return rows_ == 0 || cols_ == 0; }
+
+    private:
+        T *data_;
+        int rows_;
+        int cols_;
+        int stride_;
+    };
+
+    using MatrixView = BasicMatrixView<double>;
+    using ConstMatrixView = BasicMatrixView<const double>;
+
+    /**
+     * \brief owning dense matrix in rowwise storage,
+     * rows are padded to MATRIX_ALIGNMENT bytes and start aligned
+     */
+    class Matrix {
+    public:
+        static constexpr std::size_t MATRIX_ALIGNMENT = 64;
+
+        Matrix();
+
+        Matrix(int rows, int cols);
+
+        explicit Matrix(const std::vector<std::vector<double> > &matrix);
+
+        explicit Matrix(const ConstMatrixView &matrix);
+
+        Matrix(const Matrix &other);
+
+        Matrix(Matrix &&other) noexcept;
+
+        Matrix &operator=(const Matrix &other);
+
+        Matrix &operator=(Matrix &&other) noexcept;
+
+        /**
+         * \brief change the shape, the storage is reused when it is large enough,
+         * the content is unspecified afterwards
+         */
+        void resize(int rows, int cols);
+
+        double &operator()(const int i, const int j) {
+            return data_[static_cast<std::size_t>(i) * stride_ + j];
+        }
+
+        const double &operator()(const int i, const int j) const {
+            return data_[static_cast<std::size_t>(i) * stride_ + j];
+        }
+
+        operator MatrixView() { return get_view(); }
+        operator ConstMatrixView() const { return get_view(); }
+
+        [[nodiscard]] MatrixView get_view() { return {data_.get(), rows_, cols_, stride_}; }
+        [[nodiscard]] ConstMatrixView get_view() const { return {data_.get(), rows_, cols_, stride_}; }
+        [[nodiscard]] double *get_data() { return data_.get(); }
+        [[nodiscard]] const double *get_data() const { return data_.get(); }
+        [[nodiscard]] int get_rows() const { return rows_; }
+        [[nodiscard]] int get_cols() const { return cols_; }
+        [[nodiscard]] int get_stride() const { return stride_; }
+
+    private:
+        struct Deleter {
+            void operator()(double *data) const;
+        };
+
+        std::unique_ptr<double[], Deleter> data_;
+        int rows_;
+        int cols_;
+        int stride_;
+        std::size_t capacity_;
+    };
+}
+#endif
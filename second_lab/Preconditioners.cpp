@@ -0,0 +1,77 @@
+#include "Preconditioners.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+dimkashelk::JacobiPreconditioner::JacobiPreconditioner(const SparseMatrix &matrix): inverse_(matrix.get_size(), 0.0) {
+    const std::vector<int> &row_ptr = matrix.get_row_ptr();
+    const std::vector<int> &columns = matrix.get_columns();
+    const std::vector<double> &values = matrix.get_values();
+    for (int i = 0; i < matrix.get_size(); i++) {
+        for (int p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+            if (columns[p] == i && values[p] != 0.0) inverse_[i] = 1.0 / values[p];
+        }
+        if (inverse_[i] == 0.0) {
+            throw std::logic_error("Check diagonal of matrix");
+        }
+    }
+}
+
+void dimkashelk::JacobiPreconditioner::operator()(const double r[], double z[]) const {
+    for (std::size_t i = 0; i < inverse_.size(); i++) z[i] = inverse_[i] * r[i];
+}
+
+dimkashelk::Ilu0Preconditioner::Ilu0Preconditioner(const SparseMatrix &matrix): size_(matrix.get_size()),
+    row_ptr_(matrix.get_row_ptr()),
+    columns_(matrix.get_columns()),
+    diagonal_(matrix.get_size(), -1),
+    values_(matrix.get_values()) {
+    const double EPSILON = 2.2e-16;
+    const int n = size_;
+    double anorm = 0.0;
+    for (int i = 0; i < n; i++) {
+        double sum = 0.0;
+        for (int p = row_ptr_[i]; p < row_ptr_[i + 1]; p++) {
+            if (columns_[p] == i) diagonal_[i] = p;
+            sum += std::fabs(values_[p]);
+        }
+        anorm = std::max(anorm, sum);
+        if (diagonal_[i] < 0) {
+            throw std::logic_error("Check diagonal of matrix");
+        }
+    }
+
+    /* row i is eliminated by the rows k < i of its pattern, updates outside the pattern are dropped */
+    std::vector<int> position(n, -1);
+    for (int i = 0; i < n; i++) {
+        for (int p = row_ptr_[i]; p < row_ptr_[i + 1]; p++) position[columns_[p]] = p;
+        for (int p = row_ptr_[i]; p < diagonal_[i]; p++) {
+            const int k = columns_[p];
+            const double t = values_[p] / values_[diagonal_[k]];
+            values_[p] = t;
+            for (int q = diagonal_[k] + 1; q < row_ptr_[k + 1]; q++) {
+                const int target = position[columns_[q]];
+                if (target >= 0) values_[target] -= t * values_[q];
+            }
+        }
+        for (int p = row_ptr_[i]; p < row_ptr_[i + 1]; p++) position[columns_[p]] = -1;
+        if (std::fabs(values_[diagonal_[i]]) <= anorm * EPSILON) {
+            throw std::logic_error("Check matrix, zero pivot in ILU(0)");
+        }
+    }
+}
+
+void dimkashelk::Ilu0Preconditioner::operator()(const double r[], double z[]) const {
+    /* L * y = r with unit L, then U * z = y */
+    for (int i = 0; i < size_; i++) {
+        double t = r[i];
+        for (int p = row_ptr_[i]; p < diagonal_[i]; p++) t -= values_[p] * z[columns_[p]];
+        z[i] = t;
+    }
+    for (int i = size_ - 1; i >= 0; i--) {
+        double t = z[i];
+        for (int p = diagonal_[i] + 1; p < row_ptr_[i + 1]; p++) t -= values_[p] * z[columns_[p]];
+        z[i] = t / values_[diagonal_[i]];
+    }
+}
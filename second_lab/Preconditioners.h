@@ -0,0 +1,40 @@
+#ifndef PRECONDITIONERS_H
+#define PRECONDITIONERS_H
+#include <vector>
+
+#include "SparseMatrix.h"
+
+namespace dimkashelk {
+    /**
+     * \brief M = diag(a), usable as Preconditioner
+     */
+    class JacobiPreconditioner {
+    public:
+        explicit JacobiPreconditioner(const SparseMatrix &matrix);
+
+        void operator()(const double r[], double z[]) const;
+
+    private:
+        std::vector<double> inverse_;
+    };
+
+    /**
+     * \brief incomplete LU factorization without fill, L and U keep the pattern of a,
+     * gaussian elimination of decomp() restricted to the nonzeros and without pivoting.
+     * Every diagonal element must be present and stay nonzero, usable as Preconditioner
+     */
+    class Ilu0Preconditioner {
+    public:
+        explicit Ilu0Preconditioner(const SparseMatrix &matrix);
+
+        void operator()(const double r[], double z[]) const;
+
+    private:
+        int size_;
+        std::vector<int> row_ptr_;
+        std::vector<int> columns_;
+        std::vector<int> diagonal_;
+        std::vector<double> values_;
+    };
+}
+#endif
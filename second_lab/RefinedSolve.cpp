@@ -0,0 +1,223 @@
+#include "RefinedSolve.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+#include "../common/Workspace.h"
+
+dimkashelk::RefinedSolve::RefinedSolve(const double cond_limit, const int max_iterations): cond_limit_(cond_limit),
+    max_iterations_(max_iterations),
+    size_(0),
+    stride_(0),
+    anorm_(0.0),
+    cond_(0.0),
+    flag_(0),
+    iterations_(0),
+    mixed_(false),
+    fallback_ready_(false),
+    residual_(0.0),
+    scale_(1.0) {
+    if (cond_limit <= 0.0 || max_iterations < 1) {
+        throw std::logic_error("Check parameters of refinement");
+    }
+}
+
+void dimkashelk::RefinedSolve::operator()(const ConstMatrixView &matrix) {
+    if (matrix.empty()) {
+        throw std::logic_error("Check matrix");
+    }
+    if (matrix.get_rows() != matrix.get_cols()) {
+        throw std::logic_error("Check size of matrix");
+    }
+    const int size = matrix.get_rows();
+    matrix_.resize(size, size);
+    for (int i = 0; i < size; i++) {
+        std::copy(matrix.get_row(i), matrix.get_row(i) + size, matrix_.get_view().get_row(i));
+    }
+    factorize();
+}
+
+void dimkashelk::RefinedSolve::operator()(const std::vector<std::vector<double> > &matrix) {
+    if (matrix.empty()) {
+        throw std::logic_error("Check matrix");
+    }
+    for (const auto &row: matrix) {
+        if (matrix.size() != row.size()) {
+            throw std::logic_error("Check size of matrix");
+        }
+    }
+    const int size = static_cast<int>(matrix.size());
+    matrix_.resize(size, size);
+    for (int i = 0; i < size; i++) {
+        std::copy(matrix[i].begin(), matrix[i].end(), matrix_.get_view().get_row(i));
+    }
+    factorize();
+}
+
+void dimkashelk::RefinedSolve::operator()(const ConstMatrixView &matrix_left,
+                                          const std::vector<double> &matrix_right) {
+    if (matrix_left.get_rows() != static_cast<int>(matrix_right.size())) {
+        throw std::logic_error("Check data");
+    }
+    operator()(matrix_left);
+    operator()(matrix_right);
+}
+
+void dimkashelk::RefinedSolve::factorize() {
+    size_ = matrix_.get_rows();
+    stride_ = matrix_.get_stride();
+    const int n = size_;
+    factors_.resize(static_cast<std::size_t>(n) * stride_);
+    pivot_.resize(n);
+    result_.resize(n);
+    residuals_.resize(n);
+    correction_.resize(n);
+    anorm_ = 0.0;
+    double amax = 0.0;
+    for (int i = 0; i < n; i++) {
+        const double *row = matrix_.get_view().get_row(i);
+        double sum = 0.0;
+        for (int j = 0; j < n; j++) {
+            sum += std::fabs(row[j]);
+            amax = std::max(amax, std::fabs(row[j]));
+        }
+        anorm_ = std::max(anorm_, sum);
+    }
+    fallback_ready_ = false;
+    /* the float copy is scaled by a power of 2 to max |a_ij| in [1, 2), so no entry overflows and only
+       entries below 2^-126 max |a_ij| are flushed to 0, a matrix without that scale goes to double */
+    if (!(amax > 0.0 && amax <= DBL_MAX)) {
+        decomp_(matrix_.get_view());
+        fallback_ready_ = true;
+        cond_ = decomp_.get_cond();
+        flag_ = decomp_.get_flag();
+        mixed_ = false;
+        return;
+    }
+    scale_ = std::ldexp(1.0, -std::ilogb(amax));
+    for (int i = 0; i < n; i++) {
+        const double *row = matrix_.get_view().get_row(i);
+        for (int j = 0; j < n; j++) {
+            factors_[static_cast<std::size_t>(i) * stride_ + j] = static_cast<float>(row[j] * scale_);
+        }
+    }
+    double cond = 0.0;
+    int flag = 0;
+    Workspace &workspace = thread_workspace();
+    Workspace::Scope scope(workspace);
+    float *work = workspace.allocate<float>(details::decomp_workspace(n));
+    details::decomp(n, stride_, factors_.data(), std::addressof(cond), pivot_.data(), std::addressof(flag), nullptr,
+                    work);
+    cond_ = cond;
+    flag_ = flag;
+    mixed_ = flag == 0 && cond < cond_limit_;
+}
+
+double dimkashelk::RefinedSolve::compute_residual(const std::vector<double> &matrix_right) {
+    /* r = b - a * x against the original matrix in double */
+    double norm = 0.0;
+    for (int i = 0; i < size_; i++) {
+        const double *row = matrix_.get_view().get_row(i);
+        double sum = 0.0;
+        for (int j = 0; j < size_; j++) {
+            sum += row[j] * result_[j];
+        }
+        residuals_[i] = matrix_right[i] - sum;
+        norm = std::max(norm, std::fabs(residuals_[i]));
+    }
+    return norm;
+}
+
+void dimkashelk::RefinedSolve::solve_double(const std::vector<double> &matrix_right) {
+    if (!fallback_ready_) {
+        decomp_(matrix_.get_view());
+        fallback_ready_ = true;
+    }
+    cond_ = decomp_.get_cond();
+    flag_ = decomp_.get_flag();
+    solve_(decomp_, matrix_right);
+    result_ = solve_.get_result();
+    iterations_ = 0;
+    mixed_ = false;
+    residual_ = compute_residual(matrix_right);
+}
+
+void dimkashelk::RefinedSolve::operator()(const std::vector<double> &matrix_right) {
+    if (size_ == 0 || static_cast<int>(matrix_right.size()) != size_) {
+        throw std::logic_error("Check data");
+    }
+    if (!mixed_) {
+        solve_double(matrix_right);
+        return;
+    }
+    const int n = size_;
+    const double EPSILON = 2.2e-16;
+    const double limit = std::sqrt(static_cast<double>(n)) * anorm_ * EPSILON;
+    std::fill(result_.begin(), result_.end(), 0.0);
+    std::copy(matrix_right.begin(), matrix_right.end(), residuals_.begin());
+    residual_ = 0.0;
+    for (int i = 0; i < n; i++) {
+        residual_ = std::max(residual_, std::fabs(residuals_[i]));
+    }
+    if (residual_ == 0.0) {
+        iterations_ = 0;
+        return;
+    }
+    double previous = 0.0;
+    for (iterations_ = 1; ; iterations_++) {
+        /* x += a^-1 r with the float factors of scale * a, r is scaled to norm 1 so it neither
+           overflows nor underflows in float */
+        if (!(residual_ <= DBL_MAX)) {
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            correction_[i] = static_cast<float>(residuals_[i] / residual_);
+        }
+        details::solve(n, stride_, factors_.data(), correction_.data(), pivot_.data());
+        double xnorm = 0.0;
+        for (int i = 0; i < n; i++) {
+            result_[i] += residual_ * scale_ * correction_[i];
+            xnorm = std::max(xnorm, std::fabs(result_[i]));
+        }
+        if (!(xnorm <= DBL_MAX)) {
+            break;
+        }
+        residual_ = compute_residual(matrix_right);
+        if (residual_ <= limit * xnorm) {
+            return;
+        }
+        if (iterations_ >= max_iterations_ || (iterations_ > 1 && residual_ > 0.5 * previous)) {
+            /* no contraction, the float factors are not accurate enough */
+            break;
+        }
+        previous = residual_;
+    }
+    solve_double(matrix_right);
+}
+
+std::vector<double> dimkashelk::RefinedSolve::get_result() const {
+    return result_;
+}
+
+double dimkashelk::RefinedSolve::get_cond() const {
+    return cond_;
+}
+
+int dimkashelk::RefinedSolve::get_flag() const {
+    return flag_;
+}
+
+int dimkashelk::RefinedSolve::get_iterations() const {
+    return iterations_;
+}
+
+bool dimkashelk::RefinedSolve::is_mixed() const {
+    return mixed_;
+}
+
+double dimkashelk::RefinedSolve::get_residual() const {
+    return residual_;
+}
@@ -0,0 +1,87 @@
+#ifndef REFINED_SOLVE_H
+#define REFINED_SOLVE_H
+#include <vector>
+
+#include "Decomp.h"
+#include "Matrix.h"
+#include "Solve.h"
+
+namespace dimkashelk {
+    /**
+     * \brief solution of a * x = b with the factorization in float and iterative refinement,
+     * the residuals are computed in double against the original matrix.
+     * Falls back to Decomp and Solve in double when the condition estimate exceeds
+     * the limit, the float factorization fails or the refinement stagnates
+     */
+    class RefinedSolve {
+    public:
+        static constexpr double DEFAULT_COND_LIMIT = 1.0e+5;
+        static constexpr int DEFAULT_MAX_ITERATIONS = 30;
+
+        explicit RefinedSolve(double cond_limit = DEFAULT_COND_LIMIT, int max_iterations = DEFAULT_MAX_ITERATIONS);
+
+        RefinedSolve(const RefinedSolve &) = delete;
+
+        RefinedSolve &operator=(const RefinedSolve &) = delete;
+
+        /**
+         * \brief factorize a copy of the matrix, the original is kept for the residuals
+         * \param matrix square matrix
+         */
+        void operator()(const ConstMatrixView &matrix);
+
+        void operator()(const std::vector<std::vector<double> > &matrix);
+
+        /**
+         * \brief solve with the last factorization
+         * \param matrix_right right hand side
+         */
+        void operator()(const std::vector<double> &matrix_right);
+
+        void operator()(const ConstMatrixView &matrix_left, const std::vector<double> &matrix_right);
+
+        [[nodiscard]] std::vector<double> get_result() const;
+        [[nodiscard]] double get_cond() const;
+        [[nodiscard]] int get_flag() const;
+        /**
+         * \brief refinement steps of the last solve, 0 after the double fallback
+         */
+        [[nodiscard]] int get_iterations() const;
+        /**
+         * \brief true if the last solve used the float factorization
+         */
+        [[nodiscard]] bool is_mixed() const;
+        /**
+         * \brief infinity norm of b - a * x of the last solve
+         */
+        [[nodiscard]] double get_residual() const;
+
+    private:
+        double cond_limit_;
+        int max_iterations_;
+        int size_;
+        int stride_;
+        double anorm_;
+        double cond_;
+        int flag_;
+        int iterations_;
+        bool mixed_;
+        bool fallback_ready_;
+        double residual_;
+        /* power of 2 the float factors are scaled by */
+        double scale_;
+        Matrix matrix_;
+        std::vector<float> factors_;
+        std::vector<int> pivot_;
+        std::vector<double> result_;
+        std::vector<double> residuals_;
+        std::vector<float> correction_;
+        Decomp decomp_;
+        Solve solve_;
+
+        void factorize();
+        double compute_residual(const std::vector<double> &matrix_right);
+        void solve_double(const std::vector<double> &matrix_right);
+    };
+}
+#endif
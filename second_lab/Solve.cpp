@@ -1,11 +1,14 @@
 #include "Solve.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 #include "Decomp.h"
+#include "../common/Statistics.h"
 
+template<class Real>
 int dimkashelk::details::solve(int n, int ndim,
-                               double *a, double b[],
+                               Real *a, Real b[],
                                int pivot[])
 
 /* Purpose :
@@ -29,9 +32,11 @@ int dimkashelk::details::solve(int n, int ndim,
 
 {
     /* --- begin function solve() --- */
+    NUMERICS_TIMER(SOLVE);
+    NUMERICS_COUNT(SOLVES, 1);
 
     int i, j, k, m;
-    double t;
+    Real t;
 
     if (n == 1) {
         /* trivial */
@@ -57,7 +62,95 @@ int dimkashelk::details::solve(int n, int ndim,
     return (0);
 } /* --- end function solve() --- */
 
+template int dimkashelk::details::solve<double>(int n, int ndim, double *a, double b[], int pivot[]);
+template int dimkashelk::details::solve<float>(int n, int ndim, float *a, float b[], int pivot[]);
+
+int dimkashelk::details::solve_many(int n, int ndim,
+                                    double *a, double b[],
+                                    int nrhs, int ldb,
+                                    int pivot[])
+
+/* Purpose :
+   -------
+   Solution of linear systems, a * X = B, for several right hand
+   sides at once. Do not use if decomp() has detected singularity.
+
+   Input..
+   -----
+   n     = order of matrix
+   ndim  = row dimension of a
+   a     = triangularized matrix obtained from decomp()
+   b     = right hand sides stored by rows, b[i * ldb + j] is the
+           i-th element of the j-th right hand side
+   nrhs  = number of right hand sides
+   ldb   = row dimension of b, ldb >= nrhs
+   pivot = pivot vector obtained from decomp()
+
+   Output..
+   ------
+   b = solution vectors, X, in the same layout
+
+   Notes ...
+   -----
+   Every row operation of solve() is applied to a whole row of b,
+   so the factorization is streamed through only once for all the
+   right hand sides and the inner loops run over contiguous memory.
+   Offsets are formed in std::size_t, n * ldb may exceed int.
+
+*/
+
+{
+    /* --- begin function solve_many() --- */
+    NUMERICS_TIMER(SOLVE);
+    NUMERICS_COUNT(SOLVES, nrhs);
+
+    int i, j, k, m, c;
+    double t;
+    double *pb, *pk; /* temporary pointers */
+
+    if (n == 1) {
+        /* trivial */
+        for (c = 0; c < nrhs; ++c) b[c] /= a[0];
+        return (0);
+    }
+
+    /* Forward elimination: apply multipliers. */
+    for (k = 0; k < n - 1; k++) {
+        m = pivot[k];
+        pk = b + static_cast<std::size_t>(k) * ldb;
+        if (m != k) {
+            pb = b + static_cast<std::size_t>(m) * ldb;
+            for (c = 0; c < nrhs; ++c) {
+                t = pb[c];
+                pb[c] = pk[c];
+                pk[c] = t;
+            }
+        }
+        for (i = k + 1; i < n; ++i) {
+            t = a[static_cast<std::size_t>(i) * ndim + k];
+            pb = b + static_cast<std::size_t>(i) * ldb;
+            for (c = 0; c < nrhs; ++c) pb[c] += t * pk[c];
+        }
+    }
+
+    /* Back substitution. */
+    for (k = n - 1; k >= 0; --k) {
+        pk = b + static_cast<std::size_t>(k) * ldb;
+        for (j = k + 1; j < n; ++j) {
+            t = a[static_cast<std::size_t>(k) * ndim + j];
+            pb = b + static_cast<std::size_t>(j) * ldb;
+            for (c = 0; c < nrhs; ++c) pk[c] -= t * pb[c];
+        }
+        t = a[static_cast<std::size_t>(k) * ndim + k];
+        for (c = 0; c < nrhs; ++c) pk[c] /= t;
+    }
+
+    return (0);
+} /* --- end function solve_many() --- */
+
 dimkashelk::Solve::Solve(): size_(0),
+                            count_(0),
+                            capacity_(0),
                             data_right_(nullptr),
                             cond_(0.0) {
 }
@@ -67,28 +160,85 @@ void dimkashelk::Solve::operator()(const std::vector<std::vector<double> > &matr
     if (matrix_left.size() != matrix_right.size()) {
         throw std::logic_error("Check data");
     }
-    free();
+    decomp_(matrix_left);
+    operator()(decomp_, matrix_right);
+}
+
+void dimkashelk::Solve::operator()(const ConstMatrixView &matrix_left, const std::vector<double> &matrix_right) {
+    if (matrix_left.get_rows() != static_cast<int>(matrix_right.size())) {
+        throw std::logic_error("Check data");
+    }
+    decomp_(matrix_left);
+    operator()(decomp_, matrix_right);
+}
+
+void dimkashelk::Solve::operator()(const Decomp &decomp, const std::vector<double> &matrix_right) {
+    if (decomp.size_ != static_cast<int>(matrix_right.size())) {
+        throw std::logic_error("Check data");
+    }
+    prepare(decomp, 1);
+    std::copy(matrix_right.begin(), matrix_right.end(), data_right_);
+    details::solve(size_, decomp.ndim_, decomp.data_, data_right_, decomp.pivot_);
+}
 
-    size_ = static_cast<int>(matrix_right.size());
-    data_right_ = new double[size_];
+void dimkashelk::Solve::operator()(const Decomp &decomp, const std::vector<std::vector<double> > &matrix_right) {
+    for (const auto &column: matrix_right) {
+        if (decomp.size_ != static_cast<int>(column.size())) {
+            throw std::logic_error("Check data");
+        }
+    }
+    prepare(decomp, static_cast<int>(matrix_right.size()));
+    for (int j = 0; j < count_; j++) {
+        for (int i = 0; i < size_; i++) {
+            data_right_[static_cast<std::size_t>(i) * count_ + j] = matrix_right[j][i];
+        }
+    }
+    details::solve_many(size_, decomp.ndim_, decomp.data_, data_right_, count_, count_, decomp.pivot_);
+}
+
+void dimkashelk::Solve::operator()(const Decomp &decomp, const ConstMatrixView &matrix_right) {
+    if (decomp.size_ != matrix_right.get_rows()) {
+        throw std::logic_error("Check data");
+    }
+    prepare(decomp, matrix_right.get_cols());
     for (int i = 0; i < size_; i++) {
-        data_right_[i] = matrix_right[i];
+        std::copy(matrix_right.get_row(i), matrix_right.get_row(i) + count_, data_right_ + static_cast<std::size_t>(i) * count_);
     }
-    Decomp dec;
-    dec(matrix_left);
-    cond_ = dec.cond_;
-    const int size = static_cast<int>(matrix_left.size());
-    details::solve(size, size, dec.data_, data_right_, dec.pivot_);
+    details::solve_many(size_, decomp.ndim_, decomp.data_, data_right_, count_, count_, decomp.pivot_);
 }
 
 std::vector<double> dimkashelk::Solve::get_result() const {
+    return get_result(0);
+}
+
+std::vector<double> dimkashelk::Solve::get_result(const int index) const {
+    if (index < 0 || (count_ != 0 && index >= count_)) {
+        throw std::out_of_range("Check index");
+    }
     std::vector<double> res(size_);
     for (int i = 0; i < size_; i++) {
-        res[i] = data_right_[i];
+        res[i] = data_right_[static_cast<std::size_t>(i) * count_ + index];
     }
     return res;
 }
 
+std::vector<std::vector<double> > dimkashelk::Solve::get_results() const {
+    std::vector<std::vector<double> > res;
+    res.reserve(count_);
+    for (int j = 0; j < count_; j++) {
+        res.push_back(get_result(j));
+    }
+    return res;
+}
+
+dimkashelk::ConstMatrixView dimkashelk::Solve::get_result_view() const {
+    return {data_right_, size_, count_, count_};
+}
+
+int dimkashelk::Solve::get_count() const {
+    return count_;
+}
+
 double dimkashelk::Solve::get_cond() const {
     return cond_;
 }
@@ -97,8 +247,28 @@ dimkashelk::Solve::~Solve() {
     free();
 }
 
-void dimkashelk::Solve::free() const {
+void dimkashelk::Solve::prepare(const Decomp &decomp, const int count) {
+    if (decomp.size_ == 0 || decomp.data_ == nullptr || count < 1) {
+        throw std::logic_error("Check data");
+    }
+    const std::size_t required = static_cast<std::size_t>(decomp.size_) * count;
+    if (required > capacity_) {
+        free();
+        data_right_ = new double[required];
+        NUMERICS_COUNT(BYTES_ALLOCATED, required * sizeof(double));
+        capacity_ = required;
+    }
+    size_ = decomp.size_;
+    count_ = count;
+    cond_ = decomp.cond_;
+}
+
+void dimkashelk::Solve::free() {
     if (data_right_ != nullptr) {
         delete[] data_right_;
+        data_right_ = nullptr;
     }
+    size_ = 0;
+    count_ = 0;
+    capacity_ = 0;
 }
@@ -1,15 +1,26 @@
 #ifndef SOLVE_H
 #define SOLVE_H
+#include <cstddef>
 #include <vector>
 
+#include "Decomp.h"
+#include "Matrix.h"
+
 namespace dimkashelk {
     namespace details {
+        /**
+         * \brief instantiated for double and float factors
+         */
+        template<class Real>
         int solve(int n, int ndim,
-                  double *a, double b[],
+                  Real *a, Real b[],
                   int pivot[]);
-    }
 
-    class Decomp;
+        int solve_many(int n, int ndim,
+                       double *a, double b[],
+                       int nrhs, int ldb,
+                       int pivot[]);
+    }
 
     class Solve {
         friend class Decomp;
@@ -17,19 +28,61 @@ namespace dimkashelk {
     public:
         Solve();
 
+        Solve(const Solve &) = delete;
+
+        Solve &operator=(const Solve &) = delete;
+
+        /**
+         * \brief factorize and solve, the factorization of the previous call gives its storage
+         */
         void operator()(const std::vector<std::vector<double> > &matrix_left, const std::vector<double> &matrix_right);
 
+        void operator()(const ConstMatrixView &matrix_left, const std::vector<double> &matrix_right);
+
+        /**
+         * \brief solve with an already factorized matrix, only O(n^2) work per call
+         * \param decomp factorization obtained from Decomp::operator()
+         * \param matrix_right right hand side
+         */
+        void operator()(const Decomp &decomp, const std::vector<double> &matrix_right);
+
+        /**
+         * \brief solve for many right hand sides in one pass over the factorization
+         * \param decomp factorization obtained from Decomp::operator()
+         * \param matrix_right list of right hand sides, each of them of size n
+         */
+        void operator()(const Decomp &decomp, const std::vector<std::vector<double> > &matrix_right);
+
+        /**
+         * \brief solve for many right hand sides in one pass over the factorization
+         * \param decomp factorization obtained from Decomp::operator()
+         * \param matrix_right n x count matrix, every column is a right hand side
+         */
+        void operator()(const Decomp &decomp, const ConstMatrixView &matrix_right);
+
         [[nodiscard]] std::vector<double> get_result() const;
+        [[nodiscard]] std::vector<double> get_result(int index) const;
+        [[nodiscard]] std::vector<std::vector<double> > get_results() const;
+        /**
+         * \brief n x count view of the solutions, every column is a solution,
+         * valid until the next call of operator()
+         */
+        [[nodiscard]] ConstMatrixView get_result_view() const;
+        [[nodiscard]] int get_count() const;
         [[nodiscard]] double get_cond() const;
 
         ~Solve();
 
     private:
         int size_;
+        int count_;
+        std::size_t capacity_;
         double *data_right_;
         double cond_;
+        Decomp decomp_;
 
-        void free() const;
+        void prepare(const Decomp &decomp, int count);
+        void free();
     };
 }
 
@@ -0,0 +1,363 @@
+#include "SparseLU.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#include "SparseOrdering.h"
+#include "../common/Statistics.h"
+#include "../common/Workspace.h"
+
+namespace {
+    constexpr double EPSILON = 2.2e-16;
+}
+
+dimkashelk::SparseLU::SparseLU(const Ordering ordering, const double pivot_tolerance): ordering_(ordering),
+    pivot_tolerance_(pivot_tolerance),
+    size_(0),
+    anorm_(0.0),
+    cond_(0.0),
+    flag_(0),
+    factorized_(false) {
+    if (pivot_tolerance <= 0.0 || pivot_tolerance > 1.0) {
+        throw std::logic_error("Check pivot tolerance");
+    }
+}
+
+bool dimkashelk::SparseLU::same_pattern(const SparseMatrix &matrix) const {
+    return matrix.get_size() == size_ && matrix.get_row_ptr() == row_ptr_ && matrix.get_columns() == columns_;
+}
+
+void dimkashelk::SparseLU::analyze(const SparseMatrix &matrix) {
+    if (matrix.get_size() == 0) {
+        throw std::logic_error("Check matrix");
+    }
+    const int n = matrix.get_size();
+    size_ = n;
+    row_ptr_ = matrix.get_row_ptr();
+    columns_ = matrix.get_columns();
+    factorized_ = false;
+
+    /* transpose the pattern, source_[p] is the CSR position of the p-th entry by columns */
+    col_ptr_.assign(n + 1, 0);
+    for (const int column: columns_) col_ptr_[column + 1]++;
+    std::partial_sum(col_ptr_.begin(), col_ptr_.end(), col_ptr_.begin());
+    std::vector<int> next(col_ptr_.begin(), col_ptr_.end() - 1);
+    rows_.resize(columns_.size());
+    source_.resize(columns_.size());
+    for (int i = 0; i < n; i++) {
+        for (int p = row_ptr_[i]; p < row_ptr_[i + 1]; p++) {
+            const int q = next[columns_[p]]++;
+            rows_[q] = i;
+            source_[q] = p;
+        }
+    }
+
+    q_.resize(n);
+    if (ordering_ == Ordering::NESTED_DISSECTION) {
+        std::vector<int> ptr, index;
+        details::symmetric_pattern(n, row_ptr_.data(), columns_.data(), ptr, index);
+        details::nested_dissection(n, ptr.data(), index.data(), q_.data());
+    } else {
+        std::iota(q_.begin(), q_.end(), 0);
+    }
+}
+
+void dimkashelk::SparseLU::gather(const SparseMatrix &matrix) {
+    const std::vector<double> &values = matrix.get_values();
+    col_values_.resize(source_.size());
+    for (std::size_t p = 0; p < source_.size(); p++) {
+        col_values_[p] = values[source_[p]];
+    }
+    anorm_ = 0.0;
+    for (int j = 0; j < size_; j++) {
+        double sum = 0.0;
+        for (int p = col_ptr_[j]; p < col_ptr_[j + 1]; p++) sum += std::fabs(col_values_[p]);
+        anorm_ = std::max(anorm_, sum);
+    }
+}
+
+void dimkashelk::SparseLU::factorize(const SparseMatrix &matrix) {
+    if (!same_pattern(matrix)) {
+        analyze(matrix);
+    }
+    NUMERICS_TIMER(FACTOR);
+    NUMERICS_COUNT(FACTORIZATIONS, 1);
+    gather(matrix);
+    const int n = size_;
+    flag_ = 0;
+    factorized_ = false;
+    pinv_.assign(n, -1);
+    l_ptr_.assign(n + 1, 0);
+    u_ptr_.assign(n + 1, 0);
+    l_index_.clear();
+    l_values_.clear();
+    u_index_.clear();
+    u_values_.clear();
+    l_index_.reserve(4 * columns_.size());
+    l_values_.reserve(4 * columns_.size());
+    u_index_.reserve(4 * columns_.size());
+    u_values_.reserve(4 * columns_.size());
+
+    /* x = L \ a(:, q[k]) on the reach of the column in the graph of L,
+       the rows of L are kept as rows of a until all pivots are known */
+    Workspace &workspace = thread_workspace();
+    Workspace::Scope scope(workspace);
+    double *x = workspace.allocate<double>(n);
+    int *xi = workspace.allocate<int>(n);
+    int *pstack = workspace.allocate<int>(n);
+    int *mark = workspace.allocate<int>(n);
+    std::fill(x, x + n, 0.0);
+    std::fill(mark, mark + n, -1);
+    for (int k = 0; k < n; k++) {
+        const int col = q_[k];
+        int top = n;
+        for (int p = col_ptr_[col]; p < col_ptr_[col + 1]; p++) {
+            int head = 0;
+            if (mark[rows_[p]] == k) continue;
+            xi[0] = rows_[p];
+            /* depth first search from the row, finished vertices are put on top of xi */
+            while (head >= 0) {
+                const int j = xi[head];
+                const int jnew = pinv_[j];
+                if (mark[j] != k) {
+                    mark[j] = k;
+                    pstack[head] = jnew < 0 ? 0 : l_ptr_[jnew] + 1;
+                }
+                bool done = true;
+                const int end = jnew < 0 ? 0 : l_ptr_[jnew + 1];
+                for (int q = pstack[head]; q < end; q++) {
+                    const int i = l_index_[q];
+                    if (mark[i] == k) continue;
+                    pstack[head] = q + 1;
+                    xi[++head] = i;
+                    done = false;
+                    break;
+                }
+                if (done) {
+                    head--;
+                    xi[--top] = j;
+                }
+            }
+        }
+        for (int p = col_ptr_[col]; p < col_ptr_[col + 1]; p++) x[rows_[p]] = col_values_[p];
+        for (int px = top; px < n; px++) {
+            const int j = xi[px];
+            const int jnew = pinv_[j];
+            if (jnew < 0) continue;
+            const double t = x[j];
+            for (int q = l_ptr_[jnew] + 1; q < l_ptr_[jnew + 1]; q++) {
+                x[l_index_[q]] -= l_values_[q] * t;
+            }
+        }
+
+        /* largest candidate, the diagonal is preferred within pivot_tolerance_ */
+        int ipiv = -1;
+        double largest = -1.0;
+        for (int px = top; px < n; px++) {
+            const int i = xi[px];
+            if (pinv_[i] < 0) {
+                const double t = std::fabs(x[i]);
+                if (t > largest) {
+                    largest = t;
+                    ipiv = i;
+                }
+            } else {
+                u_index_.push_back(pinv_[i]);
+                u_values_.push_back(x[i]);
+            }
+        }
+        if (ipiv < 0 || largest <= anorm_ * EPSILON) {
+            /* Singular or nearly singular */
+            for (int px = top; px < n; px++) x[xi[px]] = 0.0;
+            cond_ = 1.0e+32;
+            flag_ = 3;
+            return;
+        }
+        if (pinv_[col] < 0 && mark[col] == k && std::fabs(x[col]) >= pivot_tolerance_ * largest) {
+            ipiv = col;
+        }
+        if (ipiv != col) {
+            NUMERICS_COUNT(PIVOT_SWAPS, 1);
+        }
+        const double pivot = x[ipiv];
+        u_index_.push_back(k);
+        u_values_.push_back(pivot);
+        pinv_[ipiv] = k;
+        l_index_.push_back(ipiv);
+        l_values_.push_back(1.0);
+        for (int px = top; px < n; px++) {
+            const int i = xi[px];
+            if (pinv_[i] < 0) {
+                l_index_.push_back(i);
+                l_values_.push_back(x[i] / pivot);
+            }
+            x[i] = 0.0;
+        }
+        l_ptr_[k + 1] = static_cast<int>(l_index_.size());
+        u_ptr_[k + 1] = static_cast<int>(u_index_.size());
+    }
+
+    /* rows of L as steps, U columns sorted so that refactorize() eliminates in order */
+    for (int &i: l_index_) i = pinv_[i];
+    std::vector<std::pair<int, double> > column;
+    for (int k = 0; k < n; k++) {
+        column.clear();
+        for (int p = u_ptr_[k]; p < u_ptr_[k + 1]; p++) column.emplace_back(u_index_[p], u_values_[p]);
+        std::sort(column.begin(), column.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+        for (int p = u_ptr_[k]; p < u_ptr_[k + 1]; p++) {
+            u_index_[p] = column[p - u_ptr_[k]].first;
+            u_values_[p] = column[p - u_ptr_[k]].second;
+        }
+    }
+    factorized_ = true;
+    estimate_cond();
+}
+
+void dimkashelk::SparseLU::refactorize(const SparseMatrix &matrix) {
+    if (!factorized_ || !same_pattern(matrix)) {
+        throw std::logic_error("Check pattern of matrix, refactorize() needs the pattern of factorize()");
+    }
+    NUMERICS_TIMER(FACTOR);
+    NUMERICS_COUNT(FACTORIZATIONS, 1);
+    gather(matrix);
+    const int n = size_;
+    flag_ = 0;
+    std::vector<double> &x = work_;
+    x.assign(n, 0.0);
+    for (int k = 0; k < n; k++) {
+        const int col = q_[k];
+        for (int p = col_ptr_[col]; p < col_ptr_[col + 1]; p++) x[pinv_[rows_[p]]] = col_values_[p];
+        /* the entries of U(:, k) in increasing order are a topological order of the triangular solve */
+        const int diagonal = u_ptr_[k + 1] - 1;
+        for (int p = u_ptr_[k]; p < diagonal; p++) {
+            const int j = u_index_[p];
+            const double t = x[j];
+            u_values_[p] = t;
+            x[j] = 0.0;
+            for (int q = l_ptr_[j] + 1; q < l_ptr_[j + 1]; q++) {
+                x[l_index_[q]] -= l_values_[q] * t;
+            }
+        }
+        const double pivot = x[k];
+        x[k] = 0.0;
+        if (std::fabs(pivot) <= anorm_ * EPSILON) {
+            for (int q = l_ptr_[k] + 1; q < l_ptr_[k + 1]; q++) x[l_index_[q]] = 0.0;
+            cond_ = 1.0e+32;
+            flag_ = 3;
+            factorized_ = false;
+            return;
+        }
+        u_values_[diagonal] = pivot;
+        for (int q = l_ptr_[k] + 1; q < l_ptr_[k + 1]; q++) {
+            l_values_[q] = x[l_index_[q]] / pivot;
+            x[l_index_[q]] = 0.0;
+        }
+    }
+    estimate_cond();
+}
+
+void dimkashelk::SparseLU::estimate_cond() {
+    /* cond = (1-norm of a)*(an estimate of 1-norm of a-inverse) as in decomp(),
+       U-transpose * w = e with e chosen for growth, L-transpose * v = w,
+       y = p-transpose * v, then a * z = y */
+    const int n = size_;
+    Workspace &workspace = thread_workspace();
+    Workspace::Scope scope(workspace);
+    double *w = workspace.allocate<double>(n);
+    for (int k = 0; k < n; k++) {
+        double t = 0.0;
+        const int diagonal = u_ptr_[k + 1] - 1;
+        for (int p = u_ptr_[k]; p < diagonal; p++) t += u_values_[p] * w[u_index_[p]];
+        const double ek = t < 0.0 ? -1.0 : 1.0;
+        w[k] = -(ek + t) / u_values_[diagonal];
+    }
+    for (int k = n - 1; k >= 0; k--) {
+        double t = w[k];
+        for (int p = l_ptr_[k] + 1; p < l_ptr_[k + 1]; p++) t -= l_values_[p] * w[l_index_[p]];
+        w[k] = t;
+    }
+    double *y = workspace.allocate<double>(n);
+    double ynorm = 0.0;
+    for (int i = 0; i < n; i++) {
+        y[i] = w[pinv_[i]];
+        ynorm += std::fabs(y[i]);
+    }
+    solve(y);
+    double znorm = 0.0;
+    for (int i = 0; i < n; i++) znorm += std::fabs(y[i]);
+    cond_ = std::max(1.0, anorm_ * znorm / ynorm);
+    if (cond_ + 1.0 == cond_) flag_ = 3;
+}
+
+void dimkashelk::SparseLU::solve(double b[]) {
+    /* x = q * U^-1 * L^-1 * p * b */
+    const int n = size_;
+    std::vector<double> &t = work_;
+    t.resize(n);
+    for (int i = 0; i < n; i++) t[pinv_[i]] = b[i];
+    for (int k = 0; k < n; k++) {
+        const double s = t[k];
+        if (s == 0.0) continue;
+        for (int p = l_ptr_[k] + 1; p < l_ptr_[k + 1]; p++) t[l_index_[p]] -= l_values_[p] * s;
+    }
+    for (int k = n - 1; k >= 0; k--) {
+        const int diagonal = u_ptr_[k + 1] - 1;
+        t[k] /= u_values_[diagonal];
+        const double s = t[k];
+        if (s == 0.0) continue;
+        for (int p = u_ptr_[k]; p < diagonal; p++) t[u_index_[p]] -= u_values_[p] * s;
+    }
+    for (int k = 0; k < n; k++) b[q_[k]] = t[k];
+}
+
+void dimkashelk::SparseLU::operator()(const SparseMatrix &matrix) {
+    factorize(matrix);
+}
+
+void dimkashelk::SparseLU::operator()(const std::vector<double> &matrix_right) {
+    if (size_ == 0 || static_cast<int>(matrix_right.size()) != size_) {
+        throw std::logic_error("Check data");
+    }
+    if (!factorized_ || flag_ != 0) {
+        throw std::logic_error("Check matrix, it is singular");
+    }
+    NUMERICS_TIMER(SOLVE);
+    NUMERICS_COUNT(SOLVES, 1);
+    result_ = matrix_right;
+    solve(result_.data());
+}
+
+void dimkashelk::SparseLU::operator()(const SparseMatrix &matrix_left, const std::vector<double> &matrix_right) {
+    if (matrix_left.get_size() != static_cast<int>(matrix_right.size())) {
+        throw std::logic_error("Check data");
+    }
+    factorize(matrix_left);
+    operator()(matrix_right);
+}
+
+std::vector<double> dimkashelk::SparseLU::get_result() const {
+    return result_;
+}
+
+double dimkashelk::SparseLU::get_cond() const {
+    return cond_;
+}
+
+int dimkashelk::SparseLU::get_flag() const {
+    return flag_;
+}
+
+int dimkashelk::SparseLU::get_size() const {
+    return size_;
+}
+
+long dimkashelk::SparseLU::get_factor_nonzeros() const {
+    return static_cast<long>(l_index_.size() + u_index_.size()) - size_;
+}
+
+const std::vector<int> &dimkashelk::SparseLU::get_ordering() const {
+    return q_;
+}
@@ -0,0 +1,100 @@
+#ifndef SPARSE_LU_H
+#define SPARSE_LU_H
+#include <vector>
+
+#include "SparseMatrix.h"
+
+namespace dimkashelk {
+    /**
+     * \brief sparse LU factorization p * a * q = L * U with a fill-reducing ordering q and
+     * threshold partial pivoting p, memory proportional to the nonzeros of the factors.
+     *
+     * analyze() computes the ordering from the pattern, factorize() the factors with pivoting
+     * (left-looking, Gilbert-Peierls), refactorize() recomputes them for new values in the same
+     * pattern with the pivots and the pattern of the last factorize()
+     */
+    class SparseLU {
+    public:
+        enum class Ordering {
+            NATURAL,
+            NESTED_DISSECTION
+        };
+
+        /**
+         * \param ordering fill-reducing column ordering, applied symmetrically
+         * \param pivot_tolerance the diagonal is kept as pivot if it is at least this part of the largest candidate
+         */
+        explicit SparseLU(Ordering ordering = Ordering::NESTED_DISSECTION, double pivot_tolerance = 0.1);
+
+        /**
+         * \brief symbolic analysis, only the pattern of the matrix is used
+         */
+        void analyze(const SparseMatrix &matrix);
+
+        /**
+         * \brief numeric factorization with pivoting, analyzes the matrix if its pattern is new
+         */
+        void factorize(const SparseMatrix &matrix);
+
+        /**
+         * \brief numeric factorization with the pattern and pivots of the last factorize(),
+         * flag 3 if a pivot became too small, factorize() then chooses new pivots
+         */
+        void refactorize(const SparseMatrix &matrix);
+
+        void operator()(const SparseMatrix &matrix);
+
+        /**
+         * \brief solve with the last factorization
+         */
+        void operator()(const std::vector<double> &matrix_right);
+
+        void operator()(const SparseMatrix &matrix_left, const std::vector<double> &matrix_right);
+
+        [[nodiscard]] std::vector<double> get_result() const;
+        [[nodiscard]] double get_cond() const;
+        [[nodiscard]] int get_flag() const;
+        [[nodiscard]] int get_size() const;
+        /**
+         * \brief nonzeros of L and U, the fill is this minus the nonzeros of the matrix
+         */
+        [[nodiscard]] long get_factor_nonzeros() const;
+        [[nodiscard]] const std::vector<int> &get_ordering() const;
+
+    private:
+        Ordering ordering_;
+        double pivot_tolerance_;
+        int size_;
+        double anorm_;
+        double cond_;
+        int flag_;
+        bool factorized_;
+        /* pattern of the analyzed matrix */
+        std::vector<int> row_ptr_;
+        std::vector<int> columns_;
+        /* the matrix by columns, values gathered through source_ */
+        std::vector<int> col_ptr_;
+        std::vector<int> rows_;
+        std::vector<int> source_;
+        std::vector<double> col_values_;
+        /* q[k] is the k-th column, pinv[i] the step row i is pivot in */
+        std::vector<int> q_;
+        std::vector<int> pinv_;
+        /* L by columns with the unit diagonal first, U by columns with the diagonal last,
+           row indices are steps */
+        std::vector<int> l_ptr_;
+        std::vector<int> l_index_;
+        std::vector<double> l_values_;
+        std::vector<int> u_ptr_;
+        std::vector<int> u_index_;
+        std::vector<double> u_values_;
+        std::vector<double> work_;
+        std::vector<double> result_;
+
+        bool same_pattern(const SparseMatrix &matrix) const;
+        void gather(const SparseMatrix &matrix);
+        void estimate_cond();
+        void solve(double b[]);
+    };
+}
+#endif
@@ -0,0 +1,118 @@
+#include "SparseMatrix.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+dimkashelk::SparseMatrix::SparseMatrix(): size_(0),
+                                          row_ptr_(1, 0) {
+}
+
+dimkashelk::SparseMatrix::SparseMatrix(const int size, std::vector<int> row_ptr, std::vector<int> columns,
+                                       std::vector<double> values): size_(size),
+                                                                    row_ptr_(std::move(row_ptr)),
+                                                                    columns_(std::move(columns)),
+                                                                    values_(std::move(values)) {
+    if (size < 1 || static_cast<int>(row_ptr_.size()) != size + 1 || row_ptr_[0] != 0 ||
+        columns_.size() != values_.size() || row_ptr_[size] != static_cast<int>(columns_.size())) {
+        throw std::logic_error("Check size of sparse matrix");
+    }
+    for (int i = 0; i < size; i++) {
+        if (row_ptr_[i] > row_ptr_[i + 1]) {
+            throw std::logic_error("Check row pointers of sparse matrix");
+        }
+    }
+    for (const int column: columns_) {
+        if (column < 0 || column >= size) {
+            throw std::logic_error("Check columns of sparse matrix");
+        }
+    }
+    normalize();
+}
+
+dimkashelk::SparseMatrix dimkashelk::SparseMatrix::from_triplets(const int size, const std::vector<int> &rows,
+                                                                 const std::vector<int> &columns,
+                                                                 const std::vector<double> &values) {
+    if (size < 1 || rows.size() != columns.size() || rows.size() != values.size()) {
+        throw std::logic_error("Check triplets");
+    }
+    std::vector<int> row_ptr(size + 1, 0);
+    for (const int row: rows) {
+        if (row < 0 || row >= size) {
+            throw std::logic_error("Check rows of triplets");
+        }
+        row_ptr[row + 1]++;
+    }
+    std::partial_sum(row_ptr.begin(), row_ptr.end(), row_ptr.begin());
+    std::vector<int> next(row_ptr.begin(), row_ptr.end() - 1);
+    std::vector<int> csr_columns(rows.size());
+    std::vector<double> csr_values(rows.size());
+    for (std::size_t p = 0; p < rows.size(); p++) {
+        const int q = next[rows[p]]++;
+        csr_columns[q] = columns[p];
+        csr_values[q] = values[p];
+    }
+    return {size, std::move(row_ptr), std::move(csr_columns), std::move(csr_values)};
+}
+
+dimkashelk::SparseMatrix::SparseMatrix(const std::vector<std::vector<double> > &matrix): SparseMatrix() {
+    if (matrix.empty()) {
+        throw std::logic_error("Check matrix");
+    }
+    size_ = static_cast<int>(matrix.size());
+    row_ptr_.assign(1, 0);
+    for (const auto &row: matrix) {
+        if (row.size() != matrix.size()) {
+            throw std::logic_error("Check size of matrix");
+        }
+        for (int j = 0; j < size_; j++) {
+            if (row[j] != 0.0) {
+                columns_.push_back(j);
+                values_.push_back(row[j]);
+            }
+        }
+        row_ptr_.push_back(static_cast<int>(columns_.size()));
+    }
+}
+
+void dimkashelk::SparseMatrix::normalize() {
+    /* sort the columns of every row and sum duplicates in place */
+    std::vector<std::pair<int, double> > row;
+    int nz = 0;
+    for (int i = 0; i < size_; i++) {
+        row.clear();
+        for (int p = row_ptr_[i]; p < row_ptr_[i + 1]; p++) {
+            row.emplace_back(columns_[p], values_[p]);
+        }
+        std::sort(row.begin(), row.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+        row_ptr_[i] = nz;
+        for (std::size_t p = 0; p < row.size(); p++) {
+            if (p > 0 && row[p].first == row[p - 1].first) {
+                values_[nz - 1] += row[p].second;
+                continue;
+            }
+            columns_[nz] = row[p].first;
+            values_[nz] = row[p].second;
+            nz++;
+        }
+    }
+    row_ptr_[size_] = nz;
+    columns_.resize(nz);
+    values_.resize(nz);
+}
+
+std::vector<double> dimkashelk::SparseMatrix::multiply(const std::vector<double> &x) const {
+    if (static_cast<int>(x.size()) != size_) {
+        throw std::logic_error("Check size of vector");
+    }
+    std::vector<double> y(size_);
+    for (int i = 0; i < size_; i++) {
+        double sum = 0.0;
+        for (int p = row_ptr_[i]; p < row_ptr_[i + 1]; p++) {
+            sum += values_[p] * x[columns_[p]];
+        }
+        y[i] = sum;
+    }
+    return y;
+}
@@ -0,0 +1,53 @@
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+#include <vector>
+
+namespace dimkashelk {
+    /**
+     * \brief square sparse matrix in compressed sparse row (CSR) storage, the nonzeros of row i are
+     * values[row_ptr[i] ... row_ptr[i + 1] - 1] in the columns columns[row_ptr[i] ... row_ptr[i + 1] - 1],
+     * sorted by column without duplicates
+     */
+    class SparseMatrix {
+    public:
+        SparseMatrix();
+
+        /**
+         * \brief matrix from CSR arrays, the columns of every row are sorted and duplicates are summed
+         */
+        SparseMatrix(int size, std::vector<int> row_ptr, std::vector<int> columns, std::vector<double> values);
+
+        /**
+         * \brief matrix from coordinate (COO) triplets, duplicates are summed
+         */
+        static SparseMatrix from_triplets(int size, const std::vector<int> &rows, const std::vector<int> &columns,
+                                          const std::vector<double> &values);
+
+        /**
+         * \brief nonzeros of a dense matrix
+         */
+        explicit SparseMatrix(const std::vector<std::vector<double> > &matrix);
+
+        [[nodiscard]] std::vector<double> multiply(const std::vector<double> &x) const;
+
+        /**
+         * \brief values of the nonzeros in CSR order, the pattern stays fixed
+         */
+        [[nodiscard]] std::vector<double> &get_values() { return values_; }
+
+        [[nodiscard]] const std::vector<double> &get_values() const { return values_; }
+        [[nodiscard]] const std::vector<int> &get_row_ptr() const { return row_ptr_; }
+        [[nodiscard]] const std::vector<int> &get_columns() const { return columns_; }
+        [[nodiscard]] int get_size() const { return size_; }
+        [[nodiscard]] int get_nonzeros() const { return static_cast<int>(values_.size()); }
+
+    private:
+        int size_;
+        std::vector<int> row_ptr_;
+        std::vector<int> columns_;
+        std::vector<double> values_;
+
+        void normalize();
+    };
+}
+#endif
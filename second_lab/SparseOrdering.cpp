@@ -0,0 +1,199 @@
+#include "SparseOrdering.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+    /* breadth first search state shared by all subgraphs */
+    struct Search {
+        const int *ptr;
+        const int *index;
+        std::vector<int> region;
+        std::vector<int> visit;
+        std::vector<int> level;
+        std::vector<int> queue;
+        int stamp = 0;
+
+        /* levels of the vertices of region id reachable from root, the vertices in queue[0 ... count - 1] */
+        int bfs(const int root, const int id, int &depth) {
+            stamp++;
+            int head = 0;
+            int tail = 0;
+            queue[tail++] = root;
+            visit[root] = stamp;
+            level[root] = 0;
+            depth = 0;
+            while (head < tail) {
+                const int v = queue[head++];
+                for (int p = ptr[v]; p < ptr[v + 1]; p++) {
+                    const int w = index[p];
+                    if (region[w] != id || visit[w] == stamp) continue;
+                    visit[w] = stamp;
+                    level[w] = level[v] + 1;
+                    depth = std::max(depth, level[w]);
+                    queue[tail++] = w;
+                }
+            }
+            return tail;
+        }
+
+        int degree(const int v, const int id) const {
+            int d = 0;
+            for (int p = ptr[v]; p < ptr[v + 1]; p++) {
+                if (region[index[p]] == id) d++;
+            }
+            return d;
+        }
+
+        /* root of a long search, the vertex of least degree in the last level, repeated while the depth grows */
+        int peripheral(int root, const int id, int &count, int &depth) {
+            count = bfs(root, id, depth);
+            for (int iteration = 0; iteration < 8; iteration++) {
+                int best = -1;
+                for (int k = count - 1; k >= 0 && level[queue[k]] == depth; k--) {
+                    if (best < 0 || degree(queue[k], id) < degree(best, id)) best = queue[k];
+                }
+                int next_depth = 0;
+                const int next_count = bfs(best, id, next_depth);
+                if (next_depth <= depth) {
+                    count = bfs(root, id, depth);
+                    return root;
+                }
+                root = best;
+                count = next_count;
+                depth = next_depth;
+            }
+            return root;
+        }
+    };
+}
+
+void dimkashelk::details::symmetric_pattern(const int n, const int row_ptr[], const int columns[],
+                                            std::vector<int> &ptr, std::vector<int> &index) {
+    std::vector<int> count(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        for (int p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+            if (columns[p] == i) continue;
+            count[i + 1]++;
+            count[columns[p] + 1]++;
+        }
+    }
+    std::partial_sum(count.begin(), count.end(), count.begin());
+    std::vector<int> next(count.begin(), count.end() - 1);
+    std::vector<int> all(count[n]);
+    for (int i = 0; i < n; i++) {
+        for (int p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+            const int j = columns[p];
+            if (j == i) continue;
+            all[next[i]++] = j;
+            all[next[j]++] = i;
+        }
+    }
+    /* remove the duplicates of entries present in both a and a^T */
+    ptr.assign(n + 1, 0);
+    index.clear();
+    index.reserve(all.size());
+    for (int i = 0; i < n; i++) {
+        std::sort(all.begin() + count[i], all.begin() + count[i + 1]);
+        for (int p = count[i]; p < count[i + 1]; p++) {
+            if (p > count[i] && all[p] == all[p - 1]) continue;
+            index.push_back(all[p]);
+        }
+        ptr[i + 1] = static_cast<int>(index.size());
+    }
+}
+
+void dimkashelk::details::nested_dissection(const int n, const int ptr[], const int index[], int perm[]) {
+    Search search;
+    search.ptr = ptr;
+    search.index = index;
+    search.region.assign(n, 0);
+    search.visit.assign(n, 0);
+    search.level.assign(n, 0);
+    search.queue.resize(n);
+    std::iota(perm, perm + n, 0);
+
+    /* every item is a range of perm that is reordered in place, the separator goes to its end */
+    struct Item {
+        int first;
+        int count;
+        bool connected;
+    };
+    std::vector<Item> items{{0, n, false}};
+    std::vector<int> buffer(n);
+    int id = 0;
+    while (!items.empty()) {
+        const Item item = items.back();
+        items.pop_back();
+        if (item.count <= 1) continue;
+        int *range = perm + item.first;
+        id++;
+        for (int k = 0; k < item.count; k++) search.region[range[k]] = id;
+
+        if (!item.connected) {
+            /* split into connected components */
+            int placed = 0;
+            for (int k = 0; k < item.count; k++) {
+                const int v = range[k];
+                if (search.region[v] != id) continue;
+                int depth = 0;
+                const int count = search.bfs(v, id, depth);
+                for (int q = 0; q < count; q++) {
+                    buffer[placed + q] = search.queue[q];
+                    search.region[search.queue[q]] = -id;
+                }
+                items.push_back({item.first + placed, count, true});
+                placed += count;
+            }
+            std::copy(buffer.begin(), buffer.begin() + item.count, range);
+            continue;
+        }
+
+        int count = 0;
+        int depth = 0;
+        search.peripheral(range[0], id, count, depth);
+        if (item.count <= DISSECTION_LEAF || depth < 2) {
+            /* reverse Cuthill-McKee order of a leaf */
+            std::reverse_copy(search.queue.begin(), search.queue.begin() + count, range);
+            continue;
+        }
+
+        /* the level that halves the subgraph */
+        std::vector<int> sizes(depth + 1, 0);
+        for (int k = 0; k < count; k++) sizes[search.level[search.queue[k]]]++;
+        int middle = 0;
+        for (int total = 0; middle < depth && total + sizes[middle] < count / 2; middle++) {
+            total += sizes[middle];
+        }
+        middle = std::max(1, std::min(middle, depth - 1));
+
+        /* separator: vertices of the middle level next to the level beyond it */
+        int first = 0;
+        int last = count;
+        int separator = count;
+        const std::vector<int> &level = search.level;
+        for (int k = 0; k < count; k++) {
+            const int v = search.queue[k];
+            bool boundary = false;
+            if (level[v] == middle) {
+                for (int p = ptr[v]; p < ptr[v + 1] && !boundary; p++) {
+                    const int w = index[p];
+                    boundary = search.region[w] == id && level[w] == middle + 1;
+                }
+            }
+            if (boundary) {
+                buffer[--separator] = v;
+            } else if (level[v] <= middle) {
+                buffer[first++] = v;
+            }
+        }
+        last = separator;
+        for (int k = count - 1; k >= 0; k--) {
+            const int v = search.queue[k];
+            if (level[v] > middle) buffer[--last] = v;
+        }
+        std::copy(buffer.begin(), buffer.begin() + count, range);
+        items.push_back({item.first, first, false});
+        items.push_back({item.first + first, separator - first, false});
+    }
+}
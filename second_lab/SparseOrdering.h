@@ -0,0 +1,32 @@
+#ifndef SPARSE_ORDERING_H
+#define SPARSE_ORDERING_H
+#include <vector>
+
+namespace dimkashelk {
+    namespace details {
+        /**
+         * \brief subgraphs up to this size are not dissected further
+         */
+        constexpr int DISSECTION_LEAF = 64;
+
+        /**
+         * \brief pattern of a + a^T without the diagonal, adjacency of vertex i is index[ptr[i] ... ptr[i + 1] - 1]
+         */
+        void symmetric_pattern(int n, const int row_ptr[], const int columns[],
+                               std::vector<int> &ptr, std::vector<int> &index);
+
+        /**
+         * \brief fill-reducing nested dissection ordering of a symmetric graph.
+         *
+         * Every connected subgraph larger than DISSECTION_LEAF is split by a level of a breadth first
+         * search from a pseudo-peripheral vertex, the level that halves the subgraph, trimmed to the
+         * vertices adjacent to the next level. Both halves are ordered before the separator, leaves are
+         * ordered by reverse Cuthill-McKee. O(nnz log n) time, O(n + nnz) memory.
+         * \param n number of vertices
+         * \param ptr, index adjacency from symmetric_pattern()
+         * \param perm perm[k] is the vertex eliminated k-th
+         */
+        void nested_dissection(int n, const int ptr[], const int index[], int perm[]);
+    }
+}
+#endif
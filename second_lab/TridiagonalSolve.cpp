@@ -0,0 +1,125 @@
+#include "TridiagonalSolve.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "../common/Statistics.h"
+#include "../common/Workspace.h"
+
+dimkashelk::TridiagonalSolve::TridiagonalSolve(): size_(0),
+                                                  cond_(0.0),
+                                                  flag_(0) {
+}
+
+void dimkashelk::TridiagonalSolve::operator()(const std::vector<double> &lower, const std::vector<double> &diag,
+                                              const std::vector<double> &upper) {
+    const int n = static_cast<int>(diag.size());
+    if (n == 0 || static_cast<int>(lower.size()) != n - 1 || static_cast<int>(upper.size()) != n - 1) {
+        throw std::logic_error("Check size of matrix");
+    }
+    NUMERICS_TIMER(FACTOR);
+    NUMERICS_COUNT(FACTORIZATIONS, 1);
+    const double EPSILON = 2.2e-16;
+    size_ = n;
+    flag_ = 0;
+    multipliers_.resize(n);
+    pivots_.resize(n);
+    upper_ = upper;
+
+    /* 1-norm, column j holds upper[j - 1], diag[j] and lower[j] */
+    double anorm = 0.0;
+    for (int j = 0; j < n; j++) {
+        double sum = std::fabs(diag[j]);
+        if (j > 0) sum += std::fabs(upper[j - 1]);
+        if (j < n - 1) sum += std::fabs(lower[j]);
+        anorm = std::max(anorm, sum);
+    }
+
+    /* elimination, multipliers_[i] = L(i, i - 1), pivots_ is the diagonal of U */
+    multipliers_[0] = 0.0;
+    pivots_[0] = diag[0];
+    for (int i = 0; i < n; i++) {
+        if (i > 0) {
+            multipliers_[i] = lower[i - 1] / pivots_[i - 1];
+            pivots_[i] = diag[i] - multipliers_[i] * upper[i - 1];
+        }
+        if (std::fabs(pivots_[i]) <= anorm * EPSILON) {
+            /* Singular or nearly singular */
+            cond_ = 1.0e+32;
+            flag_ = 3;
+            return;
+        }
+    }
+
+    /* cond = (1-norm of a)*(an estimate of 1-norm of a-inverse) as in decomp(),
+       U-transpose * w = e with e chosen for growth, L-transpose * y = w, a * z = y */
+    Workspace &workspace = thread_workspace();
+    Workspace::Scope scope(workspace);
+    double *work = workspace.allocate<double>(n);
+    for (int k = 0; k < n; k++) {
+        const double t = k > 0 ? upper_[k - 1] * work[k - 1] : 0.0;
+        const double ek = t < 0.0 ? -1.0 : 1.0;
+        work[k] = -(ek + t) / pivots_[k];
+    }
+    for (int k = n - 2; k >= 0; k--) {
+        work[k] -= multipliers_[k + 1] * work[k + 1];
+    }
+    double ynorm = 0.0;
+    for (int i = 0; i < n; i++) ynorm += std::fabs(work[i]);
+    solve(work);
+    double znorm = 0.0;
+    for (int i = 0; i < n; i++) znorm += std::fabs(work[i]);
+    cond_ = std::max(1.0, anorm * znorm / ynorm);
+    if (cond_ + 1.0 == cond_) flag_ = 3;
+}
+
+void dimkashelk::TridiagonalSolve::solve(double b[]) const {
+    const int n = size_;
+    for (int i = 1; i < n; i++) {
+        b[i] -= multipliers_[i] * b[i - 1];
+    }
+    b[n - 1] /= pivots_[n - 1];
+    for (int i = n - 2; i >= 0; i--) {
+        b[i] = (b[i] - upper_[i] * b[i + 1]) / pivots_[i];
+    }
+}
+
+void dimkashelk::TridiagonalSolve::operator()(const std::vector<double> &matrix_right) {
+    if (size_ == 0 || static_cast<int>(matrix_right.size()) != size_) {
+        throw std::logic_error("Check data");
+    }
+    if (flag_ != 0) {
+        throw std::logic_error("Check matrix, it is singular");
+    }
+    NUMERICS_TIMER(SOLVE);
+    NUMERICS_COUNT(SOLVES, 1);
+    result_ = matrix_right;
+    solve(result_.data());
+}
+
+void dimkashelk::TridiagonalSolve::operator()(const std::vector<double> &lower, const std::vector<double> &diag,
+                                              const std::vector<double> &upper,
+                                              const std::vector<double> &matrix_right) {
+    if (diag.size() != matrix_right.size()) {
+        throw std::logic_error("Check data");
+    }
+    operator()(lower, diag, upper);
+    operator()(matrix_right);
+}
+
+std::vector<double> dimkashelk::TridiagonalSolve::get_result() const {
+    return result_;
+}
+
+double dimkashelk::TridiagonalSolve::get_cond() const {
+    return cond_;
+}
+
+int dimkashelk::TridiagonalSolve::get_flag() const {
+    return flag_;
+}
+
+int dimkashelk::TridiagonalSolve::get_size() const {
+    return size_;
+}
@@ -0,0 +1,50 @@
+#ifndef TRIDIAGONAL_SOLVE_H
+#define TRIDIAGONAL_SOLVE_H
+#include <vector>
+
+namespace dimkashelk {
+    /**
+     * \brief LU factorization without pivoting (Thomas algorithm) of a tridiagonal matrix,
+     * row i reads lower[i - 1] x[i - 1] + diag[i] x[i] + upper[i] x[i + 1] = rhs[i].
+     * The matrix must be safe for elimination without pivoting, e.g. diagonally dominant,
+     * otherwise use BandSolve with one sub- and superdiagonal
+     */
+    class TridiagonalSolve {
+    public:
+        TridiagonalSolve();
+
+        /**
+         * \brief factorize, O(n) work
+         * \param lower subdiagonal, A(i + 1, i), of size n - 1
+         * \param diag diagonal of size n
+         * \param upper superdiagonal, A(i, i + 1), of size n - 1
+         */
+        void operator()(const std::vector<double> &lower, const std::vector<double> &diag,
+                        const std::vector<double> &upper);
+
+        /**
+         * \brief solve with the last factorization, O(n) work
+         */
+        void operator()(const std::vector<double> &matrix_right);
+
+        void operator()(const std::vector<double> &lower, const std::vector<double> &diag,
+                        const std::vector<double> &upper, const std::vector<double> &matrix_right);
+
+        [[nodiscard]] std::vector<double> get_result() const;
+        [[nodiscard]] double get_cond() const;
+        [[nodiscard]] int get_flag() const;
+        [[nodiscard]] int get_size() const;
+
+    private:
+        int size_;
+        double cond_;
+        int flag_;
+        std::vector<double> multipliers_;
+        std::vector<double> pivots_;
+        std::vector<double> upper_;
+        std::vector<double> result_;
+
+        void solve(double b[]) const;
+    };
+}
+#endif
@@ -0,0 +1,169 @@
+#include "AutoRkf45.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+    constexpr double EPSILON = 2.2e-16;
+    constexpr int POWER_ITERATIONS = 3;
+
+    double norm(const std::vector<double> &v) {
+        double sum = 0.0;
+        for (const double x: v) {
+            sum += x * x;
+        }
+        return std::sqrt(sum);
+    }
+}
+
+dimkashelk::AutoRkf45::AutoRkf45(const int neqn): neqn_(neqn),
+                                                  explicit_(neqn),
+                                                  implicit_(neqn),
+                                                  rel_err_(0.0),
+                                                  abs_err_(0.0),
+                                                  max_nfe_(0),
+                                                  flag_(0),
+                                                  steps_(0),
+                                                  detections_(0),
+                                                  check_nfe_(0),
+                                                  stiff_(false),
+                                                  t_switch_(0.0),
+                                                  v_(neqn),
+                                                  w_(neqn),
+                                                  f_(neqn) {
+}
+
+void dimkashelk::AutoRkf45::start(const double rel_err, const double abs_err, const int max_nfe) {
+    rel_err_ = rel_err;
+    abs_err_ = abs_err;
+    max_nfe_ = max_nfe;
+    explicit_.start(rel_err, abs_err, max_nfe, true);
+    flag_ = 0;
+    steps_ = 0;
+    detections_ = 0;
+    check_nfe_ = 0;
+    stiff_ = false;
+    t_switch_ = 0.0;
+}
+
+int dimkashelk::AutoRkf45::operator()(Function F, double y[], double &t, const double tout) {
+    while (!stiff_ && t != tout) {
+        flag_ = explicit_(F, y, t, tout);
+        if (flag_ != 2 && flag_ != -2) {
+            return flag_;
+        }
+        if (++steps_ % STIFF_CHECK != 0) {
+            continue;
+        }
+        const double h = explicit_.getStep();
+        if (std::fabs(h) * spectral_radius(F, y, t) > STIFF_LIMIT) {
+            detections_++;
+        } else {
+            detections_ = 0;
+        }
+        if (detections_ >= 2) {
+            stiff_ = true;
+            t_switch_ = t;
+            implicit_.start(rel_err_, abs_err_, max_nfe_, h);
+        }
+    }
+    if (stiff_ && t != tout) {
+        flag_ = implicit_(F, y, t, tout);
+        return flag_;
+    }
+    flag_ = 2;
+    return flag_;
+}
+
+int dimkashelk::AutoRkf45::getNeqn() const {
+    return neqn_;
+}
+
+int dimkashelk::AutoRkf45::getFlag() const {
+    return flag_;
+}
+
+int dimkashelk::AutoRkf45::getNfe() const {
+    return explicit_.getNfe() + check_nfe_ + (stiff_ ? implicit_.getNfe() : 0);
+}
+
+bool dimkashelk::AutoRkf45::isStiff() const {
+    return stiff_;
+}
+
+double dimkashelk::AutoRkf45::getSwitchPoint() const {
+    return t_switch_;
+}
+
+const dimkashelk::Rkf45 &dimkashelk::AutoRkf45::getExplicit() const {
+    return explicit_;
+}
+
+const dimkashelk::Rosenbrock23 &dimkashelk::AutoRkf45::getImplicit() const {
+    return implicit_;
+}
+
+double dimkashelk::AutoRkf45::spectral_radius(Function F, const double y[], const double t) {
+    const int n = neqn_;
+    const double *yp = explicit_.getDerivatives();
+    std::copy(yp, yp + n, v_.begin());
+    double length = norm(v_);
+    if (length == 0.0) {
+        std::fill(v_.begin(), v_.end(), 1.0);
+        length = norm(v_);
+    }
+    double size = 0.0;
+    for (int i = 0; i < n; i++) {
+        size += y[i] * y[i];
+    }
+    const double delta = std::sqrt(EPSILON) * std::max(std::sqrt(size), 1.0);
+    double radius = 0.0;
+    for (int k = 0; k < POWER_ITERATIONS; k++) {
+        /* w = J v by forward differences, v scaled to the length delta */
+        for (int i = 0; i < n; i++) {
+            v_[i] *= delta / length;
+            f_[i] = y[i] + v_[i];
+        }
+        F(n, t, f_.data(), w_.data());
+        check_nfe_++;
+        for (int i = 0; i < n; i++) {
+            w_[i] -= yp[i];
+        }
+        length = norm(w_);
+        radius = length / delta;
+        if (length == 0.0) {
+            break;
+        }
+        std::swap(v_, w_);
+    }
+    return radius;
+}
+
+void dimkashelk::AutoRkf45::calculate(Function F,
+                                      int NEQN,
+                                      double valueArray[],
+                                      double t, double tout) {
+    AutoRkf45 solver(NEQN);
+    double ABS = 0.0001, REL = 0.0001;
+    double STEP = 0.2;
+    int MAXNFE = 100000;
+    solver.start(REL, ABS, MAXNFE);
+    auto print = [&]() {
+        std::cout << "\t" << t;
+        for (int i = 0; i < NEQN; i++) {
+            std::cout << " " << valueArray[i];
+        }
+        std::cout << "\n";
+    };
+    while (t <= tout) {
+        print();
+        solver(F, valueArray, t, t + STEP);
+    }
+    print();
+    std::cout << "\tNFE: " << solver.getNfe();
+    if (solver.isStiff()) {
+        std::cout << ", stiff from t = " << solver.getSwitchPoint();
+    }
+    std::cout << "\n";
+}
@@ -0,0 +1,83 @@
+#ifndef AUTORKF45_H
+#define AUTORKF45_H
+#include <vector>
+
+#include "Rkf45.h"
+#include "Rosenbrock23.h"
+
+namespace dimkashelk {
+    /**
+     * \brief rkf45 with stiffness detection, the integration continues with Rosenbrock23 once the step size
+     * of rkf45 is limited by stability instead of accuracy.
+     *
+     * Every STIFF_CHECK steps the spectral radius of the Jacobian is estimated by a few power iterations
+     * on finite differences of F, the problem is taken as stiff when h * radius exceeds STIFF_LIMIT
+     * on two checks in a row. The switch happens once, the rest of the problem is integrated implicitly.
+     */
+    class AutoRkf45 {
+    public:
+        using Function = Rkf45::Function;
+
+        static constexpr int STIFF_CHECK = 10;
+        static constexpr double STIFF_LIMIT = 2.5;
+
+        /**
+         * \param neqn number of equations
+         */
+        explicit AutoRkf45(int neqn);
+
+        /**
+         * \brief start a new problem with rkf45
+         * \param rel_err relative error
+         * \param abs_err absolute error
+         * \param max_nfe maximum number of derivative evaluations of each method
+         */
+        void start(double rel_err, double abs_err, int max_nfe = 100000);
+
+        /**
+         * \brief integrate from t to tout
+         * \return 2 for successful integration, otherwise the flag of the method in use
+         */
+        int operator()(Function F, double y[], double &t, double tout);
+
+        [[nodiscard]] int getNeqn() const;
+        [[nodiscard]] int getFlag() const;
+        /**
+         * \brief derivative evaluations of both methods since start, including the stiffness checks
+         */
+        [[nodiscard]] int getNfe() const;
+        [[nodiscard]] bool isStiff() const;
+        /**
+         * \brief point where the integration switched to Rosenbrock23, valid if isStiff()
+         */
+        [[nodiscard]] double getSwitchPoint() const;
+        [[nodiscard]] const Rkf45 &getExplicit() const;
+        [[nodiscard]] const Rosenbrock23 &getImplicit() const;
+
+        static void calculate(Function F,
+                              int NEQN,
+                              double Y[],
+                              double T,
+                              double TOUT);
+
+    private:
+        int neqn_;
+        Rkf45 explicit_;
+        Rosenbrock23 implicit_;
+        double rel_err_;
+        double abs_err_;
+        int max_nfe_;
+        int flag_;
+        int steps_;
+        int detections_;
+        int check_nfe_;
+        bool stiff_;
+        double t_switch_;
+        std::vector<double> v_;
+        std::vector<double> w_;
+        std::vector<double> f_;
+
+        double spectral_radius(Function F, const double y[], double t);
+    };
+}
+#endif
@@ -0,0 +1,203 @@
+#include "DenseRkf45.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    constexpr double EPSILON = 2.2e-16;
+    constexpr int MAX_ITERATIONS = 100;
+}
+
+dimkashelk::DenseRkf45::DenseRkf45(const int neqn): neqn_(neqn),
+                                                    rkf_(neqn),
+                                                    event_(nullptr),
+                                                    flag_(0),
+                                                    steps_(0),
+                                                    init_(true),
+                                                    g0_(0.0),
+                                                    y0_(neqn),
+                                                    yp0_(neqn),
+                                                    yp1_(neqn),
+                                                    point_(neqn) {
+}
+
+void dimkashelk::DenseRkf45::start(const double rel_err, const double abs_err, const int max_nfe) {
+    rkf_.start(rel_err, abs_err, max_nfe, true);
+    flag_ = 0;
+    steps_ = 0;
+    init_ = true;
+    event_times_.clear();
+    event_states_.clear();
+}
+
+void dimkashelk::DenseRkf45::setEvent(const Event g) {
+    event_ = g;
+    init_ = true;
+}
+
+int dimkashelk::DenseRkf45::operator()(Function F, double y[], double &t, const double grid[], const int count,
+                                       double out[]) {
+    if (count <= 0) {
+        throw std::logic_error("Check output grid");
+    }
+    const int n = neqn_;
+    const double tend = grid[count - 1];
+    const double direction = (tend >= t) ? 1.0 : -1.0;
+    if (rkf_.getFlag() == -1 || rkf_.getFlag() == 3) {
+        /* the first interpolant needs the derivatives at the start point, a call of rkf45 with tout = t
+           evaluates them and is counted by it, 3 reports a raised relative error as rkf45 does */
+        flag_ = rkf_(F, y, t, t);
+        if (flag_ != 2) {
+            return flag_;
+        }
+        const double *yp = rkf_.getDerivatives();
+        std::copy(yp, yp + n, yp0_.begin());
+    }
+    if (init_) {
+        if (event_ != nullptr) {
+            g0_ = event_(n, t, y);
+        }
+        init_ = false;
+    }
+    int next = 0;
+    while (next < count && grid[next] == t) {
+        std::copy(y, y + n, out + next * n);
+        next++;
+    }
+    while (next < count) {
+        const double t0 = t;
+        std::copy(y, y + n, y0_.begin());
+        flag_ = rkf_(F, y, t, tend);
+        if (flag_ != 2 && flag_ != -2) {
+            return flag_;
+        }
+        steps_++;
+        const double *yp = rkf_.getDerivatives();
+        std::copy(yp, yp + n, yp1_.begin());
+        if (event_ != nullptr) {
+            const double g1 = event_(n, t, y);
+            if ((g0_ < 0.0 && g1 >= 0.0) || (g0_ > 0.0 && g1 <= 0.0)) {
+                locate(t0, t, y, g0_, g1);
+            }
+            g0_ = g1;
+        }
+        while (next < count && (grid[next] - t) * direction < 0.0) {
+            interpolate(t0, t, y, grid[next], out + next * n);
+            next++;
+        }
+        while (next < count && grid[next] == t) {
+            std::copy(y, y + n, out + next * n);
+            next++;
+        }
+        std::swap(yp0_, yp1_);
+    }
+    flag_ = 2;
+    return flag_;
+}
+
+int dimkashelk::DenseRkf45::getNeqn() const {
+    return neqn_;
+}
+
+int dimkashelk::DenseRkf45::getFlag() const {
+    return flag_;
+}
+
+int dimkashelk::DenseRkf45::getNfe() const {
+    return rkf_.getNfe();
+}
+
+int dimkashelk::DenseRkf45::getSteps() const {
+    return steps_;
+}
+
+int dimkashelk::DenseRkf45::getEventCount() const {
+    return static_cast<int>(event_times_.size());
+}
+
+const std::vector<double> &dimkashelk::DenseRkf45::getEventTimes() const {
+    return event_times_;
+}
+
+const std::vector<double> &dimkashelk::DenseRkf45::getEventStates() const {
+    return event_states_;
+}
+
+void dimkashelk::DenseRkf45::interpolate(const double t0, const double t1, const double y1[], const double s,
+                                         double out[]) const {
+    /* cubic Hermite through (t0, y0, yp0) and (t1, y1, yp1) */
+    const double h = t1 - t0;
+    const double theta = (s - t0) / h;
+    const double c = theta * (theta - 1.0);
+    for (int i = 0; i < neqn_; i++) {
+        const double dy = y1[i] - y0_[i];
+        out[i] = y0_[i] + theta * dy
+                 + c * ((1.0 - 2.0 * theta) * dy + (theta - 1.0) * h * yp0_[i] + theta * h * yp1_[i]);
+    }
+}
+
+void dimkashelk::DenseRkf45::locate(double t0, double t1, const double y1[], double g0, double g1) {
+    /* Illinois variant of regula falsi on g of the interpolant */
+    const double a0 = t0;
+    const double b0 = t1;
+    double a = t0;
+    double b = t1;
+    double ga = g0;
+    double gb = g1;
+    double root = b;
+    int side = 0;
+    for (int k = 0; k < MAX_ITERATIONS && gb != 0.0; k++) {
+        if (std::fabs(b - a) <= 4.0 * EPSILON * std::max(std::fabs(a), std::fabs(b))) {
+            break;
+        }
+        root = b - gb * (b - a) / (gb - ga);
+        interpolate(a0, b0, y1, root, point_.data());
+        const double g = event_(neqn_, root, point_.data());
+        if ((g > 0.0) == (gb > 0.0)) {
+            b = root;
+            gb = g;
+            if (side == 1) ga *= 0.5;
+            side = 1;
+        } else {
+            a = b;
+            ga = gb;
+            b = root;
+            gb = g;
+            side = -1;
+        }
+    }
+    root = b;
+    if (root == b0) {
+        std::copy(y1, y1 + neqn_, point_.begin());
+    } else {
+        interpolate(a0, b0, y1, root, point_.data());
+    }
+    event_times_.push_back(root);
+    event_states_.insert(event_states_.end(), point_.begin(), point_.end());
+}
+
+int dimkashelk::DenseRkf45::gridSize(const double t, const double tout, const double step) {
+    if (step == 0.0 || (tout - t) * step < 0.0) {
+        throw std::logic_error("Check step");
+    }
+    return static_cast<int>(std::floor((tout - t) / step + 1.0e-9)) + 1;
+}
+
+int dimkashelk::DenseRkf45::calculate(Function F,
+                                      int NEQN,
+                                      double valueArray[],
+                                      double t, double tout,
+                                      double step,
+                                      double out[]) {
+    DenseRkf45 dense(NEQN);
+    double ABS = 0.0001, REL = 0.0001;
+    int MAXNFE = 100000;
+    dense.start(REL, ABS, MAXNFE);
+    const int count = gridSize(t, tout, step);
+    std::vector<double> grid(count);
+    for (int i = 0; i < count; i++) {
+        grid[i] = t + i * step;
+    }
+    return dense(F, valueArray, t, grid.data(), count, out);
+}
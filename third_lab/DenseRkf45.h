@@ -0,0 +1,96 @@
+#ifndef DENSERKF45_H
+#define DENSERKF45_H
+#include <vector>
+
+#include "Rkf45.h"
+
+namespace dimkashelk {
+    /**
+     * \brief rkf45 with dense output, the integrator takes its natural steps in one-step mode and the solution
+     * on the output grid is taken from the cubic Hermite interpolant of each step.
+     *
+     * Output points do not shorten the steps, only the last grid point is hit exactly. An optional event
+     * function g(t, y) is watched, its sign changes are located on the interpolant and recorded.
+     */
+    class DenseRkf45 {
+    public:
+        using Function = Rkf45::Function;
+        using Event = double (*)(int n, double t, const double y[]);
+
+        explicit DenseRkf45(int neqn);
+
+        /**
+         * \brief start a new problem, events found so far are dropped
+         * \param rel_err relative error
+         * \param abs_err absolute error
+         * \param max_nfe maximum number of derivative evaluations
+         */
+        void start(double rel_err, double abs_err, int max_nfe = 100000);
+
+        /**
+         * \brief watch the zero crossings of g, nullptr to stop watching
+         */
+        void setEvent(Event g);
+
+        /**
+         * \brief integrate from t through the output grid
+         * \param F user function evaluating derivatives yp of y at t
+         * \param y solution vector, moved to the last grid point
+         * \param t independent variable, moved to the last grid point
+         * \param grid output points, ordered in the direction of integration and not before t
+         * \param count number of output points
+         * \param out buffer of count * neqn values, row i receives y(grid[i])
+         * \return flag of rkf45, 2 for successful integration
+         */
+        int operator()(Function F, double y[], double &t, const double grid[], int count, double out[]);
+
+        [[nodiscard]] int getNeqn() const;
+        [[nodiscard]] int getFlag() const;
+        [[nodiscard]] int getNfe() const;
+        [[nodiscard]] int getSteps() const;
+        [[nodiscard]] int getEventCount() const;
+        [[nodiscard]] const std::vector<double> &getEventTimes() const;
+        /**
+         * \brief solution at the events, row i of neqn values belongs to event i
+         */
+        [[nodiscard]] const std::vector<double> &getEventStates() const;
+
+        /**
+         * \brief number of points t + k * step not after tout
+         */
+        static int gridSize(double t, double tout, double step);
+
+        /**
+         * \brief solution on the grid t + k * step with eps = 0.0001
+         * \param out buffer of gridSize(T, TOUT, STEP) * NEQN values
+         * \return flag of rkf45
+         */
+        static int calculate(Function F,
+                             int NEQN,
+                             double Y[],
+                             double T,
+                             double TOUT,
+                             double STEP,
+                             double out[]);
+
+    private:
+        int neqn_;
+        Rkf45 rkf_;
+        Event event_;
+        int flag_;
+        int steps_;
+        bool init_;
+        double g0_;
+        std::vector<double> y0_;
+        std::vector<double> yp0_;
+        std::vector<double> yp1_;
+        std::vector<double> point_;
+        std::vector<double> event_times_;
+        std::vector<double> event_states_;
+
+        void interpolate(double t0, double t1, const double y1[], double s, double out[]) const;
+
+        void locate(double t0, double t1, const double y1[], double g0, double g1);
+    };
+}
+#endif
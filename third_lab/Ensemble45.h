@@ -0,0 +1,330 @@
+#ifndef ENSEMBLE45_H
+#define ENSEMBLE45_H
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "../common/ThreadPool.h"
+
+namespace dimkashelk {
+    /* number of trajectories advanced together, one per SIMD lane */
+    constexpr int ENSEMBLE_LANES = 8;
+
+    namespace details {
+        /**
+         * \brief fehl45 stages for ENSEMBLE_LANES trajectories, every lane with its own t and h.
+         * Vectors are interleaved, component k of lane l is y[k * ENSEMBLE_LANES + l].
+         * f1 gets the fifth order solution at t + h, f2 ... f5 are needed for the error estimate.
+         */
+        template<class Rhs>
+        void fehl45_lanes(const Rhs &rhs, const int neqn, const double t[], const double h[], const double y[],
+                          const double yp[], double f1[], double f2[], double f3[], double f4[], double f5[]) {
+            constexpr int L = ENSEMBLE_LANES;
+            double ts[L], ch[L];
+            int k, l;
+            const int n = neqn * L;
+
+            for (l = 0; l < L; ++l) {
+                ch[l] = h[l] / 4.0;
+                ts[l] = t[l] + ch[l];
+            }
+            for (k = 0; k < n; ++k) f5[k] = y[k] + ch[k % L] * yp[k];
+            rhs(neqn, static_cast<const double *>(ts), static_cast<const double *>(f5), f1);
+
+            for (l = 0; l < L; ++l) {
+                ch[l] = 3.0 * h[l] / 32.0;
+                ts[l] = t[l] + 3.0 * h[l] / 8.0;
+            }
+            for (k = 0; k < n; ++k) f5[k] = y[k] + ch[k % L] * (yp[k] + 3.0 * f1[k]);
+            rhs(neqn, static_cast<const double *>(ts), static_cast<const double *>(f5), f2);
+
+            for (l = 0; l < L; ++l) {
+                ch[l] = h[l] / 2197.0;
+                ts[l] = t[l] + 12.0 * h[l] / 13.0;
+            }
+            for (k = 0; k < n; ++k)
+                f5[k] = y[k] + ch[k % L] * (1932.0 * yp[k] + (7296.0 * f2[k] - 7200.0 * f1[k]));
+            rhs(neqn, static_cast<const double *>(ts), static_cast<const double *>(f5), f3);
+
+            for (l = 0; l < L; ++l) {
+                ch[l] = h[l] / 4104.0;
+                ts[l] = t[l] + h[l];
+            }
+            for (k = 0; k < n; ++k)
+                f5[k] = y[k] + ch[k % L] * ((8341.0 * yp[k] - 845.0 * f3[k]) + (29440.0 * f2[k] - 32832.0 * f1[k]));
+            rhs(neqn, static_cast<const double *>(ts), static_cast<const double *>(f5), f4);
+
+            for (l = 0; l < L; ++l) {
+                ch[l] = h[l] / 20520.0;
+                ts[l] = t[l] + h[l] / 2.0;
+            }
+            for (k = 0; k < n; ++k)
+                f1[k] = y[k] + ch[k % L] * ((-6080.0 * yp[k] + (9295.0 * f3[k] - 5643.0 * f4[k]))
+                                            + (41040.0 * f1[k] - 28352.0 * f2[k]));
+            rhs(neqn, static_cast<const double *>(ts), static_cast<const double *>(f1), f5);
+
+            /* --- Compute approximate solution at T+H. --- */
+            for (l = 0; l < L; ++l) ch[l] = h[l] / 7618050.0;
+            for (k = 0; k < n; ++k)
+                f1[k] = y[k] + ch[k % L] * ((902880.0 * yp[k] + (3855735.0 * f3[k] - 1371249.0 * f4[k]))
+                                            + (3953664.0 * f2[k] + 277020.0 * f5[k]));
+        }
+    }
+
+    /**
+     * \brief rkf45 for many trajectories of the same system.
+     *
+     * The states are stored by blocks of ENSEMBLE_LANES trajectories in interleaved (SoA) layout.
+     * The user function evaluates the derivatives of a whole block,
+     * rhs(int neqn, const double t[], const double y[], double yp[]) with
+     * y[k * ENSEMBLE_LANES + l] the k-th component of the l-th trajectory and t[l] its time.
+     * Every trajectory takes its own steps with the step size control of rkf45,
+     * the blocks are integrated in parallel. All memory is allocated by the constructor.
+     */
+    template<class Rhs>
+    class Ensemble45 {
+    public:
+        /**
+         * \brief
+         * \param neqn number of equations
+         * \param count number of trajectories
+         */
+        Ensemble45(const int neqn, const int count): neqn_(neqn),
+                                                     count_(count),
+                                                     blocks_((count + ENSEMBLE_LANES - 1) / ENSEMBLE_LANES),
+                                                     y_(get_block_size() * blocks_, 0.0),
+                                                     work_(get_block_size() * blocks_ * 6, 0.0),
+                                                     t_(static_cast<std::size_t>(blocks_) * ENSEMBLE_LANES, 0.0),
+                                                     nfe_(static_cast<std::size_t>(blocks_) * ENSEMBLE_LANES, 0),
+                                                     flag_(static_cast<std::size_t>(blocks_) * ENSEMBLE_LANES, 0) {
+            if (neqn < 1 || count < 1) {
+                throw std::logic_error("Check size of ensemble");
+            }
+        }
+
+        /**
+         * \brief component i of a trajectory, set the initial values here
+         */
+        double &operator()(const int trajectory, const int i) {
+            return y_[get_index(trajectory, i)];
+        }
+
+        [[nodiscard]] double get(const int trajectory, const int i) const {
+            return y_[get_index(trajectory, i)];
+        }
+
+        /**
+         * \brief integrate all trajectories from t to tout
+         * \param pool threads for the blocks, nullptr for serial execution
+         * \param rhs user function, called concurrently for different blocks
+         * \param t starting point
+         * \param tout output point
+         * \param rel_err relative error, raised to the minimum allowed by rkf45 if smaller
+         * \param abs_err absolute error
+         * \param max_nfe maximum number of derivative evaluations of a trajectory
+         */
+        void operator()(ThreadPool *pool, const Rhs &rhs, const double t, const double tout, const double rel_err,
+                        const double abs_err, const int max_nfe = 100000) {
+            if (rel_err < 0.0 || abs_err < 0.0) {
+                throw std::logic_error("Check tolerances");
+            }
+            auto task = [&](const int block) {
+                integrate_block(block, rhs, t, tout, rel_err, abs_err, max_nfe);
+            };
+            if (pool == nullptr) {
+                for (int block = 0; block < blocks_; block++) {
+                    task(block);
+                }
+            } else {
+                pool->run(blocks_, task);
+            }
+        }
+
+        /**
+         * \brief point reached by a trajectory
+         */
+        [[nodiscard]] double getT(const int trajectory) const { return t_[trajectory]; }
+        /**
+         * \brief 2 if tout was reached, otherwise 4, 5 or 6 as the flags of rkf45
+         */
+        [[nodiscard]] int getFlag(const int trajectory) const { return flag_[trajectory]; }
+        /**
+         * \brief number of derivative evaluations of the trajectory, counted as in rkf45
+         */
+        [[nodiscard]] int getNfe(const int trajectory) const { return nfe_[trajectory]; }
+        [[nodiscard]] int getCount() const { return count_; }
+        [[nodiscard]] int getNeqn() const { return neqn_; }
+
+    private:
+        int neqn_;
+        int count_;
+        int blocks_;
+        std::vector<double> y_;
+        std::vector<double> work_;
+        std::vector<double> t_;
+        std::vector<int> nfe_;
+        std::vector<int> flag_;
+
+        [[nodiscard]] std::size_t get_block_size() const {
+            return static_cast<std::size_t>(neqn_) * ENSEMBLE_LANES;
+        }
+
+        [[nodiscard]] std::size_t get_index(const int trajectory, const int i) const {
+            return (trajectory / ENSEMBLE_LANES) * get_block_size() + i * ENSEMBLE_LANES
+                   + trajectory % ENSEMBLE_LANES;
+        }
+
+        void integrate_block(const int block, const Rhs &rhs, const double t0, const double tout,
+                             double rel_err, const double abs_err, const int max_nfe) {
+            constexpr int L = ENSEMBLE_LANES;
+            constexpr double EPSILON = 2.2e-16;
+            constexpr double REMIN = 1.0e-12;
+            const std::size_t size = get_block_size();
+            const int n = neqn_ * L;
+            double *y = y_.data() + block * size;
+            double *yp = work_.data() + block * size * 6;
+            double *f1 = yp + size, *f2 = f1 + size, *f3 = f2 + size, *f4 = f3 + size, *f5 = f4 + size;
+            double *t = t_.data() + block * L;
+            int *flag = flag_.data() + block * L;
+            double h[L], hs[L], eeoet[L];
+            bool active[L], output[L], hfaild[L];
+            int nfe[L];
+            int k, l;
+
+            const double U26 = 26.0 * EPSILON;
+            rel_err = std::max(rel_err, 2.0 * EPSILON + REMIN);
+            const double SCALE = 2.0 / rel_err;
+            const double AE = SCALE * abs_err;
+            const double DT = tout - t0;
+
+            for (l = 0; l < L; ++l) {
+                t[l] = t0;
+                flag[l] = 2;
+                active[l] = (block * L + l < count_) && t0 != tout;
+                output[l] = false;
+                hfaild[l] = false;
+                nfe[l] = 1;
+            }
+            rhs(neqn_, static_cast<const double *>(t), static_cast<const double *>(y), yp);
+
+            /* estimate starting stepsize */
+            for (l = 0; l < L; ++l) {
+                double toln = 0.0;
+                h[l] = std::fabs(DT);
+                for (k = 0; k < neqn_; ++k) {
+                    const double tol = rel_err * std::fabs(y[k * L + l]) + abs_err;
+                    if (tol <= 0.0) continue;
+                    toln = tol;
+                    const double ypk = std::fabs(yp[k * L + l]);
+                    if (ypk * std::pow(h[l], 5.0) > tol) h[l] = std::pow(tol / ypk, 0.2);
+                }
+                if (toln <= 0.0) h[l] = 0.0;
+                h[l] = std::max(h[l], U26 * std::max(std::fabs(t0), std::fabs(DT)));
+                h[l] = (DT > 0.0) ? std::fabs(h[l]) : -std::fabs(h[l]);
+            }
+
+            /* too close to output point, extrapolate (linearly) */
+            if (std::fabs(DT) <= U26 * std::fabs(t0)) {
+                for (k = 0; k < n; ++k) y[k] += active[k % L] ? DT * yp[k] : 0.0;
+                for (l = 0; l < L; ++l) t[l] = active[l] ? tout : t[l];
+                for (l = 0; l < L; ++l) nfe_[block * L + l] = nfe[l];
+                return;
+            }
+
+            for (;;) {
+                bool any = false;
+                for (l = 0; l < L; ++l) {
+                    hs[l] = 0.0;
+                    if (!active[l]) continue;
+                    if (nfe[l] > max_nfe) {
+                        /* Too much work */
+                        flag[l] = 4;
+                        active[l] = false;
+                        continue;
+                    }
+                    any = true;
+                    /* Adjust stepsize if necessary to hit the output point, a rejected step is retried
+                       with the reduced h as it is */
+                    const double dt = tout - t[l];
+                    if (!hfaild[l] && std::fabs(dt) < 2.0 * std::fabs(h[l])) {
+                        if (std::fabs(dt) <= std::fabs(h[l])) {
+                            output[l] = true;
+                            h[l] = dt;
+                        } else h[l] = 0.5 * dt;
+                    }
+                    hs[l] = h[l];
+                }
+                if (!any) break;
+
+                /* Advance all lanes over one step, finished lanes take h = 0 */
+                details::fehl45_lanes(rhs, neqn_, t, hs, y, yp, f1, f2, f3, f4, f5);
+                for (l = 0; l < L; ++l) nfe[l] += active[l] ? 5 : 0;
+
+                for (l = 0; l < L; ++l) eeoet[l] = 0.0;
+                for (k = 0; k < n; ++k) {
+                    l = k % L;
+                    const double et = std::fabs(y[k]) + std::fabs(f1[k]) + AE;
+                    const double ee = std::fabs((-2090.0 * yp[k] + (21970.0 * f3[k] - 15048.0 * f4[k]))
+                                                + (22528.0 * f2[k] - 27360.0 * f5[k]));
+                    if (et <= 0.0) {
+                        /* Inappropriate error tolerance */
+                        if (active[l]) flag[l] = 5;
+                        active[l] = false;
+                        hs[l] = 0.0;
+                        continue;
+                    }
+                    eeoet[l] = std::max(eeoet[l], ee / et);
+                }
+
+                bool accepted = false;
+                for (l = 0; l < L; ++l) {
+                    if (!active[l]) continue;
+                    const double hmin = U26 * std::fabs(t[l]);
+                    const double esttol = std::fabs(h[l]) * eeoet[l] * SCALE / 752400.0;
+                    if (esttol > 1.0) {
+                        /* --- Unsuccessful step --- */
+                        hfaild[l] = true;
+                        output[l] = false;
+                        double s = 0.1;
+                        if (esttol < 59049.0) s = 0.9 / std::pow(esttol, 0.2);
+                        h[l] *= s;
+                        if (std::fabs(h[l]) <= hmin) {
+                            /* Requested error unattainable at smallest allowable stepsize */
+                            flag[l] = 6;
+                            active[l] = false;
+                        }
+                        hs[l] = 0.0;
+                        continue;
+                    }
+                    /* --- successful step --- */
+                    accepted = true;
+                    t[l] += h[l];
+                    for (k = l; k < n; k += L) y[k] = f1[k];
+                    double s = 5.0;
+                    if (esttol > 1.889568E-4) s = 0.9 / std::pow(esttol, 0.2);
+                    if (hfaild[l]) s = std::min(s, 1.0);
+                    h[l] = (h[l] > 0.0) ? std::max(s * std::fabs(h[l]), hmin) : -std::max(s * std::fabs(h[l]), hmin);
+                    hfaild[l] = false;
+                    if (output[l]) {
+                        t[l] = tout;
+                        active[l] = false;
+                    }
+                    hs[l] = 1.0;
+                }
+
+                if (accepted) {
+                    /* derivatives at the new points, kept only for the lanes which moved */
+                    rhs(neqn_, static_cast<const double *>(t), static_cast<const double *>(y), f2);
+                    for (l = 0; l < L; ++l) nfe[l] += hs[l] != 0.0 ? 1 : 0;
+                    for (k = 0; k < n; ++k) {
+                        if (hs[k % L] != 0.0) yp[k] = f2[k];
+                    }
+                }
+            }
+            for (l = 0; l < L; ++l) nfe_[block * L + l] = nfe[l];
+        }
+    };
+}
+#endif
@@ -0,0 +1,190 @@
+#ifndef EXPLICITRK_H
+#define EXPLICITRK_H
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+namespace dimkashelk {
+    /**
+     * \brief Butcher tableaux for ExplicitRK, a is strictly lower triangular, embedded methods also
+     * give e = b - b_hat for the error estimate
+     */
+    struct Rk4 {
+        static constexpr int stages = 4;
+        static constexpr int order = 4;
+        static constexpr bool embedded = false;
+        static constexpr double c[stages] = {0.0, 0.5, 0.5, 1.0};
+        static constexpr double a[stages][stages] = {
+            {},
+            {0.5},
+            {0.0, 0.5},
+            {0.0, 0.0, 1.0}
+        };
+        static constexpr double b[stages] = {1.0 / 6.0, 1.0 / 3.0, 1.0 / 3.0, 1.0 / 6.0};
+    };
+
+    /**
+     * \brief six stage method of rungeKutta6 in main.cpp
+     */
+    struct Rk6 {
+        static constexpr int stages = 6;
+        static constexpr int order = 5;
+        static constexpr bool embedded = false;
+        static constexpr double c[stages] = {0.0, 1.0 / 3.0, 0.4, 1.0, 2.0 / 3.0, 0.8};
+        static constexpr double a[stages][stages] = {
+            {},
+            {1.0 / 3.0},
+            {0.16, 0.24},
+            {0.25, -3.0, 3.75},
+            {6.0 / 81.0, 90.0 / 81.0, -50.0 / 81.0, 8.0 / 81.0},
+            {6.0 / 75.0, 36.0 / 75.0, 10.0 / 75.0, 8.0 / 75.0}
+        };
+        static constexpr double b[stages] = {23.0 / 192.0, 0.0, 125.0 / 192.0, 0.0, -81.0 / 192.0, 125.0 / 192.0};
+    };
+
+    /**
+     * \brief Fehlberg 4(5) as in rkf45, the fifth order solution is propagated
+     */
+    struct Fehlberg45 {
+        static constexpr int stages = 6;
+        static constexpr int order = 5;
+        static constexpr bool embedded = true;
+        static constexpr double c[stages] = {0.0, 0.25, 0.375, 12.0 / 13.0, 1.0, 0.5};
+        static constexpr double a[stages][stages] = {
+            {},
+            {0.25},
+            {3.0 / 32.0, 9.0 / 32.0},
+            {1932.0 / 2197.0, -7200.0 / 2197.0, 7296.0 / 2197.0},
+            {439.0 / 216.0, -8.0, 3680.0 / 513.0, -845.0 / 4104.0},
+            {-8.0 / 27.0, 2.0, -3544.0 / 2565.0, 1859.0 / 4104.0, -11.0 / 40.0}
+        };
+        static constexpr double b[stages] = {
+            16.0 / 135.0, 0.0, 6656.0 / 12825.0, 28561.0 / 56430.0, -9.0 / 50.0, 2.0 / 55.0
+        };
+        static constexpr double e[stages] = {
+            16.0 / 135.0 - 25.0 / 216.0, 0.0, 6656.0 / 12825.0 - 1408.0 / 2565.0,
+            28561.0 / 56430.0 - 2197.0 / 4104.0, -9.0 / 50.0 + 0.2, 2.0 / 55.0
+        };
+    };
+
+    /**
+     * \brief Dormand-Prince 5(4), the fifth order solution is propagated
+     */
+    struct DormandPrince45 {
+        static constexpr int stages = 7;
+        static constexpr int order = 5;
+        static constexpr bool embedded = true;
+        static constexpr double c[stages] = {0.0, 0.2, 0.3, 0.8, 8.0 / 9.0, 1.0, 1.0};
+        static constexpr double a[stages][stages] = {
+            {},
+            {0.2},
+            {3.0 / 40.0, 9.0 / 40.0},
+            {44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0},
+            {19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0},
+            {9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0},
+            {35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0}
+        };
+        static constexpr double b[stages] = {
+            35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0, 0.0
+        };
+        static constexpr double e[stages] = {
+            35.0 / 384.0 - 5179.0 / 57600.0, 0.0, 500.0 / 1113.0 - 7571.0 / 16695.0, 125.0 / 192.0 - 393.0 / 640.0,
+            -2187.0 / 6784.0 + 92097.0 / 339200.0, 11.0 / 84.0 - 187.0 / 2100.0, -1.0 / 40.0
+        };
+    };
+
+    /**
+     * \brief explicit Runge-Kutta method given by a tableau, for systems of fixed size N.
+     *
+     * The stages are expanded at compile time and the right hand side is taken as a template argument,
+     * rhs(t, y) returns the derivatives as std::array<double, N>, so small systems are fully inlined.
+     */
+    template<class Tableau, std::size_t N>
+    class ExplicitRK {
+    public:
+        using State = std::array<double, N>;
+        static constexpr int stages = Tableau::stages;
+
+        /**
+         * \brief one step of size h from t
+         */
+        template<class Rhs>
+        static void step(Rhs &&rhs, const double t, State &y, const double h) {
+            std::array<State, stages> k;
+            evaluate(rhs, t, y, h, k, std::make_index_sequence<stages>{});
+            combine(y, h, k, Tableau::b);
+        }
+
+        /**
+         * \brief one step of size h from t with the local error estimate of an embedded method
+         * \return max norm of the error estimate
+         */
+        template<class Rhs>
+        static double step(Rhs &&rhs, const double t, State &y, const double h, State &error) {
+            static_assert(Tableau::embedded, "Tableau has no embedded method");
+            std::array<State, stages> k;
+            evaluate(rhs, t, y, h, k, std::make_index_sequence<stages>{});
+            error.fill(0.0);
+            combine(error, h, k, Tableau::e);
+            combine(y, h, k, Tableau::b);
+            double norm = 0.0;
+            for (std::size_t i = 0; i < N; i++) {
+                norm = std::fmax(norm, std::fabs(error[i]));
+            }
+            return norm;
+        }
+
+        /**
+         * \brief integrate from t to tend with the fixed step h, the last step is shortened to hit tend
+         * \return number of steps
+         */
+        template<class Rhs>
+        static int integrate(Rhs &&rhs, State &y, const double t, const double tend, const double h) {
+            const double direction = (tend >= t) ? 1.0 : -1.0;
+            const double hs = direction * std::fabs(h);
+            int count = 0;
+            double s = t;
+            while ((tend - s) * direction > 0.0) {
+                const bool last = std::fabs(tend - s) <= std::fabs(hs) * (1.0 + 1.0e-12);
+                step(rhs, s, y, last ? tend - s : hs);
+                count++;
+                s = last ? tend : t + count * hs;
+            }
+            return count;
+        }
+
+    private:
+        template<class Rhs, std::size_t... I>
+        static void evaluate(Rhs &rhs, const double t, const State &y, const double h, std::array<State, stages> &k,
+                             std::index_sequence<I...>) {
+            (stage<I>(rhs, t, y, h, k), ...);
+        }
+
+        template<std::size_t I, class Rhs>
+        static void stage(Rhs &rhs, const double t, const State &y, const double h, std::array<State, stages> &k) {
+            State argument = y;
+            for (std::size_t j = 0; j < I; j++) {
+                const double coefficient = h * Tableau::a[I][j];
+                if (Tableau::a[I][j] != 0.0) {
+                    for (std::size_t i = 0; i < N; i++) {
+                        argument[i] += coefficient * k[j][i];
+                    }
+                }
+            }
+            k[I] = rhs(t + Tableau::c[I] * h, static_cast<const State &>(argument));
+        }
+
+        static void combine(State &y, const double h, const std::array<State, stages> &k,
+                            const double (&weights)[stages]) {
+            for (std::size_t i = 0; i < N; i++) {
+                double sum = 0.0;
+                for (int j = 0; j < stages; j++) {
+                    sum += weights[j] * k[j][i];
+                }
+                y[i] += h * sum;
+            }
+        }
+    };
+}
+#endif
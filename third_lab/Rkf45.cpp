@@ -1,25 +1,124 @@
 #include "Rkf45.h"
 #include "rkf.h"
+#include "DenseRkf45.h"
 #include <cmath>
 #include <iostream>
+#include <new>
+#include <stdexcept>
+#include <vector>
 
-void dimkashelk::Rkf45::calculate(int (*F)(int n, double t, double y[], double yp[]),
+#include "../common/Statistics.h"
+#include "../common/Workspace.h"
+
+dimkashelk::Rkf45::Rkf45(const int neqn): neqn_(neqn),
+                                          yp_(nullptr),
+                                          work_(nullptr),
+                                          rel_err_(0.0),
+                                          abs_err_(0.0),
+                                          h_(0.0),
+                                          nfe_(0),
+                                          max_nfe_(0),
+                                          flag_(1),
+                                          one_step_(false) {
+    if (neqn < 1) {
+        throw std::logic_error("Check number of equations");
+    }
+    owned_yp_ = std::make_unique<double[]>(neqn);
+    owned_work_ = std::make_unique<rkf_work>();
+    yp_ = owned_yp_.get();
+    work_ = owned_work_.get();
+    int fail = 0;
+    rkfinit(neqn_, work_, &fail);
+    if (fail != 0) {
+        rkfend(work_);
+        throw std::bad_alloc();
+    }
+}
+
+dimkashelk::Rkf45::Rkf45(const int neqn, Workspace &workspace): neqn_(neqn),
+                                                                yp_(nullptr),
+                                                                work_(nullptr),
+                                                                rel_err_(0.0),
+                                                                abs_err_(0.0),
+                                                                h_(0.0),
+                                                                nfe_(0),
+                                                                max_nfe_(0),
+                                                                flag_(1),
+                                                                one_step_(false) {
+    if (neqn < 1) {
+        throw std::logic_error("Check number of equations");
+    }
+    work_ = workspace.allocate<rkf_work>(1);
+    yp_ = workspace.allocate<double>(neqn);
+    int fail = 0;
+    rkfattach(neqn_, work_, workspace.allocate<double>(rkfworkspace(neqn)), &fail);
+}
+
+std::size_t dimkashelk::Rkf45::workspace_size(const int neqn) {
+    return Workspace::bytes<rkf_work>(1) + Workspace::bytes<double>(neqn) + Workspace::bytes<double>(rkfworkspace(neqn));
+}
+
+void dimkashelk::Rkf45::start(const double rel_err, const double abs_err, const int max_nfe, const bool one_step) {
+    rel_err_ = rel_err;
+    abs_err_ = abs_err;
+    max_nfe_ = max_nfe;
+    nfe_ = 0;
+    h_ = 0.0;
+    one_step_ = one_step;
+    flag_ = one_step ? -1 : 1;
+}
+
+int dimkashelk::Rkf45::operator()(Function F, double y[], double &t, const double tout) {
+    NUMERICS_TIMER(ODE);
+    if (one_step_ && flag_ == 2) {
+        /* a new output point in one-step mode */
+        flag_ = -2;
+    }
+    rkf45(F, neqn_, y, yp_, &t, tout, &rel_err_, abs_err_, &h_, &nfe_, max_nfe_, &flag_, work_);
+    return flag_;
+}
+
+int dimkashelk::Rkf45::getNeqn() const {
+    return neqn_;
+}
+
+int dimkashelk::Rkf45::getFlag() const {
+    return flag_;
+}
+
+int dimkashelk::Rkf45::getNfe() const {
+    return nfe_;
+}
+
+double dimkashelk::Rkf45::getStep() const {
+    return h_;
+}
+
+double dimkashelk::Rkf45::getRelErr() const {
+    return rel_err_;
+}
+
+const double *dimkashelk::Rkf45::getDerivatives() const {
+    return yp_;
+}
+
+dimkashelk::Rkf45::~Rkf45() {
+    rkfend(work_);
+}
+
+void dimkashelk::Rkf45::calculate(Function F,
+                                  int NEQN,
                                   double valueArray[],
                                   double t, double tout) {
-    int flag = 0;
-    int NEQN = 2;
-    rkfinit(NEQN, &flag);
-    double dop[2]{0.0, 0.0};
-    flag = 1;
-    double ABS = 0.0001, REL = 0.0001;
-    double H[NEQN];
     double STEP = 0.2;
-    int NFE = 0;
-    int MAXNFE = 100000;
-    while (t <= tout) {
-        std::cout << "\t" << t << " " << valueArray[0] << " " << valueArray[1] << "\n";
-        rkf45(F, NEQN, valueArray, dop, &t, t + STEP, &REL, ABS, H, &NFE, MAXNFE, &flag);
+    const int count = DenseRkf45::gridSize(t, tout, STEP);
+    std::vector<double> out(count * NEQN);
+    DenseRkf45::calculate(F, NEQN, valueArray, t, tout, STEP, out.data());
+    for (int k = 0; k < count; k++) {
+        std::cout << "\t" << t + k * STEP;
+        for (int i = 0; i < NEQN; i++) {
+            std::cout << " " << out[k * NEQN + i];
+        }
+        std::cout << "\n";
     }
-    std::cout << "\t" << t << " " << valueArray[0] << " " << valueArray[1] << "\n";
-    rkfend();
 }
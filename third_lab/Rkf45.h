@@ -1,13 +1,93 @@
 #ifndef RKF45_H
 #define RKF45_H
+#include <cstddef>
+#include <memory>
+
+struct rkf_work;
 
 namespace dimkashelk {
+    class Workspace;
+
+    /**
+     * \brief rkf45 integrator owning its state, one object per concurrent integration
+     */
     class Rkf45 {
     public:
-        static void calculate(int (*F)(int n, double t, double y[], double yp[]),
+        using Function = int (*)(int n, double t, double y[], double yp[]);
+
+        /**
+         * \brief allocate the workspace once, it is reused by all later integrations
+         * \param neqn number of equations
+         */
+        explicit Rkf45(int neqn);
+
+        /**
+         * \brief take the state from an arena instead of the heap, the arena must not be
+         * released while the integrator lives
+         * \param neqn number of equations
+         * \param workspace arena giving workspace_size(neqn) bytes
+         */
+        Rkf45(int neqn, Workspace &workspace);
+
+        /**
+         * \brief bytes drawn from the workspace by an integrator of neqn equations
+         */
+        static std::size_t workspace_size(int neqn);
+
+        Rkf45(const Rkf45 &) = delete;
+
+        Rkf45 &operator=(const Rkf45 &) = delete;
+
+        /**
+         * \brief start a new problem, the next call of operator() initializes the integration
+         * \param rel_err relative error
+         * \param abs_err absolute error
+         * \param max_nfe maximum number of derivative evaluations per call
+         * \param one_step return after every step, operator() then gives -2 until tout is reached
+         */
+        void start(double rel_err, double abs_err, int max_nfe = 100000, bool one_step = false);
+
+        /**
+         * \brief integrate from t to tout, continues the integration of the previous call
+         * \param F user function evaluating derivatives yp of y at t
+         * \param y solution vector, of size neqn
+         * \param t independent variable, moved to the point reached
+         * \param tout output point
+         * \return flag of rkf45, 2 for successful integration
+         */
+        int operator()(Function F, double y[], double &t, double tout);
+
+        [[nodiscard]] int getNeqn() const;
+        [[nodiscard]] int getFlag() const;
+        [[nodiscard]] int getNfe() const;
+        [[nodiscard]] double getStep() const;
+        [[nodiscard]] double getRelErr() const;
+        /**
+         * \brief derivatives at the point reached
+         */
+        [[nodiscard]] const double *getDerivatives() const;
+
+        ~Rkf45();
+
+        static void calculate(Function F,
+                              int NEQN,
                               double Y[],
                               double T,
                               double TOUT);
+
+    private:
+        int neqn_;
+        double *yp_;
+        rkf_work *work_;
+        std::unique_ptr<double[]> owned_yp_;
+        std::unique_ptr<rkf_work> owned_work_;
+        double rel_err_;
+        double abs_err_;
+        double h_;
+        int nfe_;
+        int max_nfe_;
+        int flag_;
+        bool one_step_;
     };
 }
 #endif
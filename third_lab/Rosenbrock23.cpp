@@ -0,0 +1,318 @@
+#include "Rosenbrock23.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "../common/Statistics.h"
+
+namespace {
+    constexpr double EPSILON = 2.2e-16;
+    /* d = 1 / (2 + sqrt(2)) and e32 = 6 + sqrt(2) of the formula */
+    const double D = 1.0 / (2.0 + std::sqrt(2.0));
+    const double E32 = 6.0 + std::sqrt(2.0);
+}
+
+dimkashelk::Rosenbrock23::Rosenbrock23(const int neqn): neqn_(neqn),
+                                                        rel_err_(0.0),
+                                                        abs_err_(0.0),
+                                                        max_nfe_(0),
+                                                        h_(0.0),
+                                                        h_w_(0.0),
+                                                        init_(true),
+                                                        jacobian_fresh_(false),
+                                                        decomp_valid_(false),
+                                                        flag_(0),
+                                                        nfe_(0),
+                                                        steps_(0),
+                                                        rejected_(0),
+                                                        jacobians_(0),
+                                                        decompositions_(0),
+                                                        jacobian_(std::max(neqn, 1), std::max(neqn, 1)),
+                                                        w_(std::max(neqn, 1), std::max(neqn, 1)),
+                                                        f0_(neqn),
+                                                        f1_(neqn),
+                                                        f2_(neqn),
+                                                        k1_(neqn),
+                                                        k2_(neqn),
+                                                        k3_(neqn),
+                                                        dfdt_(neqn),
+                                                        ynew_(neqn),
+                                                        rhs_(neqn) {
+    if (neqn < 1) {
+        throw std::logic_error("Check number of equations");
+    }
+}
+
+void dimkashelk::Rosenbrock23::start(const double rel_err, const double abs_err, const int max_nfe, const double h) {
+    if (rel_err < 0.0 || abs_err < 0.0 || rel_err + abs_err == 0.0) {
+        throw std::logic_error("Check tolerances");
+    }
+    rel_err_ = rel_err;
+    abs_err_ = abs_err;
+    max_nfe_ = max_nfe;
+    h_ = std::fabs(h);
+    init_ = true;
+    jacobian_fresh_ = false;
+    decomp_valid_ = false;
+    flag_ = 0;
+    nfe_ = 0;
+    steps_ = 0;
+    rejected_ = 0;
+    jacobians_ = 0;
+    decompositions_ = 0;
+}
+
+int dimkashelk::Rosenbrock23::operator()(Function F, double y[], double &t, const double tout) {
+    NUMERICS_TIMER(ODE);
+    const int n = neqn_;
+    if (init_) {
+        F(n, t, y, f0_.data());
+        nfe_++;
+        NUMERICS_COUNT(RHS_CALLS, 1);
+        init_ = false;
+        evaluate_jacobian(F, y, t);
+        if (h_ == 0.0) {
+            /* the local error behaves as h^3 */
+            h_ = std::fabs(tout - t);
+            for (int i = 0; i < n; i++) {
+                const double tol = rel_err_ * std::fabs(y[i]) + abs_err_;
+                const double ypk = std::fabs(f0_[i]);
+                if (ypk * std::pow(h_, 3.0) > tol) h_ = std::pow(tol / ypk, 1.0 / 3.0);
+            }
+            h_ = std::max(h_, 26.0 * EPSILON * std::max(std::fabs(t), std::fabs(tout - t)));
+        }
+    }
+    const double direction = (tout >= t) ? 1.0 : -1.0;
+    if (flag_ == 4) {
+        /* continuation after too much work */
+        nfe_ = 0;
+    }
+    bool failed = false;
+    while (t != tout) {
+        if (nfe_ > max_nfe_) {
+            flag_ = 4;
+            return flag_;
+        }
+        const double hmin = 26.0 * EPSILON * std::fabs(t);
+        double h = h_;
+        bool last = false;
+        if (std::fabs(tout - t) <= 1.05 * h) {
+            h = std::fabs(tout - t);
+            last = true;
+        }
+        const double hs = direction * h;
+        if (!factorize(hs)) {
+            /* W is singular to working precision, h d is close to 1 / lambda for an eigenvalue of J */
+            rejected_++;
+            NUMERICS_COUNT(REJECTED_STEPS, 1);
+            failed = true;
+            h_ = 0.5 * h;
+            if (h_ <= hmin) {
+                flag_ = 6;
+                return flag_;
+            }
+            if (!jacobian_fresh_) {
+                evaluate_jacobian(F, y, t);
+            }
+            continue;
+        }
+
+        /* k1 = W \ (F0 + h d T) */
+        for (int i = 0; i < n; i++) rhs_[i] = f0_[i] + hs * D * dfdt_[i];
+        solve_w();
+        std::copy(rhs_.begin(), rhs_.end(), k1_.begin());
+
+        /* F1 = f(t + h / 2, y + h k1 / 2), k2 = W \ (F1 - k1) + k1 */
+        for (int i = 0; i < n; i++) ynew_[i] = y[i] + 0.5 * hs * k1_[i];
+        F(n, t + 0.5 * hs, ynew_.data(), f1_.data());
+        for (int i = 0; i < n; i++) rhs_[i] = f1_[i] - k1_[i];
+        solve_w();
+        for (int i = 0; i < n; i++) k2_[i] = rhs_[i] + k1_[i];
+
+        /* ynew = y + h k2, F2 = f(t + h, ynew) */
+        for (int i = 0; i < n; i++) ynew_[i] = y[i] + hs * k2_[i];
+        F(n, t + hs, ynew_.data(), f2_.data());
+        nfe_ += 2;
+        NUMERICS_COUNT(RHS_CALLS, 2);
+
+        /* k3 = W \ (F2 - e32 (k2 - F1) - 2 (k1 - F0) + h d T) */
+        for (int i = 0; i < n; i++)
+            rhs_[i] = f2_[i] - E32 * (k2_[i] - f1_[i]) - 2.0 * (k1_[i] - f0_[i]) + hs * D * dfdt_[i];
+        solve_w();
+        std::copy(rhs_.begin(), rhs_.end(), k3_.begin());
+
+        /* error = h / 6 (k1 - 2 k2 + k3) */
+        double err = 0.0;
+        for (int i = 0; i < n; i++) {
+            const double e = std::fabs(h / 6.0 * (k1_[i] - 2.0 * k2_[i] + k3_[i]));
+            const double scale = rel_err_ * std::max(std::fabs(y[i]), std::fabs(ynew_[i])) + abs_err_;
+            err = std::max(err, e / scale);
+        }
+
+        if (err > 1.0 || !std::isfinite(err)) {
+            /* --- Unsuccessful step --- */
+            rejected_++;
+            NUMERICS_COUNT(REJECTED_STEPS, 1);
+            failed = true;
+            h_ = h * (std::isfinite(err) ? std::max(0.1, 0.8 * std::pow(err, -1.0 / 3.0)) : 0.1);
+            if (h_ <= hmin) {
+                flag_ = 6;
+                return flag_;
+            }
+            if (!jacobian_fresh_) {
+                evaluate_jacobian(F, y, t);
+            }
+            continue;
+        }
+
+        /* --- successful step --- */
+        steps_++;
+        NUMERICS_COUNT(ACCEPTED_STEPS, 1);
+        t = last ? tout : t + hs;
+        std::copy(ynew_.begin(), ynew_.end(), y);
+        std::copy(f2_.begin(), f2_.end(), f0_.begin());
+        jacobian_fresh_ = false;
+
+        /* Choose next stepsize, an increase below 20 % keeps W */
+        double s = (err > 0.0) ? 0.8 * std::pow(err, -1.0 / 3.0) : 5.0;
+        s = std::min(s, 5.0);
+        if (failed) {
+            s = std::min(s, 1.0);
+            failed = false;
+        }
+        if (s > 1.0 && s < 1.2) {
+            s = 1.0;
+        }
+        if (!last || s < 1.0) {
+            h_ = std::max(h * s, hmin);
+        }
+    }
+    flag_ = 2;
+    return flag_;
+}
+
+int dimkashelk::Rosenbrock23::getNeqn() const {
+    return neqn_;
+}
+
+int dimkashelk::Rosenbrock23::getFlag() const {
+    return flag_;
+}
+
+int dimkashelk::Rosenbrock23::getNfe() const {
+    return nfe_;
+}
+
+int dimkashelk::Rosenbrock23::getSteps() const {
+    return steps_;
+}
+
+int dimkashelk::Rosenbrock23::getRejected() const {
+    return rejected_;
+}
+
+int dimkashelk::Rosenbrock23::getJacobians() const {
+    return jacobians_;
+}
+
+int dimkashelk::Rosenbrock23::getDecompositions() const {
+    return decompositions_;
+}
+
+double dimkashelk::Rosenbrock23::getStep() const {
+    return h_;
+}
+
+void dimkashelk::Rosenbrock23::set_jacobian(Jacobian jacobian) {
+    user_jacobian_ = std::move(jacobian);
+    jacobian_fresh_ = false;
+    decomp_valid_ = false;
+}
+
+void dimkashelk::Rosenbrock23::evaluate_jacobian(Function F, const double y[], const double t) {
+    const int n = neqn_;
+    if (user_jacobian_) {
+        const int calls = user_jacobian_(t, y, f0_.data(), jacobian_, dfdt_.data());
+        nfe_ += calls;
+        jacobians_++;
+        NUMERICS_COUNT(RHS_CALLS, calls);
+        NUMERICS_COUNT(JACOBIANS, 1);
+        jacobian_fresh_ = true;
+        decomp_valid_ = false;
+        return;
+    }
+    std::copy(y, y + n, ynew_.begin());
+    for (int j = 0; j < n; j++) {
+        const double delta = std::sqrt(EPSILON) * std::max(std::fabs(y[j]), 1.0e-5);
+        ynew_[j] = y[j] + delta;
+        F(n, t, ynew_.data(), f1_.data());
+        ynew_[j] = y[j];
+        for (int i = 0; i < n; i++) {
+            jacobian_(i, j) = (f1_[i] - f0_[i]) / delta;
+        }
+    }
+    const double delta = std::sqrt(EPSILON) * std::max(std::fabs(t), 1.0);
+    F(n, t + delta, ynew_.data(), f1_.data());
+    for (int i = 0; i < n; i++) {
+        dfdt_[i] = (f1_[i] - f0_[i]) / delta;
+    }
+    nfe_ += n + 1;
+    jacobians_++;
+    NUMERICS_COUNT(RHS_CALLS, n + 1);
+    NUMERICS_COUNT(JACOBIANS, 1);
+    jacobian_fresh_ = true;
+    decomp_valid_ = false;
+}
+
+bool dimkashelk::Rosenbrock23::factorize(const double h) {
+    if (decomp_valid_ && h == h_w_) {
+        return true;
+    }
+    const int n = neqn_;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            w_(i, j) = ((i == j) ? 1.0 : 0.0) - h * D * jacobian_(i, j);
+        }
+    }
+    decomp_(w_);
+    h_w_ = h;
+    decompositions_++;
+    decomp_valid_ = decomp_.get_flag() == 0;
+    return decomp_valid_;
+}
+
+void dimkashelk::Rosenbrock23::solve_w() {
+    solve_(decomp_, rhs_);
+    const ConstMatrixView result = solve_.get_result_view();
+    for (int i = 0; i < neqn_; i++) {
+        rhs_[i] = result(i, 0);
+    }
+}
+
+void dimkashelk::Rosenbrock23::calculate(Function F,
+                                         int NEQN,
+                                         double valueArray[],
+                                         double t, double tout) {
+    Rosenbrock23 solver(NEQN);
+    double ABS = 0.0001, REL = 0.0001;
+    double STEP = 0.2;
+    int MAXNFE = 100000;
+    solver.start(REL, ABS, MAXNFE);
+    auto print = [&]() {
+        std::cout << "\t" << t;
+        for (int i = 0; i < NEQN; i++) {
+            std::cout << " " << valueArray[i];
+        }
+        std::cout << "\n";
+    };
+    while (t <= tout) {
+        print();
+        solver(F, valueArray, t, t + STEP);
+    }
+    print();
+    std::cout << "\tNFE: " << solver.getNfe() << ", steps: " << solver.getSteps() << ", jacobians: " << solver.getJacobians()
+              << ", decompositions: " << solver.getDecompositions() << "\n";
+}
@@ -0,0 +1,113 @@
+#ifndef ROSENBROCK23_H
+#define ROSENBROCK23_H
+#include <functional>
+#include <vector>
+
+#include "../second_lab/Decomp.h"
+#include "../second_lab/Matrix.h"
+#include "../second_lab/Solve.h"
+
+namespace dimkashelk {
+    /**
+     * \brief linearly implicit integrator for stiff systems, the modified Rosenbrock
+     * formula of order 2 with error estimate of order 3 (L. F. Shampine, M. W. Reichelt, ode23s).
+     *
+     * Every step solves three linear systems with W = I - h * d * J, d = 1 / (2 + sqrt(2)),
+     * factorized by Decomp. The Jacobian J is formed by forward differences, or by set_jacobian(), and reused
+     * until a step fails,
+     * W is factorized again only when J or the step size change, a small increase of the step is not taken
+     * to keep the factorization. A singular W rejects the step and halves it.
+     */
+    class Rosenbrock23 {
+    public:
+        using Function = int (*)(int n, double t, double y[], double yp[]);
+        /* sets jacobian = dF/dy and dfdt = dF/dt at (t, y) with yp = F(t, y), returns the number of calls of F */
+        using Jacobian = std::function<int(double t, const double y[], const double yp[], MatrixView jacobian,
+                                           double dfdt[])>;
+
+        /**
+         * \brief allocate the workspace once, it is reused by all later integrations
+         * \param neqn number of equations
+         */
+        explicit Rosenbrock23(int neqn);
+
+        /**
+         * \brief start a new problem, the next call of operator() initializes the integration
+         * \param rel_err relative error
+         * \param abs_err absolute error
+         * \param max_nfe maximum number of derivative evaluations, counted as in rkf45
+         * \param h starting step size, 0 to estimate it
+         */
+        void start(double rel_err, double abs_err, int max_nfe = 100000, double h = 0.0);
+
+        /**
+         * \brief integrate from t to tout, continues the integration of the previous call
+         * \param F user function evaluating derivatives yp of y at t
+         * \param y solution vector, of size neqn
+         * \param t independent variable, moved to the point reached
+         * \param tout output point
+         * \return 2 if tout was reached, 4 if more than max_nfe evaluations were needed,
+         * 6 if the requested accuracy could not be achieved with the smallest allowable step, or W stayed
+         * singular down to it
+         */
+        int operator()(Function F, double y[], double &t, double tout);
+
+        /**
+         * \brief Jacobian used instead of forward differences, an AutoJacobian or a ColoredJacobian is passed as it
+         * is (or by std::ref), an empty function goes back to forward differences
+         */
+        void set_jacobian(Jacobian jacobian);
+
+        [[nodiscard]] int getNeqn() const;
+        [[nodiscard]] int getFlag() const;
+        [[nodiscard]] int getNfe() const;
+        [[nodiscard]] int getSteps() const;
+        [[nodiscard]] int getRejected() const;
+        [[nodiscard]] int getJacobians() const;
+        [[nodiscard]] int getDecompositions() const;
+        [[nodiscard]] double getStep() const;
+
+        static void calculate(Function F,
+                              int NEQN,
+                              double Y[],
+                              double T,
+                              double TOUT);
+
+    private:
+        int neqn_;
+        double rel_err_;
+        double abs_err_;
+        int max_nfe_;
+        double h_;
+        double h_w_;
+        bool init_;
+        bool jacobian_fresh_;
+        bool decomp_valid_;
+        int flag_;
+        int nfe_;
+        int steps_;
+        int rejected_;
+        int jacobians_;
+        int decompositions_;
+        Jacobian user_jacobian_;
+        Matrix jacobian_;
+        Matrix w_;
+        Decomp decomp_;
+        Solve solve_;
+        std::vector<double> f0_;
+        std::vector<double> f1_;
+        std::vector<double> f2_;
+        std::vector<double> k1_;
+        std::vector<double> k2_;
+        std::vector<double> k3_;
+        std::vector<double> dfdt_;
+        std::vector<double> ynew_;
+        std::vector<double> rhs_;
+
+        void evaluate_jacobian(Function F, const double y[], double t);
+        /* W = I - h d J, false if it is singular to working precision */
+        bool factorize(double h);
+        void solve_w();
+    };
+}
+#endif
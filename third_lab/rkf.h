@@ -10,29 +10,37 @@
 #include <cstdio>
 #include <cmath>
 
+#include "../common/Statistics.h"
+
 #define  NULL  0LL
 #define  EPSILON  2.2e-16
 
 /*-----------------------------------------------------------------*/
 
-/* global definitions */
+/* workspace of one integration, see rkf45() */
 
-static double *F1, *F2, *F3, *F4, *F5, *SAVRE, *SAVAE;
-static int *KOP, *INIT, *JFLAG, *KFLAG;
+struct rkf_work {
+    double *F1, *F2, *F3, *F4, *F5;
+    double SAVRE, SAVAE;
+    int KOP, INIT, JFLAG, KFLAG;
+    int SHARED; /* F1..F5 belong to the caller, see rkfattach() */
+};
 
 /*-----------------------------------------------------------------*/
 
 
-void rkfinit(int NEQN, int *fail)
+void rkfinit(int NEQN, rkf_work *work, int *fail)
 
 /* Purpose...
    -------
    This routine allocates the work space and must be called
-   before using rkf45().
+   before using rkf45(). Every integration running at the same
+   time needs its own work space.
 
    Input ...
    -----
    NEQN  : Number of ODE's
+   work  : work space to be allocated
 
    Output ...
    ------
@@ -45,73 +53,102 @@ void rkfinit(int NEQN, int *fail)
 {
     *fail = 0;
 
+    work->SHARED = 0;
+    work->F1 = (double *) NULL;
+    work->F2 = (double *) NULL;
+    work->F3 = (double *) NULL;
+    work->F4 = (double *) NULL;
+    work->F5 = (double *) NULL;
+    work->SAVRE = 0.0;
+    work->SAVAE = 0.0;
+    work->KOP = 0;
+    work->INIT = 0;
+    work->JFLAG = 0;
+    work->KFLAG = 0;
+
     if (NEQN <= 0) {
         *fail = 2;
+        return;
     }
 
-    KOP = (int *) NULL;
-    INIT = (int *) NULL;
-    JFLAG = (int *) NULL;
-    KFLAG = (int *) NULL;
-    SAVRE = (double *) NULL;
-    SAVAE = (double *) NULL;
-    F1 = (double *) NULL;
-    F2 = (double *) NULL;
-    F3 = (double *) NULL;
-    F4 = (double *) NULL;
-    F5 = (double *) NULL;
-
-    KOP = (int *) malloc(sizeof(int));
-    if (KOP == NULL) {
+    work->F1 = (double *) malloc(NEQN * sizeof(double));
+    if (work->F1 == NULL) {
         *fail = 1;
     }
-    INIT = (int *) malloc(sizeof(int));
-    if (INIT == NULL) {
+    work->F2 = (double *) malloc(NEQN * sizeof(double));
+    if (work->F2 == NULL) {
         *fail = 1;
     }
-    JFLAG = (int *) malloc(sizeof(int));
-    if (JFLAG == NULL) {
+    work->F3 = (double *) malloc(NEQN * sizeof(double));
+    if (work->F3 == NULL) {
         *fail = 1;
     }
-    KFLAG = (int *) malloc(sizeof(int));
-    if (KFLAG == NULL) {
+    work->F4 = (double *) malloc(NEQN * sizeof(double));
+    if (work->F4 == NULL) {
         *fail = 1;
     }
-
-    SAVRE = (double *) malloc(sizeof(double));
-    if (SAVRE == NULL) {
-        *fail = 1;
-    }
-    SAVAE = (double *) malloc(sizeof(double));
-    if (SAVAE == NULL) {
+    work->F5 = (double *) malloc(NEQN * sizeof(double));
+    if (work->F5 == NULL) {
         *fail = 1;
     }
+} /* end of rkfinit() */
 
-    F1 = (double *) malloc(NEQN * sizeof(double));
-    if (F1 == NULL) {
-        *fail = 1;
-    }
-    F2 = (double *) malloc(NEQN * sizeof(double));
-    if (F2 == NULL) {
-        *fail = 1;
-    }
-    F3 = (double *) malloc(NEQN * sizeof(double));
-    if (F3 == NULL) {
-        *fail = 1;
-    }
-    F4 = (double *) malloc(NEQN * sizeof(double));
-    if (F4 == NULL) {
-        *fail = 1;
-    }
-    F5 = (double *) malloc(NEQN * sizeof(double));
-    if (F5 == NULL) {
-        *fail = 1;
+/*-----------------------------------------------------------------*/
+
+int rkfworkspace(int NEQN)
+
+/* Purpose...
+   -------
+   Number of elements of the buffer given to rkfattach().
+   */
+
+{
+    return 5 * NEQN;
+}
+
+/*-----------------------------------------------------------------*/
+
+void rkfattach(int NEQN, rkf_work *work, double buffer[], int *fail)
+
+/* Purpose...
+   -------
+   This routine sets up the work space like rkfinit() but in
+   memory of the caller, nothing is allocated. The buffer must
+   outlive the integration, rkfend() does not release it.
+
+   Input ...
+   -----
+   NEQN   : Number of ODE's
+   work   : work space to be set up
+   buffer : array of rkfworkspace(NEQN) elements
+
+   Output ...
+   ------
+   fail  : Status indicator
+           = 0 : successful set up of workspace
+           = 2 : illegal value for NEQN (i.e. < 1) or buffer == NULL
+   */
+
+{
+    int fail_init;
+
+    if (NEQN <= 0 || buffer == NULL) {
+        *fail = 2;
+        return;
     }
-} /* end of rkfinit() */
+    rkfinit(0, work, &fail_init);
+    *fail = 0;
+    work->SHARED = 1;
+    work->F1 = buffer;
+    work->F2 = buffer + NEQN;
+    work->F3 = buffer + 2 * NEQN;
+    work->F4 = buffer + 3 * NEQN;
+    work->F5 = buffer + 4 * NEQN;
+} /* end of rkfattach() */
 
 /*-----------------------------------------------------------------*/
 
-void rkfend(void)
+void rkfend(rkf_work *work)
 
 /* Purpose...
    -------
@@ -120,49 +157,30 @@ void rkfend(void)
    */
 
 {
-    if (F5 != NULL) {
-        free(F5);
-        F5 = NULL;
-    }
-    if (F4 != NULL) {
-        free(F4);
-        F4 = NULL;
-    }
-    if (F3 != NULL) {
-        free(F3);
-        F3 = NULL;
-    }
-    if (F2 != NULL) {
-        free(F2);
-        F2 = NULL;
-    }
-    if (F1 != NULL) {
-        free(F1);
-        F1 = NULL;
-    }
-    if (SAVAE != NULL) {
-        free(SAVAE);
-        SAVAE = NULL;
+    if (work->SHARED) {
+        work->F1 = work->F2 = work->F3 = work->F4 = work->F5 = NULL;
+        work->SHARED = 0;
+        return;
     }
-    if (SAVRE != NULL) {
-        free(SAVRE);
-        SAVRE = NULL;
+    if (work->F5 != NULL) {
+        free(work->F5);
+        work->F5 = NULL;
     }
-    if (KFLAG != NULL) {
-        free(KFLAG);
-        KFLAG = NULL;
+    if (work->F4 != NULL) {
+        free(work->F4);
+        work->F4 = NULL;
     }
-    if (JFLAG != NULL) {
-        free(JFLAG);
-        JFLAG = NULL;
+    if (work->F3 != NULL) {
+        free(work->F3);
+        work->F3 = NULL;
     }
-    if (INIT != NULL) {
-        free(INIT);
-        INIT = NULL;
+    if (work->F2 != NULL) {
+        free(work->F2);
+        work->F2 = NULL;
     }
-    if (KOP != NULL) {
-        free(KOP);
-        KOP = NULL;
+    if (work->F1 != NULL) {
+        free(work->F1);
+        work->F1 = NULL;
     }
 }
 
@@ -236,7 +254,8 @@ void rkf45(int (*F)(int n, double t, double y[], double yp[]), int NEQN,
            double *T, double TOUT,
            double *RELERR, double ABSERR,
            double *H,
-           int *NFE, int MAXNFE, int *IFLAG)
+           int *NFE, int MAXNFE, int *IFLAG,
+           rkf_work *work)
 
 
 /* Purpose ...
@@ -378,7 +397,8 @@ void rkf45(int (*F)(int n, double t, double y[], double yp[]), int NEQN,
    Workspace ...
    ---------
    The following arrays and simple variables are used internally
-   by rkf45() and should not be altered between calls.
+   by rkf45() and should not be altered between calls. Except YP[]
+   and H they are kept in *work, allocated by rkfinit().
 
    YP[],F1[], : array to hold information internal to rkf45() which
    F2[],F3[],   is necessary for subsequent calls.
@@ -437,12 +457,19 @@ void rkf45(int (*F)(int n, double t, double y[], double yp[]), int NEQN,
 #define   ISIGN(a,b)  (((b) > 0) ? abs(a) : -abs(a))
 #define   RSIGN(a,b)  (((b) > 0.0) ? fabs(a) : -fabs(a))
 
-    static int HFAILD, OUTPUT;
+    int HFAILD, OUTPUT;
 
-    static double A, AE, DT, EE, EEOET, ESTTOL, ET, HMIN, RER, S,
+    double A, AE, DT, EE, EEOET, ESTTOL, ET, HMIN, RER, S,
             SCALE, TOL, TOLN, U26, YPK;
 
-    static int K, MFLAG;
+    int K, MFLAG;
+
+    /* the state of this integration */
+    double *F1 = work->F1, *F2 = work->F2, *F3 = work->F3,
+            *F4 = work->F4, *F5 = work->F5;
+    double *SAVRE = &work->SAVRE, *SAVAE = &work->SAVAE;
+    int *KOP = &work->KOP, *INIT = &work->INIT,
+            *JFLAG = &work->JFLAG, *KFLAG = &work->KFLAG;
 
 
     /* REMIN is the minimum acceptable value of RELERR. Attempts
@@ -488,7 +515,7 @@ void rkf45(int (*F)(int n, double t, double y[], double yp[]), int NEQN,
                 case 3: *IFLAG = *JFLAG;
                     if (*KFLAG == 3) MFLAG = abs(*IFLAG);
                     break;
-                case 4: NFE = 0;
+                case 4: *NFE = 0;
                     *IFLAG = *JFLAG;
                     if (*KFLAG == 3) MFLAG = abs(*IFLAG);
                     break;
@@ -549,6 +576,7 @@ void rkf45(int (*F)(int n, double t, double y[], double yp[]), int NEQN,
         A = *T;
         (*F)(NEQN, A, Y, YP);
         *NFE = 1;
+        NUMERICS_COUNT(RHS_CALLS, 1);
         if (*T == TOUT) {
             *IFLAG = 2;
             return;
@@ -592,6 +620,7 @@ void rkf45(int (*F)(int n, double t, double y[], double yp[]), int NEQN,
         A = TOUT;
         (*F)(NEQN, A, Y, YP);
         ++(*NFE);
+        NUMERICS_COUNT(RHS_CALLS, 1);
         *T = TOUT;
         *IFLAG = 2;
         return;
@@ -670,6 +699,7 @@ TakeAStep:
     /* Advance an approximate solution over one step of length H  */
     fehl45(F, *T, *H, Y, YP, F1, F2, F3, F4, F5, NEQN);
     *NFE += 5;
+    NUMERICS_COUNT(RHS_CALLS, 5);
 
     /* Compute and test allowable tolerances versus local error estimates
        and remove scaling of tolerances. Note that relative error is
@@ -694,6 +724,7 @@ TakeAStep:
         /* --- Unsuccessful step ---
             reduce the stepsize , try again
             the decrease is limited to a factor of 1/10  */
+        NUMERICS_COUNT(REJECTED_STEPS, 1);
         HFAILD = 1; /* .TRUE.  */
         OUTPUT = 0; /* .FALSE. */
         S = 0.1;
@@ -718,6 +749,8 @@ TakeAStep:
     A = *T;
     (*F)(NEQN, A, Y, YP);
     ++(*NFE);
+    NUMERICS_COUNT(RHS_CALLS, 1);
+    NUMERICS_COUNT(ACCEPTED_STEPS, 1);
 
 
     /* --- Choose next stepsize. ---